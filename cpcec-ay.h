@@ -187,40 +187,74 @@ void psg_reset(void) // reset the PSG AY-3-8910
 
 // audio output ----------------------------------------------------- //
 
+// the output of the PSG only changes when a counter runs out, and most counters tick many times before they do;
+// rather than stepping them one tick at a time, psg_main() finds how many ticks remain till the next edge that can
+// be heard, adds the constant output of the whole span at once to the averages of the samples that it covers (each
+// sample still averages the very same ticks, so every edge keeps its exact place within its sample) and then winds
+// the counters forward. Counters whose edges can't be heard (muted channels, noise that no channel mixes, held
+// envelopes, ultrasounds) are allowed to run out inside the spans, and they're wound forward with arithmetic too.
+
+int psg_wind(int *n,int l,int t) // wind counter `*n` with limit `l` forward `t` steps; returns how many times it ran out
+{
+	int c=*n>0?*n:1; if (t<c) return *n-=t,0; // the first time happens after `c` steps...
+	int p=l>0?l:1,z=(t-c)/p+1; return *n=l-(t-c)+(z-1)*p,z; // ...and then once every `p` steps
+}
+int psg_hard_wind(int l,int z) // the level of the hard envelope after `z` steps from level `l`
+	{ return (l+=z)<32?l:(psg_hard_style&1)?16+(l-32)%16:(l-32)%32; } // stop or loop!
+
+// the state of psg_main() beyond the registers: tick remainder, output averages, noise generator and update phases
+int psg_main_r=0,psg_main_n=0,psg_main_b=0;
+#if !AUDIO_ALWAYS_MONO
+int psg_main_o0=0,psg_main_o1=0;
+#else
+int psg_main_o=0;
+#endif
+unsigned int psg_main_smash=0,psg_main_crash=1; char psg_main_q=0;
+#if PSG_MAIN_EXTRABITS
+int psg_main_a=1;
+#endif
+
 void psg_main(int t,int d) // render audio output for `t` clock ticks, with `d` as a 16-bit base signal
 {
-	static int r=0; // audio clock is slower, so remainder is kept here
-	if (audio_pos_z>=AUDIO_LENGTH_Z||(r+=t<<PSG_MAIN_EXTRABITS)<0) return; // nothing to do!
+	if (audio_pos_z>=AUDIO_LENGTH_Z||(psg_main_r+=t<<PSG_MAIN_EXTRABITS)<0) return; // nothing to do!
 	#if !AUDIO_ALWAYS_MONO
 	d=-d<<8; // flip DAC sign!
 	#else
 	d=-d; // flip DAC sign!
 	#endif
+	#if !PSG_MAIN_EXTRABITS
+	const int psg_main_a=1; // the generators update on every tick
+	#endif
 	do
 	{
-		static unsigned int smash=0,crash=1;
-		#if !AUDIO_ALWAYS_MONO
-		static int n=0,o0=0,o1=0; // output averages
-		#else
-		static int n=0,o=0; // output average
-		#endif
-		#if PSG_MAIN_EXTRABITS
-		static int a=1; if (!--a)
-		#endif
+		int u=1<<28,v=1<<28,k,m=0; // updates and noise+envelope updates till the next edge that can be heard
+		for (int c=0;c<3;++c)
+			if (psg_tone_power[c])
+			{
+				m|=~psg_tone_mixer[c]&8; if (psg_tone_power[c]&16) m|=16; // is the channel noisy? does it use the hard envelope?
+				if (!(psg_tone_mixer[c]&1)&&(psg_tone_limit[c]>PSG_ULTRASOUND||psg_tone_state[c]!=psg_ultra_beep))
+					if (u>(k=psg_tone_count[c]-1)) u=k>0?k:0;
+			}
+		if (m&8) v=psg_noise_count>1?psg_noise_count-1:0;
+		if (m&16) // the hard envelope can only be skipped when it's stuck on a level
+		{
+			if (psg_outputs[16]!=psg_outputs[psg_envelope[(BYTE)psg_hard_style][(BYTE)psg_hard_level]]) v=0;
+			else if (!(psg_hard_style&1)||psg_hard_level<16) if (v>(k=psg_hard_count-1)) v=k>0?k:0;
+		}
+		if (u>(k=v*2+!!psg_main_q)) u=k; // noise and envelope update at half the rate
+		int e=psg_main_r/PSG_TICK_STEP; if ((k=psg_main_a-1+(u<<PSG_MAIN_EXTRABITS))>e) k=e+1; // ticks till the edge, up to the remainder
+		if (!k) // an edge on this very tick: update everything
 		{
 			#if PSG_MAIN_EXTRABITS
-			a=1<<PSG_MAIN_EXTRABITS;
+			psg_main_a=1<<PSG_MAIN_EXTRABITS;
 			#endif
-			static char q=0; if (q=~q) // update noise, at half the rate
+			if (psg_main_q=~psg_main_q) // update noise and hard envelope, at half the rate
 			{
 				if (--psg_noise_count<=0)
 				{
 					psg_noise_count=psg_noise_limit;
-					smash=crash&1; crash<<=1; crash+=(((crash>>23)^(crash>>18))&1); // 23-bit LFSR randomizer
+					psg_main_smash=psg_main_crash&1; psg_main_crash<<=1; psg_main_crash+=(((psg_main_crash>>23)^(psg_main_crash>>18))&1); // 23-bit LFSR randomizer
 				}
-			//}
-			//else // update hard envelope, at half the rate
-			//{
 				psg_outputs[16]=psg_outputs[psg_envelope[psg_hard_style][psg_hard_level]];
 				if (--psg_hard_count<=0)
 				{
@@ -232,60 +266,109 @@ void psg_main(int t,int d) // render audio output for `t` clock ticks, with `d`
 			for (int c=0;c<3;++c)
 				if (--psg_tone_count[c]<=0) // update channel; ultrasound/beeper filter
 					psg_tone_state[c]=(psg_tone_count[c]=psg_tone_limit[c])<=PSG_ULTRASOUND?psg_ultra_beep:~psg_tone_state[c];
+			u=k=1; // the span is this single tick
 		}
+		else u=0; // the span must be wound forward later
+		#if !AUDIO_ALWAYS_MONO
+		int m0=d,m1=d; // the output stays the same during the whole span
+		#else
+		m=d; // the output stays the same during the whole span
+		#endif
 		for (int c=0;c<3;++c)
 			if ((psg_tone_mixer[c]&1)|psg_tone_state[c]) // is the channel active?
-				if ((psg_tone_mixer[c]&8)|smash) // is the channel noisy?
+				if ((psg_tone_mixer[c]&8)|psg_main_smash) // is the channel noisy?
 		#if !AUDIO_ALWAYS_MONO
 				{
 					int o=psg_outputs[psg_tone_power[c]];
-					o0+=o*psg_stereo[c][0],
-					o1+=o*psg_stereo[c][1];
+					m0+=o*psg_stereo[c][0],
+					m1+=o*psg_stereo[c][1];
 				}
-		o0+=d,
-		o1+=d;
 		#else
-				o+=psg_outputs[psg_tone_power[c]];
-		o+=d;
+				m+=psg_outputs[psg_tone_power[c]];
 		#endif
-		++n;
-		static int b=0; if ((b-=(AUDIO_PLAYBACK*PSG_TICK_STEP)>>PSG_MAIN_EXTRABITS)<=0)
+		int i=k,j; do
 		{
-			b+=TICKS_PER_SECOND;
-			#if AUDIO_CHANNELS > 1
+			static const int bb=(AUDIO_PLAYBACK*PSG_TICK_STEP)>>PSG_MAIN_EXTRABITS;
+			if ((j=psg_main_b>0?(psg_main_b-1)/bb+1:1)>i) j=i; // ticks till the next sample, up to the end of the span
 			#if !AUDIO_ALWAYS_MONO
-			int dd=n<<(24-AUDIO_BITDEPTH),qq;
-			*audio_target++=(qq=o0/dd)+AUDIO_ZERO,o0-=qq*dd, // rounded average (left)
-			*audio_target++=(qq=o1/dd)+AUDIO_ZERO,o1-=qq*dd; // rounded average (right)
+			psg_main_o0+=m0*j,psg_main_o1+=m1*j;
 			#else
-			int dd=n<<(16-AUDIO_BITDEPTH),qq;
-			*audio_target++=(qq=o/dd)+AUDIO_ZERO, // rounded average (left)
-			*audio_target++=qq+AUDIO_ZERO,o-=qq*dd; // rounded average (right)
+			psg_main_o+=m*j;
 			#endif
-			#else
-			int dd=n<<(16-AUDIO_BITDEPTH),qq;
-			*audio_target++=(qq=o /dd)+AUDIO_ZERO,o -=qq*dd; // rounded average
+			psg_main_n+=j,i-=j,psg_main_r-=j*PSG_TICK_STEP;
+			if ((psg_main_b-=bb*j)<=0)
+			{
+				psg_main_b+=TICKS_PER_SECOND;
+				#if AUDIO_CHANNELS > 1
+				#if !AUDIO_ALWAYS_MONO
+				int dd=psg_main_n<<(24-AUDIO_BITDEPTH),qq;
+				*audio_target++=(qq=psg_main_o0/dd)+AUDIO_ZERO,psg_main_o0-=qq*dd, // rounded average (left)
+				*audio_target++=(qq=psg_main_o1/dd)+AUDIO_ZERO,psg_main_o1-=qq*dd; // rounded average (right)
+				#else
+				int dd=psg_main_n<<(16-AUDIO_BITDEPTH),qq;
+				*audio_target++=(qq=psg_main_o/dd)+AUDIO_ZERO, // rounded average (left)
+				*audio_target++=qq+AUDIO_ZERO,psg_main_o-=qq*dd; // rounded average (right)
+				#endif
+				#else
+				int dd=psg_main_n<<(16-AUDIO_BITDEPTH),qq;
+				*audio_target++=(qq=psg_main_o /dd)+AUDIO_ZERO,psg_main_o -=qq*dd; // rounded average
+				#endif
+				if (psg_main_n=0,++audio_pos_z>=AUDIO_LENGTH_Z) { psg_main_r=(psg_main_r+PSG_TICK_STEP)%PSG_TICK_STEP-PSG_TICK_STEP; break; } // end of buffer!
+			}
+		}
+		while (i);
+		if (!u&&(k-=i)) // wind the generators forward to the end of the span
+		{
+			if (k>=psg_main_a) // did the span include any updates?
+			{
+				u=((k-psg_main_a)>>PSG_MAIN_EXTRABITS)+1;
+				for (int c=0;c<3;++c)
+					if (j=psg_wind(&psg_tone_count[c],psg_tone_limit[c],u))
+						psg_tone_state[c]=psg_tone_limit[c]<=PSG_ULTRASOUND?psg_ultra_beep:j&1?~psg_tone_state[c]:psg_tone_state[c];
+				if (v=(u+!psg_main_q)>>1) // noise and envelope update at half the rate
+				{
+					for (j=psg_wind(&psg_noise_count,psg_noise_limit,v);j;--j)
+						psg_main_smash=psg_main_crash&1,psg_main_crash<<=1,psg_main_crash+=(((psg_main_crash>>23)^(psg_main_crash>>18))&1); // 23-bit LFSR randomizer
+					j=psg_wind(&psg_hard_count,psg_hard_limit,v); m=psg_hard_level;
+					psg_hard_level=psg_hard_wind(m,j); // the output follows the level of the last update
+					psg_outputs[16]=psg_outputs[psg_envelope[(BYTE)psg_hard_style][j&&psg_hard_count==psg_hard_limit?psg_hard_wind(m,j-1):psg_hard_level]];
+				}
+				if (u&1) psg_main_q=~psg_main_q;
+			}
+			#if PSG_MAIN_EXTRABITS
+			psg_main_a+=(u<<PSG_MAIN_EXTRABITS)-k; // `u` is zero if there were no updates
 			#endif
-			if (n=0,++audio_pos_z>=AUDIO_LENGTH_Z) r%=PSG_TICK_STEP; // end of buffer!
 		}
 	}
-	while ((r-=PSG_TICK_STEP)>=0);
+	while (psg_main_r>=0);
 }
 
 // Again, the PlayCity extension requires its own logic, as it "piggybacks" on top of the central AY chip;
 // notice how there are several differences in the timing (configurable), the mixing and the streamlining.
 
 #ifdef PSG_PLAYCITY
+// the state of playcity_main() beyond the registers: counters, generators, output averages and clock phases
+int playcity_tone_count[PSG_PLAYCITY][3],playcity_tone_state[PSG_PLAYCITY][3],playcity_noise_count[PSG_PLAYCITY],playcity_hard_power[PSG_PLAYCITY];
+#if PSG_PLAYCITY == 1
+unsigned int playcity_smash[PSG_PLAYCITY]={0},playcity_crash[PSG_PLAYCITY]={1};
+#else
+unsigned int playcity_smash[PSG_PLAYCITY]={0,0},playcity_crash[PSG_PLAYCITY]={1,1};
+#endif
+int playcity_main_n=0,playcity_main_p=0;
+#if !AUDIO_ALWAYS_MONO
+int playcity_main_o0=0,playcity_main_o1=0;
+#else
+int playcity_main_o=0;
+#endif
+char playcity_main_q=0;
+
 void playcity_main(AUDIO_UNIT *t,int l)
 {
 	int playcity_tone_limit[PSG_PLAYCITY][3],playcity_tone_power[PSG_PLAYCITY][3],playcity_tone_mixer[PSG_PLAYCITY][3],playcity_noise_limit[PSG_PLAYCITY],playcity_hard_limit[PSG_PLAYCITY];
-	static int playcity_tone_count[PSG_PLAYCITY][3],playcity_noise_count[PSG_PLAYCITY],playcity_hard_power[PSG_PLAYCITY];
 	#if PSG_PLAYCITY == 1
-	static int playcity_tone_state[PSG_PLAYCITY][3]={{0,0,0}}; static unsigned int smash[PSG_PLAYCITY]={0},crash[PSG_PLAYCITY]={1};
 	if (playcity_table[0][7]==0XFF||l<=0) return; // nothing to do? quit!
 	const int x=0;
 	#else
-	static int playcity_tone_state[PSG_PLAYCITY][3]={{0,0,0},{0,0,0}}; static unsigned int smash[PSG_PLAYCITY]={0,0},crash[PSG_PLAYCITY]={1,1};
 	int dirty_l=playcity_table[0][7]==0XFF,dirty_h=playcity_table[1][7]!=0XFF;
 	if (dirty_l>dirty_h||l<=0) return; // disabled chips? no buffer? quit!
 	for (int x=dirty_l;x<=dirty_h;++x)
@@ -303,33 +386,26 @@ void playcity_main(AUDIO_UNIT *t,int l)
 		if (!(playcity_hard_limit[x]=playcity_table[x][11]+playcity_table[x][12]*256)) // hard envelope limits
 			playcity_hard_limit[x]=1;
 	}
-	#if !AUDIO_ALWAYS_MONO
-	static int n=0,o0=0,o1=0; // output averages
-	#else
-	static int n=0,o=0; // output average
-	#endif
 	for (;;)
 	{
 		const int hiclk=playcity_hiclock,loclk=playcity_loclock; // redundant in systems where these values are constant
-		static int p=0; p+=hiclk; while (p>=0)
+		playcity_main_p+=hiclk; while (playcity_main_p>=0)
 		{
-			#if PSG_PLAYCITY == 1
-			static char q=0; // see below
-			#else
-			static char q=0; q=~q; // toggle once for ALL chips!
+			#if PSG_PLAYCITY > 1
+			playcity_main_q=~playcity_main_q; // toggle once for ALL chips!
 			for (int x=dirty_l;x<=dirty_h;++x) // update all chips
 			#endif
 			{
 				#if PSG_PLAYCITY == 1
-				if (q=~q) // update noises, half the rate
+				if (playcity_main_q=~playcity_main_q) // update noises, half the rate
 				#else
-				if (q) // see above
+				if (playcity_main_q) // see above
 				#endif
 				{
 					if (--playcity_noise_count[x]<=0)
 					{
 						playcity_noise_count[x]=playcity_noise_limit[x];
-						smash[x]=crash[x]&1; crash[x]<<=1; crash[x]+=(((crash[x]>>23)^(crash[x]>>18))&1); // 23-bit LFSR
+						playcity_smash[x]=playcity_crash[x]&1; playcity_crash[x]<<=1; playcity_crash[x]+=(((playcity_crash[x]>>23)^(playcity_crash[x]>>18))&1); // 23-bit LFSR
 					}
 				//}
 				//else // update hard envelopes, half the rate
@@ -348,41 +424,41 @@ void playcity_main(AUDIO_UNIT *t,int l)
 						playcity_tone_count[x][c]=playcity_tone_limit[x][c],
 						playcity_tone_state[x][c]=~playcity_tone_state[x][c];
 					if (playcity_tone_state[x][c]|(playcity_tone_mixer[x][c]&1)) // active channel?
-						if (smash[x]|(playcity_tone_mixer[x][c]&8)) // noisy channel?
+						if (playcity_smash[x]|(playcity_tone_mixer[x][c]&8)) // noisy channel?
 						{
 							int z=playcity_tone_power[x][c];
 							if (z&16)
 								z=playcity_hard_power[x];
 							#if !AUDIO_ALWAYS_MONO
 							int o=PSG_PLAYCITY_XLAT(z);
-							o0+=o*playcity_stereo[x][c][0],
-							o1+=o*playcity_stereo[x][c][1];
+							playcity_main_o0+=o*playcity_stereo[x][c][0],
+							playcity_main_o1+=o*playcity_stereo[x][c][1];
 							#else
-							o+=PSG_PLAYCITY_XLAT(z);
+							playcity_main_o+=PSG_PLAYCITY_XLAT(z);
 							#endif
 						}
 				}
 			}
-			++n; p-=loclk;
+			++playcity_main_n; playcity_main_p-=loclk;
 		}
 		// generate negative samples (-50% x2) to avoid overflows against the central AY chip (+100%)
-		if (n) // enough data to write a sample? unlike the basic PSG, `n` is >1 at 44100 Hz (5 or 6)
+		if (playcity_main_n) // enough data to write a sample? unlike the basic PSG, `n` is >1 at 44100 Hz (5 or 6)
 		{
 			#if AUDIO_CHANNELS > 1
 			#if !AUDIO_ALWAYS_MONO
-			int dd=n<<(24-AUDIO_BITDEPTH),qq;
-			*t++-=qq=o0/dd,o0-=qq*dd, // rounded average (left)
-			*t++-=qq=o1/dd,o1-=qq*dd; // rounded average (right)
+			int dd=playcity_main_n<<(24-AUDIO_BITDEPTH),qq;
+			*t++-=qq=playcity_main_o0/dd,playcity_main_o0-=qq*dd, // rounded average (left)
+			*t++-=qq=playcity_main_o1/dd,playcity_main_o1-=qq*dd; // rounded average (right)
 			#else
-			int dd=n<<(16-AUDIO_BITDEPTH),qq;
-			*t++-=qq=o/dd, // rounded average (left)
-			*t++-=qq,o-=qq*dd; // rounded average (right)
+			int dd=playcity_main_n<<(16-AUDIO_BITDEPTH),qq;
+			*t++-=qq=playcity_main_o/dd, // rounded average (left)
+			*t++-=qq,playcity_main_o-=qq*dd; // rounded average (right)
 			#endif
 			#else
-			int dd=n<<(16-AUDIO_BITDEPTH),qq;
-			*t++-=qq=o /dd,o -=qq*dd; // rounded average
+			int dd=playcity_main_n<<(16-AUDIO_BITDEPTH),qq;
+			*t++-=qq=playcity_main_o /dd,playcity_main_o -=qq*dd; // rounded average
 			#endif
-			if (n=0,!--l) break;
+			if (playcity_main_n=0,!--l) break;
 		}
 	}
 }
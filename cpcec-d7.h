@@ -26,6 +26,15 @@ BYTE disc_index_table[4][256]; // "MV - CPC" disc header - one for each drive
 BYTE disc_track_table[8][512]; // current track info - one for each drive AND side, because one SEEK TRACK enables access to BOTH sides of said track!
 int disc_track_offset[8]; // current tracks' file offsets - one for each drive (drives A..D: 0..3) and side (side A +0, side B +4)
 
+// the whole disc lives in memory while it's in the drive: seeking a track or a sector is a matter of looking up
+// the offsets that were calculated in advance; every write goes thru to the file at once, so it stays up to date.
+
+BYTE *disc_image[4]={NULL,NULL,NULL,NULL},disc_image_dirty[4]; // disc contents, and whether the file failed to keep up with them
+int disc_image_size[4]; // length of the disc contents in bytes
+int disc_track_index[4][256]; // offsets of all the tracks of each drive, sorted as (track*sides)+side
+int disc_sector_index[8][64]; // offsets of all the sectors of the current tracks, relative to their own tracks
+int disc_cursor; // the offset set by the last disc_sector_seek()
+
 // each drive can hold a disc and point at a track, but the FDC is limited to one operation at once,
 // so parameters, buffers, pointers, counters, etc. are unique for the whole system.
 
@@ -42,7 +51,7 @@ BYTE disc_status;
 BYTE disc_phase; // notice that no commmand takes all stages, and some commands don't perform any actions.
 BYTE disc_trueunit,disc_trueunithead; // current unit+head after flipping sides (if feasible)
 int disc_delay; // several operations need a short delay between command and action.
-int disc_timer; // overrun timer: if nonzero, it decreases.
+int disc_timer,disc_timer_r=0; // overrun timer: if nonzero, it decreases; remainder of the last decrease.
 int disc_overrun; // set if disc_timer dropped to zero!
 
 // disc file handling operations ------------------------------------ //
@@ -54,13 +63,53 @@ void disc_track_reset(int drive) // invalidate drive `d` tracks on both sides
 	MEMZERO(disc_track_table[drive]); MEMZERO(disc_track_table[drive+4]);
 }
 
-void disc_close(int drive) // close disc file. drive = 0 (A:) or 1 (B:)
+int disc_image_read(int d,BYTE *t,int o,int l) // copy `l` bytes from offset `o` of the disc in drive `d` into `t`; returns the bytes copied
+{
+	if (o<0||o>=disc_image_size[d]) return 0;
+	if (l>disc_image_size[d]-o) l=disc_image_size[d]-o;
+	return memcpy(t,&disc_image[d][o],l),l;
+}
+int disc_image_write(int d,BYTE *s,int o,int l) // copy `l` bytes from `s` into offset `o` of the disc in drive `d` and its file; returns the bytes copied, <0 ERROR
+{
+	if (o<0||o>=disc_image_size[d]) return 0;
+	if (l>disc_image_size[d]-o) l=disc_image_size[d]-o;
+	memcpy(&disc_image[d][o],s,l);
+	if (fseek(disc[d],o,SEEK_SET)||fwrite1(&disc_image[d][o],l,disc[d])!=l||fflush(disc[d]))
+		return disc_image_dirty[d]=1,-1; // the file failed: try again when the disc leaves the drive
+	return l;
+}
+int disc_image_flush(int d) // write the whole disc in drive `d` to its file, f.e. after its size changed; 0 OK, !0 ERROR
 {
-	if (disc[drive])
-		disc_track_reset(drive),puff_fclose(disc[drive]);
-	disc_change[drive]=1,disc[drive]=NULL;
+	if (fseek(disc[d],0,SEEK_SET)||fwrite1(disc_image[d],disc_image_size[d],disc[d])!=disc_image_size[d]||fflush(disc[d])||!fsetsize(disc[d],disc_image_size[d]))
+		return disc_image_dirty[d]=1;
+	return disc_image_dirty[d]=0;
+}
+int disc_track_size(int d,int j) // get the length in bytes of track `j` (i.e. track*sides+side) of the disc in drive `d`
+{
+	if (disc_index_table[d][0]=='M') // old style: all tracks are the same size, in bytes
+		return disc_index_table[d][0x32]+disc_index_table[d][0x33]*256;
+	return j+0x34<256?disc_index_table[d][j+0x34]*256:0; // new style: each track stores its own size, in 256-byte pages
+}
+void disc_track_setup(int d) // calculate the offsets of all tracks of the disc in drive `d`
+{
+	for (int i=256,j=0;j<256;++j) // the disc header must be skipped
+		disc_track_index[d][j]=i,i+=disc_track_size(d,j);
 }
-#define disc_closeall() (disc_close(0),disc_close(1))
+
+int disc_close(int drive) // close disc file. drive = 0 (A:) or 1 (B:); 0 OK, !0 ERROR (the last changes were lost)
+{
+	int q=0; if (disc[drive])
+	{
+		if (disc_image_dirty[drive]) // did a write fail? try once more
+			q=disc_image_flush(drive);
+		disc_track_reset(drive); if (puff_fclose(disc[drive])) q=1;
+	}
+	if (disc_image[drive])
+		free(disc_image[drive]),disc_image[drive]=NULL;
+	disc_change[drive]=1,disc[drive]=NULL,disc_image_size[drive]=disc_image_dirty[drive]=0;
+	return q;
+}
+#define disc_closeall() (disc_close(0)|disc_close(1))
 
 int disc_open(char *s,int d,int canwrite) // open a disc file. `s` path, `d` = 0 (A:) or 1 (B:); 0 OK, !0 ERROR
 {
@@ -69,14 +118,18 @@ int disc_open(char *s,int d,int canwrite) // open a disc file. `s` path, `d` = 0
 		if (disc_canwrite[d]=0,!(disc[d]=puff_fopen(s,"rb"))) // fall back to "rb" if "rb+" is unfeasible!
 			return 1; // cannot open disc!
 	int q=1; // error flag
-	if (fread(disc_index_table[d],1,256,disc[d])==256
-		&&disc_index_table[d][0x30]<110&&disc_index_table[d][0x31]>0&&disc_index_table[d][0x31]<3
-		&&(!memcmp("MV - CPC",disc_index_table[d],8)||!memcmp("EXTENDED",disc_index_table[d],8)))
-			q=0; // ID and fields are valid
+	fseek(disc[d],0,SEEK_END); int l=ftell(disc[d]); fseek(disc[d],0,SEEK_SET);
+	if (l>=256&&(disc_image[d]=malloc(l))&&fread1(disc_image[d],l,disc[d])==l) // load the whole disc at once
+	{
+		memcpy(disc_index_table[d],disc_image[d],256); disc_image_size[d]=l;
+		if (disc_index_table[d][0x30]<110&&disc_index_table[d][0x31]>0&&disc_index_table[d][0x31]<3
+			&&(!memcmp("MV - CPC",disc_index_table[d],8)||!memcmp("EXTENDED",disc_index_table[d],8)))
+				q=0; // ID and fields are valid
+	}
 	disc_track_reset(d);
 	if (q)
 		disc_close(d); // unknown disc format!
-	else STRCOPY(disc_path,s); // valid format
+	else disc_track_setup(d),STRCOPY(disc_path,s); // valid format
 	return q;
 }
 
@@ -141,43 +194,31 @@ int disc_sector_size(int d,int j) // get size of sector `j` (0: first, 1: second
 
 // tracks are unique to each disc and are divided in two halves ("sides") that operate at the same time.
 
+void disc_sector_setup(int d) // calculate the offsets of all sectors of the current track at drive+side `d`
+{
+	for (int i=disc_track_table[d][0x15]>29?512:256,j=0;j<64;++j) // track header must be skipped
+		disc_sector_index[d][j]=i,i+=j<disc_track_table[d][0x15]&&j<61?disc_sector_size(d,j):0; // 61 sectors fill the 512-byte header
+}
 int disc_track_load(int d,int c) // setup track `c` from drive `d`; 0 OK, !0 ERROR
 {
 	disc_track_reset(d);
 	disc_track_table[d][0]=1; // track may be empty, but we checked it
 	if (!disc[d]||c<0||c>=disc_index_table[d][0x30]) // fail if no disc or invalid track
 		return 1;
-	int i=256; // disc header must be skipped
-	int j=c*disc_index_table[d][0x31],k;
-	if (disc_index_table[d][0]=='M') // old style
-		i+=j*(k=(disc_index_table[d][0x32]+disc_index_table[d][0x33]*256)); // all tracks are the same size, in bytes
-	else // new style
+	int i,j,k;
+	for (k=d,j=c*disc_index_table[d][0x31];k<8;k+=4,++j) // the first side, then the second one if the disc has two sides
 	{
-		k=disc_index_table[d][j+0x34];
-		while (j--)
-			i+=disc_index_table[d][j+0x34]*256; // each track stores its own size, in 256-byte pages
-	}
-	fseek(disc[d],disc_track_offset[d]=i,SEEK_SET);
-	if (k>1) // tracks without a body are equivalent to empty tracks!
-		fread1(disc_track_table[d],512,disc[d]); // tracks with >29 sectors use 512 bytes rather than just the first 256 bytes
-	if (disc_index_table[d][0x31]>1) // is it a two-sided disc?
-	{
-		if (disc_index_table[d][0]=='M') // old style
-			i+=k; // ditto
-		else // new style
-		{
-			k=disc_index_table[d][c*disc_index_table[d][0x31]+1+0x34];
-			i+=disc_index_table[d][c*disc_index_table[d][0x31]+0x34]*256; // ditto
-		}
-		fseek(disc[d],disc_track_offset[d+4]=i,SEEK_SET);
-		if (k>1)
-			fread1(disc_track_table[d+4],512,disc[d]);
+		disc_track_offset[k]=disc_track_index[d][j];
+		if (disc_track_size(d,j)>1) // tracks without a body are equivalent to empty tracks!
+			disc_image_read(d,disc_track_table[k],disc_track_offset[k],512); // tracks with >29 sectors use 512 bytes rather than just the first 256 bytes
+		if (disc_index_table[d][0x31]<2) break; // is it a one-sided disc?
 	}
 	if (disc_index_table[d][0]=='M') // old style discs lack the explicit size field and thus require calculation
 		for (k=d;k<8;k+=4) // check both sides
 			if ((i=128<<disc_track_table[k][0x14])<(128<<7)) // sector size is defined in the track header
 				for (j=0;j<disc_track_table[k][0x15];++j)
 					disc_track_table[k][j*8+0x1E]=i,disc_track_table[k][j*8+0x1F]=i>>8;
+	disc_sector_setup(d),disc_sector_setup(d+4);
 	//cprintf("(%08X:%08X %d:%d) ",disc_track_offset[d],disc_track_offset[d+4],disc_track_table[d][0x15],disc_track_table[d+4][0x15]);
 	return 0;
 }
@@ -214,9 +255,7 @@ int disc_skew_length,disc_skew_filler; // required when READ SECTOR with N > phy
 void disc_sector_seek(int d,int z) // seek sector `z` (usually `disc_sector_last`) in current track at unit+side `d`; 0 OK, !0 ERROR
 {
 	disc_offset=0; // reset buffer
-	int i=disc_track_table[d][0x15]>29?512:256,j; // track header must be skipped
-	for (j=0;j<z;++j)
-		i+=disc_sector_size(d,j);
+	int i=disc_sector_index[d][z>0?z&63:0],j=z; // see disc_sector_setup()
 	disc_length=128<<(disc_track_table[d][j*8+0x1B]&15); // sector size is defined by the sector's own N, but value isn't always reliable; see below.
 	if ((disc_lengthfull=disc_sector_size(d,j))>sizeof(disc_buffer))
 		disc_lengthfull=sizeof(disc_buffer);
@@ -243,8 +282,8 @@ void disc_sector_seek(int d,int z) // seek sector `z` (usually `disc_sector_last
 			disc_lengthfull=disc_length; // set sector size
 		}
 	}
-	fseek(disc[d&3],disc_track_offset[d]+i,SEEK_SET);
-	cprintf("<%08X:%04X> ",disc_track_offset[d]+i,disc_length);
+	disc_cursor=disc_track_offset[d]+i;
+	cprintf("<%08X:%04X> ",disc_cursor,disc_length);
 }
 
 #define DISC_RESULT_LAST_CHRN() memcpy(&disc_result[3],&disc_parmtr[2],4)
@@ -294,7 +333,7 @@ void disc_sector_loadgaps(void) // used by READ TRACK
 	if (disc_sector_last>=disc_track_table[disc_trueunithead][0x15])
 		disc_sector_last=0; // wrap to first sector in track
 	disc_sector_seek(disc_trueunithead,disc_sector_last);
-	fread1(disc_buffer,disc_lengthfull,disc[disc_trueunit]); // normal case
+	disc_image_read(disc_trueunit,disc_buffer,disc_cursor,disc_lengthfull); // normal case
 	// UBI SOFT's discs need padding, but Batman the Movie (Spectrum +3) rejects it (?): parameter 2 is nonzero when padding must be skipped (!)
 	if (disc_length==disc_lengthfull&&!disc_parmtr[2]) // pad the length with inter-sector bytes?
 	{
@@ -350,7 +389,7 @@ void disc_sector_load(void) // read a sector and set the status flags accordingl
 					disc_parmtr[6]=disc_parmtr[4];
 				disc_sector_seek(disc_trueunithead,disc_sector_last);
 				cprintf("[RD %04X] ",disc_length);
-				fread1(disc_buffer,disc_length,disc[disc_trueunit]);
+				disc_image_read(disc_trueunit,disc_buffer,disc_cursor,disc_length);
 				disc_delay=1,disc_phase=3;
 				disc_timer=DISC_TIMER_INIT*disc_sector_timer;
 			}
@@ -359,19 +398,18 @@ void disc_sector_load(void) // read a sector and set the status flags accordingl
 	while (disc_length<0); // repeat until either success or failure!
 }
 
-// formatting a track requires rearranging the whole disc both on file and on memory
-// 1.- prepare a backup of the data after the current track
-// 2.- modify the disc header to include the new track size
+// formatting a track requires rearranging the whole disc in memory
+// 1.- modify the disc header to include the new track size
+// 2.- build a new disc with the data before the current track
 // 3.- store the new track in place of the current track
-// 4.- dump the backup after the current track
-// 5.- discard the backup
+// 4.- append the data after the current track
+// 5.- discard the old disc and recalculate the track offsets
 // difficult enough? if the disc is old style we also have to convert it to new style on the fly!
-// 1.- prepare a backup of the data after the current track
-// 2.- turn the disc header into "EXTENDED" while including the new track size
-// 3.- modify all the tracks before the current one to fit the new style
-// 4.- store the new track in place of the current track
-// 5.- dump the backup after the current track while modifying the tracks into new style
-// 6.- discard the backup
+// 1.- turn the disc header into "EXTENDED" while including the new track size
+// 2.- build a new disc with the data before the current track, modifying the tracks to fit the new style
+// 3.- store the new track in place of the current track
+// 4.- append the data after the current track while modifying the tracks into new style
+// 5.- discard the old disc and recalculate the track offsets
 void disc_track_format_old2new(BYTE *t) // converts a single track from MV - CPC (old) to EXTENDED (new) style; `t` is the header
 {
 	int i,j;
@@ -435,53 +473,50 @@ void disc_track_format(void)
 		}
 	}
 
-	int new_offset=256,old_offset=0,old_length=0;
+	int new_offset=256,old_offset=0,old_length=0,new_length;
 	for (i=0;i<j;++i)
 		new_offset+=disc_index_table[disc_trueunit][0x34+i]<<8;
 	old_offset=new_offset+(q<<8);
-	if (q-=disc_index_table[disc_trueunit][j+0x34]||m) // will the file size change? did the style change? backup if required!
-		while (++i<disc_index_table[disc_trueunit][0x30]*disc_index_table[disc_trueunit][0x31])
-			old_length+=disc_index_table[disc_trueunit][0x34+i]<<8;
+	while (++i<disc_index_table[disc_trueunit][0x30]*disc_index_table[disc_trueunit][0x31])
+		old_length+=disc_index_table[disc_trueunit][0x34+i]<<8;
+	new_length=new_offset+(disc_index_table[disc_trueunit][j+0x34]<<8)+old_length;
 
-	char *disc_backup=NULL;
-	if (old_length)
+	BYTE *t=malloc(new_length);
+	if (!t) // no room for the new disc? undo the header changes and give up!
 	{
-		disc_backup=malloc(old_length);
-		fseek(disc[disc_trueunit],old_offset,SEEK_SET);
-		fread1(disc_backup,old_length,disc[disc_trueunit]);
+		memcpy(disc_index_table[disc_trueunit],disc_image[disc_trueunit],256);
+		disc_track_load(disc_trueunit,disc_track[disc_trueunit]);
+		disc_result[0]=0x40|(disc_parmtr[1]&7); // 0x40: Command Aborted
+		disc_result[1]=0x02; // 0x02: Not Writeable
+		DISC_RESULT_LAST_CHRN();
+		disc_length=7;
+		disc_phase=4;
+		return;
 	}
-	fseek(disc[disc_trueunit],0,SEEK_SET);
-	fwrite1(disc_index_table[disc_trueunit],256,disc[disc_trueunit]);
-	if (m)
-		for (i=0;i<j;++i)
-		{
-			fread1(disc_scratch,256,disc[disc_trueunit]); // load the header
-			fseek(disc[disc_trueunit],-256,SEEK_CUR); // rewind
-			disc_track_format_old2new(disc_scratch); // update header
-			fwrite1(disc_scratch,256,disc[disc_trueunit]); // save the header
-			fseek(disc[disc_trueunit],(disc_index_table[disc_trueunit][0x34+i]-1)<<8,SEEK_CUR); // next track
-		}
-	else
-		fseek(disc[disc_trueunit],new_offset,SEEK_SET);
+	memset(t,0,new_length); // the parts that the old disc lacked, if any, stay empty
+	memcpy(t,disc_index_table[disc_trueunit],256);
+	disc_image_read(disc_trueunit,&t[256],256,new_offset-256);
+	memset(disc_buffer,disc_parmtr[5],sizeof(disc_buffer)); // filler!
 	if (l128)
 	{
-		fwrite1(disc_track_table[disc_trueunithead],256,disc[disc_trueunit]);
-		memset(disc_buffer,disc_parmtr[5],sizeof(disc_buffer)); // filler!
-		fwrite1(disc_buffer,((l128+1)/2)<<8,disc[disc_trueunit]);
-	}
-	if (old_length)
-	{
-		if (m)
-			for (i=j,m=0;++i<disc_index_table[disc_trueunit][0x30]*disc_index_table[disc_trueunit][0x31];)
-			{
-				disc_track_format_old2new(&disc_backup[m]); // update header
-				m+=disc_index_table[disc_trueunit][0x34+i]<<8; // next track
-			}
-		fwrite1(disc_backup,old_length,disc[disc_trueunit]);
-		free(disc_backup);
+		memcpy(&t[new_offset],disc_track_table[disc_trueunithead],256);
+		memcpy(&t[new_offset+256],disc_buffer,((l128+1)/2)<<8);
 	}
-	if (q) // did the file size change? truncate!
-		fsetsize(disc[disc_trueunit],new_offset+(disc_index_table[disc_trueunit][j+0x34]<<8)+old_length);
+	disc_image_read(disc_trueunit,&t[new_length-old_length],old_offset,old_length);
+	if (m) // update the headers of all the other tracks
+		for (i=0,m=256;i<disc_index_table[disc_trueunit][0x30]*disc_index_table[disc_trueunit][0x31];++i)
+		{
+			if (i!=j&&m+256<=new_length) disc_track_format_old2new(&t[m]); // update header
+			m+=disc_index_table[disc_trueunit][0x34+i]<<8; // next track
+		}
+	free(disc_image[disc_trueunit]); disc_image[disc_trueunit]=t;
+	disc_image_size[disc_trueunit]=new_length;
+	if (disc_image_flush(disc_trueunit)) // the whole file changes; if it fails, the software must know
+		disc_result[1]|=0x02; // 0x02: Not Writeable
+	disc_track_setup(disc_trueunit); // the offsets of the following tracks may have changed
+	for (i=disc_track[disc_trueunit]*disc_index_table[disc_trueunit][0x31],j=disc_trueunit;j<8;j+=4,++i)
+		if (disc_track_offset[j]=disc_track_index[disc_trueunit][i],disc_index_table[disc_trueunit][0x31]<2) break;
+	disc_sector_setup(disc_trueunithead);
 
 	// and it's done!
 	disc_exitstate();
@@ -762,14 +797,14 @@ void disc_data_send(BYTE b) // DATA I/O
 						cprintf("[WR %04X] ",disc_length);
 						if (disc_canwrite[disc_trueunit])
 						{
-							fwrite(disc_buffer,1,disc_length,disc[disc_trueunit]); // warning: this silently fails if the file mode is "rb" instead of "rb+"
+							if (disc_image_write(disc_trueunit,disc_buffer,disc_cursor,disc_length)<0)
+								disc_result[1]|=0x02; // 0x02: Not Writeable // the file failed
 							// WRITE DATA (05) and WRITE DELETED DATA (09) reset and set the DELETED flag: is the track header in need of an update?
 							if ((((disc_parmtr[0]&8)<<3)^disc_track_table[disc_trueunithead][disc_sector_last*8+0x1D])&64)
 							{
 								disc_track_table[disc_trueunithead][disc_sector_last*8+0x1D]^=64;
-								fseek(disc[disc_trueunit],disc_track_offset[disc_trueunithead],SEEK_SET);
-								// warning: this silently fails if the file mode is "rb" instead of "rb+" (again!)
-								fwrite(disc_track_table[disc_trueunithead],1,disc_track_table[disc_trueunithead][0x15]>29?512:256,disc[disc_trueunit]);
+								if (disc_image_write(disc_trueunit,disc_track_table[disc_trueunithead],disc_track_offset[disc_trueunithead],disc_track_table[disc_trueunithead][0x15]>29?512:256)<0)
+									disc_result[1]|=0x02; // 0x02: Not Writeable // ditto
 							}
 						}
 						else if (!(disc_filemode&2))
@@ -908,10 +943,9 @@ INLINE void disc_main(int t) // handle disc drives for `t` clock ticks
 	int i; // overrun timeouts can happen during WRITING and READING stages!
 	if ((disc_phase&2)&&!(disc_parmtr[0]==0x46&&(i=disc_parmtr[4])==disc_parmtr[6]&&i==disc_parmtr[7]&&i==disc_parmtr[8])) // kludge: the second condition helps 5KB DEMO 3 and ORION PRIME work
 	{
-		static int r=0;
 		//cprintf("%d ",t);
-		t=(t*DISC_PER_FRAME)+r;
-		r=t%TICKS_PER_FRAME;
+		t=(t*DISC_PER_FRAME)+disc_timer_r;
+		disc_timer_r=t%TICKS_PER_FRAME;
 		disc_timer-=t/TICKS_PER_FRAME;
 		while (disc_timer<=0)
 		{
@@ -169,6 +169,19 @@ WORD debug_dasm_any(char *t,WORD p,BYTE q(WORD)) // where `BYTE q(WORD)` is a fu
 
 #define m65xx_close() ((void)0)
 
+// define M65XX_GOTO to dispatch the opcodes through a table of labels rather
+// than a `switch`, like Z80_GOTO does; every M65XX_MAIN gets its own table.
+#if defined(M65XX_GOTO)&&(!defined(__GNUC__)||defined(__TINYC__))
+#undef M65XX_GOTO // TCC and the others stick to the `switch`
+#endif
+#ifdef M65XX_GOTO
+#define M65XX_LABEL(x) m65xx_op_##x:
+#define M65XX_GOTO16(x) &&m65xx_op_##x##0,&&m65xx_op_##x##1,&&m65xx_op_##x##2,&&m65xx_op_##x##3,&&m65xx_op_##x##4,&&m65xx_op_##x##5,&&m65xx_op_##x##6,&&m65xx_op_##x##7, \
+	&&m65xx_op_##x##8,&&m65xx_op_##x##9,&&m65xx_op_##x##A,&&m65xx_op_##x##B,&&m65xx_op_##x##C,&&m65xx_op_##x##D,&&m65xx_op_##x##E,&&m65xx_op_##x##F
+#else
+#define M65XX_LABEL(x)
+#endif
+
 #define M65XX_MERGE_P (M65XX_P=(z?48:50)+(n&128)+(M65XX_P&77)) // 77 = 64+8+4+1, i.e. the flags V+D+I+C
 #define M65XX_BREAK_P (M65XX_P=(z?32:34)+(n&128)+(M65XX_P&77)) // used by the IRQ/NMI handler to reset flag B
 #define M65XX_SPLIT_P (z=~M65XX_P&2,n=M65XX_P) // `z` and `n` are the latest relevant zero-value and sign-value
@@ -281,6 +294,11 @@ void M65XX_RESET(void) // resets the M65XX chip; notice that the start address i
 void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks; notice that _t_<1 runs exactly one operation
 {
 	int m65xx_t=0; M65XX_LOCAL;
+	#ifdef M65XX_GOTO
+	static const void *const m65xx_goto[256]={ M65XX_GOTO16(0),M65XX_GOTO16(1),M65XX_GOTO16(2),M65XX_GOTO16(3),
+		M65XX_GOTO16(4),M65XX_GOTO16(5),M65XX_GOTO16(6),M65XX_GOTO16(7),M65XX_GOTO16(8),M65XX_GOTO16(9),
+		M65XX_GOTO16(A),M65XX_GOTO16(B),M65XX_GOTO16(C),M65XX_GOTO16(D),M65XX_GOTO16(E),M65XX_GOTO16(F) };
+	#endif
 	#ifdef M65XX_REU
 	if (reu_size)
 		do
@@ -328,11 +346,15 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 			#ifdef M65XX_HLT
 			if (M65XX_HLT) M65XX_WAIT;
 			#endif
-			BYTE q,o=M65XX_PEEK(M65XX_PC.w); ++M65XX_PC.w; switch (o)
+			BYTE q,o=M65XX_PEEK(M65XX_PC.w); ++M65XX_PC.w;
+			#ifdef M65XX_GOTO
+			goto *m65xx_goto[o]; // straight into the right `case`, `break` still leaves the `switch`
+			#endif
+			switch (o)
 			{
 				int i; HLII a;
 				// opcodes N*8+0 ---------------------------- //
-				case 0X00: // BRK #$NN
+				case 0X00: M65XX_LABEL(00) // BRK #$NN
 					#ifdef M65XX_TRAP_0X00
 					M65XX_TRAP_0X00;
 					#endif
@@ -359,7 +381,7 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_WAIT;
 					M65XX_TOCK; M65XX_WAIT;
 					break;
-				case 0X20: // JSR $NNNN
+				case 0X20: M65XX_LABEL(20) // JSR $NNNN
 					#ifdef M65XX_TRAP_0X20
 					M65XX_TRAP_0X20;
 					#endif
@@ -369,7 +391,7 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TICK; M65XX_PUSH(M65XX_S,M65XX_PC.b.l); --M65XX_S;
 					M65XX_TOCK; M65XX_WAIT; M65XX_PAGE(M65XX_PC.b.h); M65XX_PC.b.h=M65XX_PEEK(M65XX_PC.w); M65XX_PC.b.l=o; // don't use M65XX_FETCH here!
 					break;
-				case 0X40: // RTI
+				case 0X40: M65XX_LABEL(40) // RTI
 					#ifdef M65XX_TRAP_0X40
 					M65XX_TRAP_0X40;
 					#endif
@@ -382,7 +404,7 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 						{ _t_=0,session_signal|=SESSION_SIGNAL_DEBUG; } // throw!
 					#endif
 					break;
-				case 0X60: // RTS
+				case 0X60: M65XX_LABEL(60) // RTS
 					#ifdef M65XX_TRAP_0X60
 					M65XX_TRAP_0X60;
 					#endif
@@ -396,67 +418,67 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 						{ _t_=0,session_signal|=SESSION_SIGNAL_DEBUG; } // throw!
 					#endif
 					break;
-				case 0XA0: // LDY #$NN
+				case 0XA0: M65XX_LABEL(A0) // LDY #$NN
 					M65XX_TOCK; M65XX_FETCH(M65XX_Y); z=n=M65XX_Y;
 					break;
-				case 0XC0: // CPY #$NN
+				case 0XC0: M65XX_LABEL(C0) // CPY #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_CPY(o);
 					break;
-				case 0XE0: // CPX #$NN
+				case 0XE0: M65XX_LABEL(E0) // CPX #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_CPX(o);
 					break;
-				case 0X08: // PHP
+				case 0X08: M65XX_LABEL(08) // PHP
 					M65XX_BADPC;
 					M65XX_TOCK; M65XX_TICK; M65XX_MERGE_P; M65XX_PUSH(M65XX_S,M65XX_P); --M65XX_S;
 					break;
-				case 0X28: // PLP
+				case 0X28: M65XX_LABEL(28) // PLP
 					M65XX_BADPC; M65XX_OLDPC; // both dumb reads aim to PC+1!
 					M65XX_TOCK; M65XX_WAIT; ++M65XX_S; M65XX_P=M65XX_PULL(M65XX_S); M65XX_SPLIT_P;
 					break;
-				case 0X48: // PHA
+				case 0X48: M65XX_LABEL(48) // PHA
 					M65XX_BADPC;
 					M65XX_TOCK; M65XX_TICK; M65XX_PUSH(M65XX_S,M65XX_A); --M65XX_S;
 					break;
-				case 0X68: // PLA
+				case 0X68: M65XX_LABEL(68) // PLA
 					M65XX_BADPC; M65XX_OLDPC; // both dumb reads aim to PC+1!
 					M65XX_TOCK; M65XX_WAIT; ++M65XX_S; z=n=M65XX_A=M65XX_PULL(M65XX_S);
 					break;
-				case 0X88: // DEY
+				case 0X88: M65XX_LABEL(88) // DEY
 					z=n=--M65XX_Y; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XA8: // TAY
+				case 0XA8: M65XX_LABEL(A8) // TAY
 					z=n=M65XX_Y=M65XX_A; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XC8: // INY
+				case 0XC8: M65XX_LABEL(C8) // INY
 					z=n=++M65XX_Y; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XE8: // INX
+				case 0XE8: M65XX_LABEL(E8) // INX
 					z=n=++M65XX_X; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XB0: // BCS $RRRR
+				case 0XB0: M65XX_LABEL(B0) // BCS $RRRR
 					#ifdef M65XX_TRAP_0XB0
 					M65XX_TRAP_0XB0;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (M65XX_P&1) goto go_to_branch;
 					break;
-				case 0X90: // BCC $RRRR
+				case 0X90: M65XX_LABEL(90) // BCC $RRRR
 					#ifdef M65XX_TRAP_0X90
 					M65XX_TRAP_0X90;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (!(M65XX_P&1)) goto go_to_branch;
 					break;
-				case 0XF0: // BEQ $RRRR
+				case 0XF0: M65XX_LABEL(F0) // BEQ $RRRR
 					#ifdef M65XX_TRAP_0XF0
 					M65XX_TRAP_0XF0;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (!z) goto go_to_branch;
 					break;
-				case 0XD0: // BNE $RRRR
+				case 0XD0: M65XX_LABEL(D0) // BNE $RRRR
 					#ifdef M65XX_TRAP_0XD0
 					M65XX_TRAP_0XD0;
 					#endif
@@ -469,41 +491,41 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 						/*break;*/ // redundant!
 					}
 					break;
-				case 0X70: // BVS $RRRR
+				case 0X70: M65XX_LABEL(70) // BVS $RRRR
 					#ifdef M65XX_TRAP_0X70 // likewise! (the original C1541 ROM does not use this tho')
 					M65XX_TRAP_0X70;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (M65XX_P&64) goto go_to_branch;
 					break;
-				case 0X50: // BVC $RRRR
+				case 0X50: M65XX_LABEL(50) // BVC $RRRR
 					#ifdef M65XX_TRAP_0X50 // special case: the C1541 relies on the M6502 OVERFLOW pin!
 					M65XX_TRAP_0X50;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (!(M65XX_P&64)) goto go_to_branch;
 					break;
-				case 0X30: // BMI $RRRR
+				case 0X30: M65XX_LABEL(30) // BMI $RRRR
 					#ifdef M65XX_TRAP_0X30
 					M65XX_TRAP_0X30;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (n&128) goto go_to_branch;
 					break;
-				case 0X10: // BPL $RRRR
+				case 0X10: M65XX_LABEL(10) // BPL $RRRR
 					#ifdef M65XX_TRAP_0X10
 					M65XX_TRAP_0X10;
 					#endif
 					M65XX_TOCK; M65XX_FETCH(o);
 					if (!(n&128)) goto go_to_branch;
 					break;
-				case 0X18: // CLC
+				case 0X18: M65XX_LABEL(18) // CLC
 					M65XX_P&=~1; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X38: // SEC
+				case 0X38: M65XX_LABEL(38) // SEC
 					M65XX_P|=+1; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X58: // CLI
+				case 0X58: M65XX_LABEL(58) // CLI
 					#ifdef M65XX_TRAP_0X58
 					M65XX_TRAP_0X58;
 					#endif
@@ -511,180 +533,180 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					if ((M65XX_PEEK(M65XX_PC.w)!=0X78)/*&&(M65XX_P&4)*/) M65XX_INT=0; // IRQ delay: "RIMRUNNER" ($85DE) but not "4KRAWALL" ($8230)
 					M65XX_P&=~4;
 					break;
-				case 0X78: // SEI
+				case 0X78: M65XX_LABEL(78) // SEI
 					#ifdef M65XX_TRAP_0X78
 					M65XX_TRAP_0X78;
 					#endif
 					M65XX_TOCK; M65XX_BADPC; // does any title rely on delaying the next NMI check!?
 					M65XX_P|=+4;
 					break;
-				case 0X98: // TYA
+				case 0X98: M65XX_LABEL(98) // TYA
 					z=n=M65XX_A=M65XX_Y; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XB8: // CLV
+				case 0XB8: M65XX_LABEL(B8) // CLV
 					M65XX_P&=~64; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XD8: // CLD
+				case 0XD8: M65XX_LABEL(D8) // CLD
 					M65XX_P&=~8; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XF8: // SED
+				case 0XF8: M65XX_LABEL(F8) // SED
 					M65XX_P|=+8; M65XX_TOCK; M65XX_BADPC;
 					break;
 				// opcodes N*8+1 ---------------------------- //
-				case 0X01: // ORA ($NN,X)
+				case 0X01: M65XX_LABEL(01) // ORA ($NN,X)
 					M65XX_IND_X; goto go_to_ora_peek;
-				case 0X09: // ORA #$NN
+				case 0X09: M65XX_LABEL(09) // ORA #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_ORA(o);
 					break;
-				case 0X11: // ORA ($NN),Y
+				case 0X11: M65XX_LABEL(11) // ORA ($NN),Y
 					M65XX_IND_Y; goto go_to_ora_peek;
-				case 0X19: // ORA $NNNN,Y
+				case 0X19: M65XX_LABEL(19) // ORA $NNNN,Y
 					M65XX_ABS_Y; goto go_to_ora_peek;
-				case 0X21: // AND ($NN,X)
+				case 0X21: M65XX_LABEL(21) // AND ($NN,X)
 					M65XX_IND_X; goto go_to_and_peek;
-				case 0X29: // AND #$NN
+				case 0X29: M65XX_LABEL(29) // AND #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_AND(o);
 					break;
-				case 0X31: // AND ($NN),Y
+				case 0X31: M65XX_LABEL(31) // AND ($NN),Y
 					M65XX_IND_Y; goto go_to_and_peek;
-				case 0X39: // AND $NNNN,Y
+				case 0X39: M65XX_LABEL(39) // AND $NNNN,Y
 					M65XX_ABS_Y; goto go_to_and_peek;
-				case 0X41: // EOR ($NN,X)
+				case 0X41: M65XX_LABEL(41) // EOR ($NN,X)
 					M65XX_IND_X; goto go_to_eor_peek;
-				case 0X49: // EOR #$NN
+				case 0X49: M65XX_LABEL(49) // EOR #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_EOR(o);
 					break;
-				case 0X51: // EOR ($NN),Y
+				case 0X51: M65XX_LABEL(51) // EOR ($NN),Y
 					M65XX_IND_Y; goto go_to_eor_peek;
-				case 0X59: // EOR $NNNN,Y
+				case 0X59: M65XX_LABEL(59) // EOR $NNNN,Y
 					M65XX_ABS_Y; goto go_to_eor_peek;
-				case 0X61: // ADC ($NN,X)
+				case 0X61: M65XX_LABEL(61) // ADC ($NN,X)
 					M65XX_IND_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_ADC(M65XX_PEEK(a.w));
 					break;
-				case 0X69: // ADC #$NN
+				case 0X69: M65XX_LABEL(69) // ADC #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_ADC(o);
 					break;
-				case 0X71: // ADC ($NN),Y
+				case 0X71: M65XX_LABEL(71) // ADC ($NN),Y
 					M65XX_IND_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_ADC(M65XX_PEEK(a.w));
 					break;
-				case 0X79: // ADC $NNNN,Y
+				case 0X79: M65XX_LABEL(79) // ADC $NNNN,Y
 					M65XX_ABS_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_ADC(M65XX_PEEK(a.w));
 					break;
-				case 0X81: // STA ($NN,X)
+				case 0X81: M65XX_LABEL(81) // STA ($NN,X)
 					M65XX_IND_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_A);
 					break;
-				case 0X91: // STA ($NN),Y
+				case 0X91: M65XX_LABEL(91) // STA ($NN),Y
 					M65XX_IND_Y_BADAW; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_A);
 					break;
-				case 0X99: // STA $NNNN,Y
+				case 0X99: M65XX_LABEL(99) // STA $NNNN,Y
 					M65XX_ABS_Y_BADAW; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_A);
 					break;
-				case 0XA1: // LDA ($NN,X)
+				case 0XA1: M65XX_LABEL(A1) // LDA ($NN,X)
 					M65XX_IND_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_PEEK(a.w);
 					break;
-				case 0XA9: // LDA #$NN
+				case 0XA9: M65XX_LABEL(A9) // LDA #$NN
 					M65XX_TOCK; M65XX_FETCH(M65XX_A); z=n=M65XX_A;
 					break;
-				case 0XB1: // LDA ($NN),Y
+				case 0XB1: M65XX_LABEL(B1) // LDA ($NN),Y
 					M65XX_IND_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_PEEK(a.w);
 					break;
-				case 0XB9: // LDA $NNNN,Y
+				case 0XB9: M65XX_LABEL(B9) // LDA $NNNN,Y
 					M65XX_ABS_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_PEEK(a.w);
 					break;
-				case 0XC1: // CMP ($NN,X)
+				case 0XC1: M65XX_LABEL(C1) // CMP ($NN,X)
 					M65XX_IND_X; goto go_to_cmp_peek;
-				case 0XC9: // CMP #$NN
+				case 0XC9: M65XX_LABEL(C9) // CMP #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_CMP(o);
 					break;
-				case 0XD1: // CMP ($NN),Y
+				case 0XD1: M65XX_LABEL(D1) // CMP ($NN),Y
 					M65XX_IND_Y; goto go_to_cmp_peek;
-				case 0XD9: // CMP $NNNN,Y
+				case 0XD9: M65XX_LABEL(D9) // CMP $NNNN,Y
 					M65XX_ABS_Y; goto go_to_cmp_peek;
-				case 0XE1: // SBC ($NN,X)
+				case 0XE1: M65XX_LABEL(E1) // SBC ($NN,X)
 					M65XX_IND_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_SBC(M65XX_PEEK(a.w));
 					break;
-				case 0XE9: // SBC #$NN
-				case 0XEB: // SBC #$NN (illegal!)
+				case 0XE9: M65XX_LABEL(E9) // SBC #$NN
+				case 0XEB: M65XX_LABEL(EB) // SBC #$NN (illegal!)
 					M65XX_TOCK; M65XX_FETCH(o);
 					M65XX_SBC(o);
 					break;
-				case 0XF1: // SBC ($NN),Y
+				case 0XF1: M65XX_LABEL(F1) // SBC ($NN),Y
 					M65XX_IND_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_SBC(M65XX_PEEK(a.w));
 					break;
-				case 0XF9: // SBC $NNNN,Y
+				case 0XF9: M65XX_LABEL(F9) // SBC $NNNN,Y
 					M65XX_ABS_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_SBC(M65XX_PEEK(a.w));
 					break;
 				// opcodes N*8+2 ---------------------------- //
-				case 0X0A: // ASL A
+				case 0X0A: M65XX_LABEL(0A) // ASL A
 					M65XX_ASL(M65XX_A,M65XX_A); M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X2A: // ROL A
+				case 0X2A: M65XX_LABEL(2A) // ROL A
 					M65XX_ROL(M65XX_A,M65XX_A); M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X4A: // LSR A
+				case 0X4A: M65XX_LABEL(4A) // LSR A
 					M65XX_LSR(M65XX_A,M65XX_A); M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X6A: // ROR A
+				case 0X6A: M65XX_LABEL(6A) // ROR A
 					M65XX_ROR(M65XX_A,M65XX_A); M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X8A: // TXA
+				case 0X8A: M65XX_LABEL(8A) // TXA
 					z=n=M65XX_A=M65XX_X; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X9A: // TXS
+				case 0X9A: M65XX_LABEL(9A) // TXS
 					M65XX_S=M65XX_X; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XA2: // LDX #$NN
+				case 0XA2: M65XX_LABEL(A2) // LDX #$NN
 					M65XX_TOCK; M65XX_FETCH(M65XX_X); z=n=M65XX_X;
 					break;
-				case 0XAA: // TAX
+				case 0XAA: M65XX_LABEL(AA) // TAX
 					z=n=M65XX_X=M65XX_A; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XBA: // TSX
+				case 0XBA: M65XX_LABEL(BA) // TSX
 					z=n=M65XX_X=M65XX_S; M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0XCA: // DEX
+				case 0XCA: M65XX_LABEL(CA) // DEX
 					z=n=--M65XX_X; M65XX_TOCK; M65XX_BADPC;
 					break;
 				// opcodes N*8+3 ---------------------------- //
-				case 0X03: // SLO ($NN,X)
+				case 0X03: M65XX_LABEL(03) // SLO ($NN,X)
 					M65XX_IND_X; goto go_to_slo_poke;
-				case 0X0B: // ANC #$NN
-				case 0X2B: // ANC #$NN
+				case 0X0B: M65XX_LABEL(0B) // ANC #$NN
+				case 0X2B: M65XX_LABEL(2B) // ANC #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					z=n=M65XX_A&=o; M65XX_P=(M65XX_P&~1)+(z>>7);
 					break;
-				case 0X13: // SLO ($NN),Y
+				case 0X13: M65XX_LABEL(13) // SLO ($NN),Y
 					M65XX_IND_Y_BADAW; goto go_to_slo_poke;
-				case 0X1B: // SLO $NNNN,Y
+				case 0X1B: M65XX_LABEL(1B) // SLO $NNNN,Y
 					M65XX_ABS_Y_BADAW; goto go_to_slo_poke;
-				case 0X23: // RLA ($NN,X)
+				case 0X23: M65XX_LABEL(23) // RLA ($NN,X)
 					M65XX_IND_X; goto go_to_rla_poke;
-				case 0X33: // RLA ($NN),Y
+				case 0X33: M65XX_LABEL(33) // RLA ($NN),Y
 					M65XX_IND_Y_BADAW; goto go_to_rla_poke;
-				case 0X3B: // RLA $NNNN,Y
+				case 0X3B: M65XX_LABEL(3B) // RLA $NNNN,Y
 					M65XX_ABS_Y_BADAW; goto go_to_rla_poke;
-				case 0X4B: // ASR #$NN // a.k.a. ALR
+				case 0X4B: M65XX_LABEL(4B) // ASR #$NN // a.k.a. ALR
 					M65XX_TOCK; M65XX_FETCH(o);
 					o&=M65XX_A; M65XX_P=(M65XX_P&~1)+(o&1); z=n=M65XX_A=o>>1;
 					break;
-				case 0X6B: // ARR #$NN
+				case 0X6B: M65XX_LABEL(6B) // ARR #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					o&=M65XX_A; z=n=M65XX_A=(o>>1)+(M65XX_P<<7);
 					if (UNLIKELY(M65XX_P&8))
@@ -698,74 +720,74 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					else
 						M65XX_P=(M65XX_P&~65)+(o>>7)+((o^(o>>1))&64);
 					break;
-				case 0X8B: // ANE #$NN
+				case 0X8B: M65XX_LABEL(8B) // ANE #$NN
 					// "...Mastertronic variant of the 'burner' tape loader ([...] 'Spectipede', 'BMX Racer') [...]
 					// the commonly assumed value $EE for the 'magic constant' will not work, but $EF does..." (Groepaz/Solution)
 					M65XX_TOCK; M65XX_FETCH(o);
 					z=n=M65XX_A=(M65XX_A|(M65XX_XEF))&M65XX_X&o;
 					break;
-				case 0X43: // SRE ($NN,X)
+				case 0X43: M65XX_LABEL(43) // SRE ($NN,X)
 					M65XX_IND_X; goto go_to_sre_poke;
-				case 0X53: // SRE ($NN),Y
+				case 0X53: M65XX_LABEL(53) // SRE ($NN),Y
 					M65XX_IND_Y_BADAW; goto go_to_sre_poke;
-				case 0X5B: // SRE $NNNN,Y
+				case 0X5B: M65XX_LABEL(5B) // SRE $NNNN,Y
 					M65XX_ABS_Y_BADAW; goto go_to_sre_poke;
-				case 0X63: // RRA ($NN,X)
+				case 0X63: M65XX_LABEL(63) // RRA ($NN,X)
 					M65XX_IND_X; goto go_to_rra_poke;
-				case 0X73: // RRA ($NN),Y
+				case 0X73: M65XX_LABEL(73) // RRA ($NN),Y
 					M65XX_IND_Y_BADAW; goto go_to_rra_poke;
-				case 0X7B: // RRA $NNNN,Y
+				case 0X7B: M65XX_LABEL(7B) // RRA $NNNN,Y
 					M65XX_ABS_Y_BADAW; goto go_to_rra_poke;
-				case 0X83: // SAX ($NN,X)
+				case 0X83: M65XX_LABEL(83) // SAX ($NN,X)
 					M65XX_IND_X; goto go_to_sax_poke;
-				case 0X93: // SHA ($NN),Y
+				case 0X93: M65XX_LABEL(93) // SHA ($NN),Y
 					M65XX_IND_Y_SHZAW; goto go_to_sha_poke;
-				case 0X9B: // SHS $NNNN,Y
+				case 0X9B: M65XX_LABEL(9B) // SHS $NNNN,Y
 					M65XX_ABS_Y_SHZAW;
 					M65XX_TOCK; M65XX_TICK; M65XX_SHZ(q,M65XX_S=M65XX_SAX); // TICK must happen before SHZ!
 					M65XX_PAGE(a.b.h); M65XX_POKE(a.w,q);
 					break;
-				case 0XA3: // LAX ($NN,X)
+				case 0XA3: M65XX_LABEL(A3) // LAX ($NN,X)
 					M65XX_IND_X; goto go_to_lax_peek;
-				case 0XAB: // LXA #$NN
+				case 0XAB: M65XX_LABEL(AB) // LXA #$NN
 					// "...a very popular C-64 game, 'Wizball', actually uses the LAX #imm opcode [...]
 					// $EE really seems to be the one and only value to make it work correctly..." (Groepaz/Solution)
 					M65XX_TOCK; M65XX_FETCH(o);
 					z=n=M65XX_A=M65XX_X=(M65XX_A|(M65XX_XEE))&o;
 					break;
-				case 0XB3: // LAX ($NN),Y
+				case 0XB3: M65XX_LABEL(B3) // LAX ($NN),Y
 					M65XX_IND_Y; goto go_to_lax_peek;
-				case 0XBB: // LAS $NNNN,Y
+				case 0XBB: M65XX_LABEL(BB) // LAS $NNNN,Y
 					M65XX_ABS_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_X=M65XX_S&=M65XX_PEEK(a.w);
 					break;
-				case 0XCB: // SBX #$NN
+				case 0XCB: M65XX_LABEL(CB) // SBX #$NN
 					M65XX_TOCK; M65XX_FETCH(o);
 					z=n=M65XX_X=i=M65XX_SAX-o;
 					M65XX_CARRY(i>=0);
 					break;
-				case 0XC3: // DCP ($NN,X)
+				case 0XC3: M65XX_LABEL(C3) // DCP ($NN,X)
 					M65XX_IND_X; goto go_to_dcp_poke;
-				case 0XD3: // DCP ($NN),Y
+				case 0XD3: M65XX_LABEL(D3) // DCP ($NN),Y
 					M65XX_IND_Y_BADAW; goto go_to_dcp_poke;
-				case 0XDB: // DCP $NNNN,Y
+				case 0XDB: M65XX_LABEL(DB) // DCP $NNNN,Y
 					M65XX_ABS_Y_BADAW; goto go_to_dcp_poke;
-				case 0XE3: // ISB ($NN,X)
+				case 0XE3: M65XX_LABEL(E3) // ISB ($NN,X)
 					M65XX_IND_X; goto go_to_isb_poke;
-				case 0XF3: // ISB ($NN),Y
+				case 0XF3: M65XX_LABEL(F3) // ISB ($NN),Y
 					M65XX_IND_Y_BADAW; goto go_to_isb_poke;
-				case 0XFB: // ISB $NNNN,Y
+				case 0XFB: M65XX_LABEL(FB) // ISB $NNNN,Y
 					M65XX_ABS_Y_BADAW; goto go_to_isb_poke;
 				// opcodes N*8+4 ---------------------------- //
-				case 0X24: // BIT $NN
+				case 0X24: M65XX_LABEL(24) // BIT $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; M65XX_BIT(M65XX_PEEKZERO(a.w));
 					break;
-				case 0X2C: // BIT $NNNN
+				case 0X2C: M65XX_LABEL(2C) // BIT $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_BIT(M65XX_PEEK(a.w));
 					break;
-				case 0X4C: // JMP $NNNN
+				case 0X4C: M65XX_LABEL(4C) // JMP $NNNN
 					#ifdef M65XX_TRAP_0X4C
 					M65XX_TRAP_0X4C;
 					#endif
@@ -773,7 +795,7 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_WAIT; M65XX_PAGE(M65XX_PC.b.h); M65XX_PC.b.h=M65XX_PEEK(M65XX_PC.w);
 					M65XX_PC.b.l=o;
 					break;
-				case 0X6C: // JMP ($NNNN)
+				case 0X6C: M65XX_LABEL(6C) // JMP ($NNNN)
 					#ifdef M65XX_TRAP_0X6C
 					M65XX_TRAP_0X6C;
 					#endif
@@ -781,189 +803,189 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_PC.b.l=M65XX_PEEK(a.w); ++a.b.l; // not `++a.w`!
 					M65XX_TOCK; M65XX_WAIT; M65XX_PC.b.h=M65XX_PEEK(a.w);
 					break;
-				case 0X84: // STY $NN
+				case 0X84: M65XX_LABEL(84) // STY $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_Y);
 					break;
-				case 0X8C: // STY $NNNN
+				case 0X8C: M65XX_LABEL(8C) // STY $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_Y);
 					#ifdef M65XX_REU
 					if (reu_size>0) _t_=0; // throw!
 					#endif
 					break;
-				case 0X94: // STY $NN,X
+				case 0X94: M65XX_LABEL(94) // STY $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_Y);
 					break;
-				case 0X9C: // SHY $NNNN,X
+				case 0X9C: M65XX_LABEL(9C) // SHY $NNNN,X
 					M65XX_ABS_X_SHZAW;
 					M65XX_TOCK; M65XX_TICK; M65XX_SHZ(q,M65XX_Y); // TICK must happen before SHZ!
 					M65XX_PAGE(a.b.h); M65XX_POKE(a.w,q);
 					break;
-				case 0XA4: // LDY $NN
+				case 0XA4: M65XX_LABEL(A4) // LDY $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_Y=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XAC: // LDY $NNNN
+				case 0XAC: M65XX_LABEL(AC) // LDY $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_Y=M65XX_PEEK(a.w);
 					break;
-				case 0XB4: // LDY $NN,X
+				case 0XB4: M65XX_LABEL(B4) // LDY $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_Y=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XBC: // LDY $NNNN,X
+				case 0XBC: M65XX_LABEL(BC) // LDY $NNNN,X
 					M65XX_ABS_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_Y=M65XX_PEEK(a.w);
 					break;
-				case 0XC4: // CPY $NN
+				case 0XC4: M65XX_LABEL(C4) // CPY $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; M65XX_CPY(M65XX_PEEKZERO(a.w));
 					break;
-				case 0XCC: // CPY $NNNN
+				case 0XCC: M65XX_LABEL(CC) // CPY $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_CPY(M65XX_PEEK(a.w));
 					break;
-				case 0XE4: // CPX $NN
+				case 0XE4: M65XX_LABEL(E4) // CPX $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; M65XX_CPX(M65XX_PEEKZERO(a.w));
 					break;
-				case 0XEC: // CPX $NNNN
+				case 0XEC: M65XX_LABEL(EC) // CPX $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_CPX(M65XX_PEEK(a.w));
 					break;
 				// opcodes N*8+5 ---------------------------- //
-				case 0X05: // ORA $NN
+				case 0X05: M65XX_LABEL(05) // ORA $NN
 					M65XX_ZPG; go_to_ora_peekzero: // *!* GOTO!
 					M65XX_TOCK; M65XX_WAIT; M65XX_ORA(M65XX_PEEKZERO(a.w));
 					break;
-				case 0X0D: // ORA $NNNN
+				case 0X0D: M65XX_LABEL(0D) // ORA $NNNN
 					M65XX_ABS; go_to_ora_peek: // *!* GOTO!
 					M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_ORA(M65XX_PEEK(a.w));
 					break;
-				case 0X15: // ORA $NN,X
+				case 0X15: M65XX_LABEL(15) // ORA $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_ora_peekzero;
-				case 0X1D: // ORA $NNNN,X
+				case 0X1D: M65XX_LABEL(1D) // ORA $NNNN,X
 					M65XX_ABS_X; goto go_to_ora_peek;
-				case 0X25: // AND $NN
+				case 0X25: M65XX_LABEL(25) // AND $NN
 					M65XX_ZPG; go_to_and_peekzero: // *!* GOTO!
 					M65XX_TOCK; M65XX_WAIT; M65XX_AND(M65XX_PEEKZERO(a.w));
 					break;
-				case 0X2D: // AND $NNNN
+				case 0X2D: M65XX_LABEL(2D) // AND $NNNN
 					M65XX_ABS; go_to_and_peek: // *!* GOTO!
 					M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_AND(M65XX_PEEK(a.w));
 					break;
-				case 0X35: // AND $NN,X
+				case 0X35: M65XX_LABEL(35) // AND $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_and_peekzero;
-				case 0X3D: // AND $NNNN,X
+				case 0X3D: M65XX_LABEL(3D) // AND $NNNN,X
 					M65XX_ABS_X; goto go_to_and_peek;
-				case 0X45: // EOR $NN
+				case 0X45: M65XX_LABEL(45) // EOR $NN
 					M65XX_ZPG; go_to_eor_peekzero: // *!* GOTO!
 					M65XX_TOCK; M65XX_WAIT; M65XX_EOR(M65XX_PEEKZERO(a.w));
 					break;
-				case 0X4D: // EOR $NNNN
+				case 0X4D: M65XX_LABEL(4D) // EOR $NNNN
 					M65XX_ABS; go_to_eor_peek: // *!* GOTO!
 					M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_EOR(M65XX_PEEK(a.w));
 					break;
-				case 0X55: // EOR $NN,X
+				case 0X55: M65XX_LABEL(55) // EOR $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_eor_peekzero;
-				case 0X5D: // EOR $NNNN,X
+				case 0X5D: M65XX_LABEL(5D) // EOR $NNNN,X
 					M65XX_ABS_X; goto go_to_eor_peek;
-				case 0X65: // ADC $NN
+				case 0X65: M65XX_LABEL(65) // ADC $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; M65XX_ADC(M65XX_PEEKZERO(a.w));
 					break;
-				case 0X6D: // ADC $NNNN
+				case 0X6D: M65XX_LABEL(6D) // ADC $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_ADC(M65XX_PEEK(a.w));
 					break;
-				case 0X75: // ADC $NN,X
+				case 0X75: M65XX_LABEL(75) // ADC $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_TOCK; M65XX_WAIT; M65XX_ADC(M65XX_PEEKZERO(a.w));
 					break;
-				case 0X7D: // ADC $NNNN,X
+				case 0X7D: M65XX_LABEL(7D) // ADC $NNNN,X
 					M65XX_ABS_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_ADC(M65XX_PEEK(a.w));
 					break;
-				case 0X85: // STA $NN
+				case 0X85: M65XX_LABEL(85) // STA $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_A);
 					break;
-				case 0X8D: // STA $NNNN
+				case 0X8D: M65XX_LABEL(8D) // STA $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_A);
 					#ifdef M65XX_REU
 					if (reu_size>0) _t_=0; // throw!
 					#endif
 					break;
-				case 0X95: // STA $NN,X
+				case 0X95: M65XX_LABEL(95) // STA $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_A);
 					break;
-				case 0X9D: // STA $NNNN,X
+				case 0X9D: M65XX_LABEL(9D) // STA $NNNN,X
 					M65XX_ABS_X_BADAW; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_A);
 					break;
-				case 0XA5: // LDA $NN
+				case 0XA5: M65XX_LABEL(A5) // LDA $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_A=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XAD: // LDA $NNNN
+				case 0XAD: M65XX_LABEL(AD) // LDA $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_PEEK(a.w);
 					break;
-				case 0XB5: // LDA $NN,X
+				case 0XB5: M65XX_LABEL(B5) // LDA $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_A=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XBD: // LDA $NNNN,X
+				case 0XBD: M65XX_LABEL(BD) // LDA $NNNN,X
 					M65XX_ABS_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_PEEK(a.w);
 					break;
-				case 0XC5: // CMP $NN
+				case 0XC5: M65XX_LABEL(C5) // CMP $NN
 					M65XX_ZPG; go_to_cmp_peekzero: // *!* GOTO!
 					M65XX_TOCK; M65XX_WAIT; M65XX_CMP(M65XX_PEEKZERO(a.w));
 					break;
-				case 0XCD: // CMP $NNNN
+				case 0XCD: M65XX_LABEL(CD) // CMP $NNNN
 					M65XX_ABS; go_to_cmp_peek: // *!* GOTO!
 					M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_CMP(M65XX_PEEK(a.w));
 					break;
-				case 0XD5: // CMP $NN,X
+				case 0XD5: M65XX_LABEL(D5) // CMP $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_cmp_peekzero;
-				case 0XDD: // CMP $NNNN,X
+				case 0XDD: M65XX_LABEL(DD) // CMP $NNNN,X
 					M65XX_ABS_X; goto go_to_cmp_peek;
-				case 0XE5: // SBC $NN
+				case 0XE5: M65XX_LABEL(E5) // SBC $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; M65XX_SBC(M65XX_PEEKZERO(a.w));
 					break;
-				case 0XED: // SBC $NNNN
+				case 0XED: M65XX_LABEL(ED) // SBC $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_SBC(M65XX_PEEK(a.w));
 					break;
-				case 0XF5: // SBC $NN,X
+				case 0XF5: M65XX_LABEL(F5) // SBC $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_TOCK; M65XX_WAIT; M65XX_SBC(M65XX_PEEKZERO(a.w));
 					break;
-				case 0XFD: // SBC $NNNN,X
+				case 0XFD: M65XX_LABEL(FD) // SBC $NNNN,X
 					M65XX_ABS_X; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					M65XX_SBC(M65XX_PEEK(a.w));
 					break;
 				// opcodes N*8+6 ---------------------------- //
-				case 0X16: // ASL $NN,X
+				case 0X16: M65XX_LABEL(16) // ASL $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_asl_pokezero;
-				case 0X06: // ASL $NN
+				case 0X06: M65XX_LABEL(06) // ASL $NN
 					M65XX_ZPG; go_to_asl_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_ASL(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X0E: // ASL $NNNN
+				case 0X0E: M65XX_LABEL(0E) // ASL $NNNN
 					M65XX_ABS; go_to_asl_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -971,18 +993,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_ASL(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X1E: // ASL $NNNN,X
+				case 0X1E: M65XX_LABEL(1E) // ASL $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_asl_poke;
-				case 0X36: // ROL $NN,X
+				case 0X36: M65XX_LABEL(36) // ROL $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_rol_pokezero;
-				case 0X26: // ROL $NN
+				case 0X26: M65XX_LABEL(26) // ROL $NN
 					M65XX_ZPG; go_to_rol_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_ROL(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X2E: // ROL $NNNN
+				case 0X2E: M65XX_LABEL(2E) // ROL $NNNN
 					M65XX_ABS; go_to_rol_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -990,18 +1012,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_ROL(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X3E: // ROL $NNNN,X
+				case 0X3E: M65XX_LABEL(3E) // ROL $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_rol_poke;
-				case 0X56: // LSR $NN,X
+				case 0X56: M65XX_LABEL(56) // LSR $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_lsr_pokezero;
-				case 0X46: // LSR $NN
+				case 0X46: M65XX_LABEL(46) // LSR $NN
 					M65XX_ZPG; go_to_lsr_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_LSR(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X4E: // LSR $NNNN
+				case 0X4E: M65XX_LABEL(4E) // LSR $NNNN
 					M65XX_ABS; go_to_lsr_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1009,18 +1031,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_LSR(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X5E: // LSR $NNNN,X
+				case 0X5E: M65XX_LABEL(5E) // LSR $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_lsr_poke;
-				case 0X76: // ROR $NN,X
+				case 0X76: M65XX_LABEL(76) // ROR $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_ror_pokezero;
-				case 0X66: // ROR $NN
+				case 0X66: M65XX_LABEL(66) // ROR $NN
 					M65XX_ZPG; go_to_ror_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_ROR(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X6E: // ROR $NNNN
+				case 0X6E: M65XX_LABEL(6E) // ROR $NNNN
 					M65XX_ABS; go_to_ror_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1028,94 +1050,94 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_ROR(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X7E: // ROR $NNNN,X
+				case 0X7E: M65XX_LABEL(7E) // ROR $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_ror_poke;
-				case 0X86: // STX $NN
+				case 0X86: M65XX_LABEL(86) // STX $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_X);
 					break;
-				case 0X8E: // STX $NNNN
+				case 0X8E: M65XX_LABEL(8E) // STX $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_X);
 					#ifdef M65XX_REU
 					if (reu_size>0) _t_=0; // throw!
 					#endif
 					break;
-				case 0X96: // STX $NN,Y
+				case 0X96: M65XX_LABEL(96) // STX $NN,Y
 					M65XX_ZPG_Y_IRQ_BADPC;
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_X);
 					break;
-				case 0X9E: // SHX $NNNN,Y
+				case 0X9E: M65XX_LABEL(9E) // SHX $NNNN,Y
 					M65XX_ABS_Y_SHZAW;
 					M65XX_TOCK; M65XX_TICK; M65XX_SHZ(q,M65XX_X); // TICK must happen before SHZ! used in "FELLAS-EXT.PRG"
 					M65XX_PAGE(a.b.h); M65XX_POKE(a.w,q);
 					break;
-				case 0XA6: // LDX $NN
+				case 0XA6: M65XX_LABEL(A6) // LDX $NN
 					M65XX_ZPG;
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_X=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XAE: // LDX $NNNN
+				case 0XAE: M65XX_LABEL(AE) // LDX $NNNN
 					M65XX_ABS; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_X=M65XX_PEEK(a.w);
 					break;
-				case 0XB6: // LDX $NN,Y
+				case 0XB6: M65XX_LABEL(B6) // LDX $NN,Y
 					M65XX_ZPG_Y_IRQ_BADPC;
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_X=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XBE: // LDX $NNNN,Y
+				case 0XBE: M65XX_LABEL(BE) // LDX $NNNN,Y
 					M65XX_ABS_Y; M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_X=M65XX_PEEK(a.w);
 					break;
-				case 0XC6: // DEC $NN
+				case 0XC6: M65XX_LABEL(C6) // DEC $NN
 					M65XX_ZPG;
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_DEC(o);
 					M65XX_POKEZERO(a.w,o);
 					break;
-				case 0XCE: // DEC $NNNN
+				case 0XCE: M65XX_LABEL(CE) // DEC $NNNN
 					M65XX_ABS; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
 					M65XX_TICK; M65XX_DUMBPOKE(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_DEC(o);
 					M65XX_POKE(a.w,o);
 					break;
-				case 0XD6: // DEC $NN,X
+				case 0XD6: M65XX_LABEL(D6) // DEC $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_DEC(o);
 					M65XX_POKEZERO(a.w,o);
 					break;
-				case 0XDE: // DEC $NNNN,X
+				case 0XDE: M65XX_LABEL(DE) // DEC $NNNN,X
 					M65XX_ABS_X_BADAW; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
 					M65XX_TICK; M65XX_DUMBPOKE(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_DEC(o);
 					M65XX_POKE(a.w,o);
 					break;
-				case 0XE6: // INC $NN
+				case 0XE6: M65XX_LABEL(E6) // INC $NN
 					M65XX_ZPG;
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_INC(o);
 					M65XX_POKEZERO(a.w,o);
 					break;
-				case 0XEE: // INC $NNNN
+				case 0XEE: M65XX_LABEL(EE) // INC $NNNN
 					M65XX_ABS; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
 					M65XX_TICK; M65XX_DUMBPOKE(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_INC(o);
 					M65XX_POKE(a.w,o);
 					break;
-				case 0XF6: // INC $NN,X
+				case 0XF6: M65XX_LABEL(F6) // INC $NN,X
 					M65XX_ZPG_X_BADPC;
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_INC(o);
 					M65XX_POKEZERO(a.w,o);
 					break;
-				case 0XFE: // INC $NNNN,X
+				case 0XFE: M65XX_LABEL(FE) // INC $NNNN,X
 					M65XX_ABS_X_BADAW; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
 					M65XX_TICK; M65XX_DUMBPOKE(a.w,o);
@@ -1123,16 +1145,16 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_POKE(a.w,o);
 					break;
 				// opcodes N*8+7 ---------------------------- //
-				case 0X17: // SLO $NN,X
+				case 0X17: M65XX_LABEL(17) // SLO $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_slo_pokezero;
-				case 0X07: // SLO $NN
+				case 0X07: M65XX_LABEL(07) // SLO $NN
 					M65XX_ZPG; go_to_slo_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_SLO(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X0F: // SLO $NNNN
+				case 0X0F: M65XX_LABEL(0F) // SLO $NNNN
 					M65XX_ABS; go_to_slo_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1140,18 +1162,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_SLO(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X1F: // SLO $NNNN,X
+				case 0X1F: M65XX_LABEL(1F) // SLO $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_slo_poke;
-				case 0X37: // RLA $NN,X
+				case 0X37: M65XX_LABEL(37) // RLA $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_rla_pokezero;
-				case 0X27: // RLA $NN
+				case 0X27: M65XX_LABEL(27) // RLA $NN
 					M65XX_ZPG; go_to_rla_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_RLA(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X2F: // RLA $NNNN
+				case 0X2F: M65XX_LABEL(2F) // RLA $NNNN
 					M65XX_ABS; go_to_rla_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1159,18 +1181,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_RLA(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X3F: // RLA $NNNN,X
+				case 0X3F: M65XX_LABEL(3F) // RLA $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_rla_poke;
-				case 0X57: // SRE $NN,X
+				case 0X57: M65XX_LABEL(57) // SRE $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_sre_pokezero;
-				case 0X47: // SRE $NN
+				case 0X47: M65XX_LABEL(47) // SRE $NN
 					M65XX_ZPG; go_to_sre_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_SRE(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X4F: // SRE $NNNN
+				case 0X4F: M65XX_LABEL(4F) // SRE $NNNN
 					M65XX_ABS; go_to_sre_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1178,18 +1200,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_SRE(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X5F: // SRE $NNNN,X
+				case 0X5F: M65XX_LABEL(5F) // SRE $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_sre_poke;
-				case 0X77: // RRA $NN,X
+				case 0X77: M65XX_LABEL(77) // RRA $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_rra_pokezero;
-				case 0X67: // RRA $NN
+				case 0X67: M65XX_LABEL(67) // RRA $NN
 					M65XX_ZPG; go_to_rra_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_RRA(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0X6F: // RRA $NNNN
+				case 0X6F: M65XX_LABEL(6F) // RRA $NNNN
 					M65XX_ABS; go_to_rra_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1197,47 +1219,47 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_RRA(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0X7F: // RRA $NNNN,X
+				case 0X7F: M65XX_LABEL(7F) // RRA $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_rra_poke;
-				case 0X97: // SAX $NN,Y
+				case 0X97: M65XX_LABEL(97) // SAX $NN,Y
 					M65XX_ZPG_Y_IRQ_BADPC; goto go_to_sax_pokezero;
-				case 0X87: // SAX $NN
+				case 0X87: M65XX_LABEL(87) // SAX $NN
 					M65XX_ZPG; go_to_sax_pokezero: // *!* GOTO!
 					M65XX_TOCK; M65XX_TICK; M65XX_POKEZERO(a.w,M65XX_SAX);
 					break;
-				case 0X8F: // SAX $NNNN
+				case 0X8F: M65XX_LABEL(8F) // SAX $NNNN
 					M65XX_ABS; go_to_sax_poke: // *!* GOTO!
 					M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_TICK;
 					M65XX_POKE(a.w,M65XX_SAX);
 					break;
-				case 0X9F: // SHA $NNNN,Y
+				case 0X9F: M65XX_LABEL(9F) // SHA $NNNN,Y
 					M65XX_ABS_Y_SHZAW; go_to_sha_poke: // *!* GOTO!
 					M65XX_TOCK; M65XX_TICK; M65XX_SHZ(q,M65XX_SAX); // TICK must happen before SHZ!
 					M65XX_PAGE(a.b.h); M65XX_POKE(a.w,q);
 					break;
-				case 0XA7: // LAX $NN
+				case 0XA7: M65XX_LABEL(A7) // LAX $NN
 					M65XX_ZPG; go_to_lax_peekzero: // *!* GOTO!
 					M65XX_TOCK; M65XX_WAIT; z=n=M65XX_A=M65XX_X=M65XX_PEEKZERO(a.w);
 					break;
-				case 0XAF: // LAX $NNNN
+				case 0XAF: M65XX_LABEL(AF) // LAX $NNNN
 					M65XX_ABS; go_to_lax_peek: // *!* GOTO!
 					M65XX_TOCK; M65XX_PAGE(a.b.h); M65XX_WAIT;
 					z=n=M65XX_A=M65XX_X=M65XX_PEEK(a.w);
 					break;
-				case 0XB7: // LAX $NN,Y
+				case 0XB7: M65XX_LABEL(B7) // LAX $NN,Y
 					M65XX_ZPG_Y_IRQ_BADPC; goto go_to_lax_peekzero;
-				case 0XBF: // LAX $NNNN,Y
+				case 0XBF: M65XX_LABEL(BF) // LAX $NNNN,Y
 					M65XX_ABS_Y; goto go_to_lax_peek;
-				case 0XD7: // DCP $NN,X
+				case 0XD7: M65XX_LABEL(D7) // DCP $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_dcp_pokezero;
-				case 0XC7: // DCP $NN
+				case 0XC7: M65XX_LABEL(C7) // DCP $NN
 					M65XX_ZPG; go_to_dcp_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_DCP(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0XCF: // DCP $NNNN
+				case 0XCF: M65XX_LABEL(CF) // DCP $NNNN
 					M65XX_ABS; go_to_dcp_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1245,18 +1267,18 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_DCP(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0XDF: // DCP $NNNN,X
+				case 0XDF: M65XX_LABEL(DF) // DCP $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_dcp_poke;
-				case 0XF7: // ISB $NN,X
+				case 0XF7: M65XX_LABEL(F7) // ISB $NN,X
 					M65XX_ZPG_X_BADPC; goto go_to_isb_pokezero;
-				case 0XE7: // ISB $NN
+				case 0XE7: M65XX_LABEL(E7) // ISB $NN
 					M65XX_ZPG; go_to_isb_pokezero: // *!* GOTO!
 					M65XX_WAIT; o=M65XX_PEEKZERO(a.w);
 					M65XX_TICK; //M65XX_DUMBPOKEZERO(a.w,o);
 					M65XX_TOCK; M65XX_TICK; M65XX_ISB(q,o);
 					M65XX_POKEZERO(a.w,q);
 					break;
-				case 0XEF: // ISB $NNNN
+				case 0XEF: M65XX_LABEL(EF) // ISB $NNNN
 					M65XX_ABS; go_to_isb_poke: // *!* GOTO!
 					M65XX_PAGE(a.b.h); M65XX_WAIT;
 					o=M65XX_PEEK(a.w);
@@ -1264,39 +1286,41 @@ void M65XX_MAIN(int _t_) // runs the M65XX chip for at least `_t_` clock ticks;
 					M65XX_TOCK; M65XX_TICK; M65XX_ISB(q,o);
 					M65XX_POKE(a.w,q);
 					break;
-				case 0XFF: // ISB $NNNN,X
+				case 0XFF: M65XX_LABEL(FF) // ISB $NNNN,X
 					M65XX_ABS_X_BADAW; goto go_to_isb_poke;
 				// NOP and JAM opcodes ---------------------- //
-				case 0X80: case 0X82: case 0X89: case 0XC2: case 0XE2: // NOP #$NN
+				case 0X80: M65XX_LABEL(80) case 0X82: M65XX_LABEL(82) case 0X89: M65XX_LABEL(89) case 0XC2: M65XX_LABEL(C2) case 0XE2: M65XX_LABEL(E2) // NOP #$NN
 					M65XX_TOCK; M65XX_BADPC; ++M65XX_PC.w;
 					break;
-				case 0X04: case 0X44: case 0X64: // NOP $NN
+				case 0X04: M65XX_LABEL(04) case 0X44: M65XX_LABEL(44) case 0X64: M65XX_LABEL(64) // NOP $NN
 					M65XX_BADPC; ++M65XX_PC.w;
 					M65XX_TOCK; M65XX_BADPC;
 					break;
-				case 0X14: case 0X34: case 0X54: case 0X74: case 0XD4: case 0XF4: // NOP $NN,X
+				case 0X14: M65XX_LABEL(14) case 0X34: M65XX_LABEL(34) case 0X54: M65XX_LABEL(54) case 0X74: M65XX_LABEL(74) case 0XD4: M65XX_LABEL(D4) case 0XF4: M65XX_LABEL(F4) // NOP $NN,X
 					M65XX_BADPC; ++M65XX_PC.w;
 					M65XX_BADPC; M65XX_TOCK; M65XX_OLDPC; // both dumb reads aim to PC+1!
 					break;
-				case 0X0C: // NOP $NNNN
+				case 0X0C: M65XX_LABEL(0C) // NOP $NNNN
 					M65XX_ABS; M65XX_DUMBPAGE(a.b.h);
 					M65XX_TOCK; M65XX_WAIT; M65XX_DUMBPEEK(a.w);
 					break;
-				case 0X1C: case 0X3C: case 0X5C: case 0X7C: case 0XDC: case 0XFC: // NOP $NNNN,X
+				case 0X1C: M65XX_LABEL(1C) case 0X3C: M65XX_LABEL(3C) case 0X5C: M65XX_LABEL(5C) case 0X7C: M65XX_LABEL(7C) case 0XDC: M65XX_LABEL(DC) case 0XFC: M65XX_LABEL(FC) // NOP $NNNN,X
 					M65XX_ABS_X; M65XX_DUMBPAGE(a.b.h);
 					M65XX_TOCK; M65XX_WAIT; M65XX_DUMBPEEK(a.w);
 					break;
-				case 0XFA: // $FA BREAKPOINT
+				case 0XFA: M65XX_LABEL(FA) // $FA BREAKPOINT
 					#ifdef DEBUG_HERE
 					if (debug_break) { _t_=0,session_signal|=SESSION_SIGNAL_DEBUG; } // throw!
 					#endif
-				case 0X1A: case 0X3A: case 0X5A: case 0X7A: case 0XDA: // NOP (illegal!)
-				case 0XEA: // NOP (official)
+				case 0X1A: M65XX_LABEL(1A) case 0X3A: M65XX_LABEL(3A) case 0X5A: M65XX_LABEL(5A) case 0X7A: M65XX_LABEL(7A) case 0XDA: M65XX_LABEL(DA) // NOP (illegal!)
+				case 0XEA: M65XX_LABEL(EA) // NOP (official)
 					M65XX_TOCK; M65XX_BADPC;
 					break;
 				default: // ILLEGAL CODE!
 				//case 0X02: case 0X12: case 0X22: case 0X32: case 0X42: case 0X52: // JAM (1/2)
 				//case 0X62: case 0X72: case 0X92: case 0XB2: case 0XD2: case 0XF2: // JAM (2/2)
+					M65XX_LABEL(02) M65XX_LABEL(12) M65XX_LABEL(22) M65XX_LABEL(32) M65XX_LABEL(42) M65XX_LABEL(52)
+					M65XX_LABEL(62) M65XX_LABEL(72) M65XX_LABEL(92) M65XX_LABEL(B2) M65XX_LABEL(D2) M65XX_LABEL(F2)
 					#ifdef DEBUG_HERE
 					{ --M65XX_PC.w; _t_=0,session_signal|=SESSION_SIGNAL_DEBUG; } // throw!
 					#else
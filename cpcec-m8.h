@@ -17,7 +17,7 @@
 
 char sid_tone_shape[3][3],sid_tone_noisy[3][3],sid_tone_stage[3][3]; // oscillator + ADSR short values
 int sid_tone_count[3][4],sid_tone_limit[3][3],sid_tone_pulse[3][3],sid_tone_value[3][3],sid_tone_power[3][3]; // oscillator long values
-int sid_tone_cycle[3][3],sid_tone_adsr[3][4][3],*sid_tone_syncc[3][3],*sid_tone_ringg[3][3]; // ADSR long values, counters and pointers
+int sid_tone_cycle[3][4],sid_tone_adsr[3][4][3],*sid_tone_syncc[3][3],*sid_tone_ringg[3][3]; // ADSR long values, counters and pointers
 const int sid_adsr_table[16]={ 1,4,8,12,19,28,34,40,50,125,250,400,500,1500,2500,4000 }; // official milliseconds >>1
 #if !AUDIO_ALWAYS_MONO
 int sid_stereo[3][2]; // the three chips' LEFT and RIGHT weights
@@ -216,10 +216,10 @@ void sid_setup(void)
 }
 
 BYTE sid_filters=1,sid_samples=1,sid_delay[3]; INT8 sid_filter_raw[3][3],sid_filter_flt[3][3]; // filter states, mixing bitmasks and output values
-int sid_voice[3],sid_mixer[3],sid_filtered[3]; // sampled speech and digidrums
-double sid_filter_hw[3],sid_filter_bw[3],sid_filter_lw[3]; // I hate mixing [long] ints and [double] floats...
-double sid_filter_qu[3],sid_filter_fu[3]; // Chamberlin filter parameters; they're always above 0.0 and below 2.0 but they need precision
-double sid_filter_h[3],sid_filter_b[3],sid_filter_l[3],sid_filter_m[3]; // Chamberlin temporary values; `int` causes noisy precision loss
+int sid_voice[4],sid_mixer[3],sid_filtered[4]; // sampled speech and digidrums; the fourth item pads the chips to a SIMD vector, see below
+double sid_filter_hw[4],sid_filter_bw[4],sid_filter_lw[4]; // I hate mixing [long] ints and [double] floats...
+double sid_filter_qu[4],sid_filter_fu[4]; // Chamberlin filter parameters; they're always above 0.0 and below 2.0 but they need precision
+double sid_filter_h[4],sid_filter_b[4],sid_filter_l[4],sid_filter_m[4]; // Chamberlin temporary values; `int` causes noisy precision loss
 #define sid_filter_zero(x) (sid_filter_h[x]=sid_filter_b[x]=sid_filter_l[x]=sid_filter_m[x]=0)
 
 void sid_reg_update(int x,int i)
@@ -308,14 +308,95 @@ void sid_all_reset(void)
 
 // audio output ----------------------------------------------------- //
 
+#define SID_TONE_ADSR(x,c) switch (sid_tone_stage[x][c]) /* notice that the SID is internally handling the amplitudes as 8-bit values */ \
+{ \
+	case 0: /* ATTACK */ \
+		sid_tone_cycle[x][c]=sid_tone_adsr[x][0][c]; \
+		if ((sid_tone_power[x][c]+=(SID_MAX_VOICE+64)/SID_STEP_FAST_ADSR)>=SID_MAX_VOICE) \
+			sid_tone_stage[x][c]=1,sid_tone_power[x][c]=SID_MAX_VOICE; /* rise is linear */ \
+		break; \
+	case 1: /* DECAY + SUSTAIN */ \
+		sid_tone_cycle[x][c]=sid_tone_adsr[x][1][c]; /* float towards the right volume (NOT linear though) */ \
+		if (LIKELY((/*u=*/(v=sid_tone_adsr[x][3][c])-sid_tone_power[x][c])<0)) \
+			{ if ((sid_tone_power[x][c]=(sid_tone_power[x][c]*SID_STEP_SLOW_ADSR)>>9)<v) sid_tone_power[x][c]=v; } \
+		/*else if (UNLIKELY(u>0))*/ \
+			/*{ if ((sid_tone_power[x][c]+=(SID_MAX_VOICE+64)/SID_STEP_FAST_ADSR)>v) sid_tone_power[x][c]=v; }*/ /* rise!? */ \
+		else \
+			sid_tone_cycle[x][c]=1<<9; \
+		break; \
+	case 2: /* RELEASE */ \
+		sid_tone_cycle[x][c]=sid_tone_adsr[x][2][c]; \
+		if ((sid_tone_power[x][c]=(sid_tone_power[x][c]*SID_STEP_SLOW_ADSR)>>9)>0) break; /* fall is NOT linear either */ \
+		sid_tone_stage[x][c]=3; /* no `break`! */ \
+	default: /* SILENCE */ \
+		sid_tone_power[x][c]=0,sid_tone_cycle[x][c]=1<<9; \
+}
+// the wave generators after the counter `sid_tone_count[x][c]` moves on: `u` is the shape, `r` is the RING source and `z` is true if the noise must tick
+#define SID_TONE_WAVE(x,c,u,r,z) \
+	if (u<4) /* TRIANGLE/SAWTOOTH/HYBRID? (NONE is already set by sid_reg_update) */ \
+		{ if (u) sid_tone_value[x][c]=sid_shape_table[u][((r&0X80000)^sid_tone_count[x][c])>>11]*sid_tone_power[x][c]; } \
+	else if (u<8) /* PULSE? */ \
+		sid_tone_value[x][c]=(sid_tone_count[x][c]>=sid_tone_pulse[x][c]?sid_shape_table[u][sid_tone_count[x][c]>>11]:-128)*sid_tone_power[x][c]; \
+	else /* NOISE? beware, a noisy channel pointed by "ringg" cannot do `sid_tone_count[x][c]&=0XFFFF`: "Rasputin", "Swingers"... */ \
+		{ { if (z) sid_tone_noisy[x][c]=(INT8)crash[x]; } sid_tone_value[x][c]=sid_tone_noisy[x][c]*sid_tone_power[x][c]; }
+
+// the lockstep core handles the voices of each chip as a vector of four lanes (the fourth is padding): their ADSR timers and counters
+// move on together, and only the timers that expire and the chips with counters that overflow (and thus can SYNC) take the scalar way;
+// the Chamberlin filters of the chips also run in pairs of lanes. Every operation happens in the same order as in the voice-by-voice
+// loop, so the output is the same; the loop stays available thru `sid_lockstep` for comparison, and `-DSID_MAIN_SCALAR` keeps it alone.
+#ifndef SID_MAIN_SCALAR
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SID_I4 __m128i // four 32-bit integers
+#define SID_F2 __m128d // two 64-bit doubles
+#define SID_I4_LOAD(p) _mm_loadu_si128((__m128i const*)(p))
+#define SID_I4_SAVE(p,a) _mm_storeu_si128((__m128i*)(p),a)
+#define SID_I4_SET(a,b,c,d) _mm_set_epi32(d,c,b,a)
+#define SID_I4_ADD(a,b) _mm_add_epi32(a,b)
+#define SID_I4_SUB(a,b) _mm_sub_epi32(a,b)
+#define SID_I4_AND(a,b) _mm_and_si128(a,b)
+#define SID_I4_XOR(a,b) _mm_xor_si128(a,b)
+#define SID_I4_SAR(a,n) _mm_srai_epi32(a,n)
+#define SID_I4_GT(a,b) _mm_cmpgt_epi32(a,b) // -1 if a>b, 0 otherwise
+#define SID_I4_BITS(a) _mm_movemask_ps(_mm_castsi128_ps(a)) // lanes -1/0 into bits 1/0
+#define SID_I4_F2LO(a) _mm_cvtepi32_pd(a)
+#define SID_I4_F2HI(a) _mm_cvtepi32_pd(_mm_shuffle_epi32(a,0XEE))
+#define SID_F2_I4(a,b) _mm_unpacklo_epi64(_mm_cvttpd_epi32(a),_mm_cvttpd_epi32(b)) // truncated like `(int)`
+#define SID_F2_LOAD(p) _mm_loadu_pd(p)
+#define SID_F2_SAVE(p,a) _mm_storeu_pd(p,a)
+#define SID_F2_SAVELO(p,a) _mm_storel_pd(p,a)
+#define SID_F2_SET1(a) _mm_set1_pd(a)
+#define SID_F2_ADD(a,b) _mm_add_pd(a,b)
+#define SID_F2_SUB(a,b) _mm_sub_pd(a,b)
+#define SID_F2_MUL(a,b) _mm_mul_pd(a,b)
+#endif
+#endif
+#ifdef SID_I4
+char sid_lockstep=1; // the lockstep core is the default; the benchmark compares it against the voice-by-voice loop
+#endif
+
 void sid_main(int t/*,int d*/)
 {
 	static int r=0; // audio clock is slower, so remainder is kept here
 	if (audio_pos_z>=AUDIO_LENGTH_Z||(r+=t<<SID_MAIN_EXTRABITS)<0) return; // nothing to do!
 	/*d=-d<<8;*/
+	static unsigned int crash[3]={1,1,1};
+	static int w[4]={0,0,0,0}; // minimal antialiasing; it helps!
+	#ifdef SID_I4
+	SID_I4 kk[3],ww=SID_I4_SET(0,0,0,0),vv=ww; SID_F2 qq[2],ff[2],hw[2],bw[2],lw[2],hh[2],bb[2],ll[2],mm[2]; int f[4]; const char l=sid_lockstep;
+	if (l) // the parameters of the voices and the filters won't change until the next call
+	{
+		for (int x=sid_chips;x--;) // TEST mode stops the counters and the fourth lane never moves
+			kk[x]=SID_I4_SET(sid_tone_shape[x][0]<16?sid_tone_limit[x][0]:0,sid_tone_shape[x][1]<16?sid_tone_limit[x][1]:0,sid_tone_shape[x][2]<16?sid_tone_limit[x][2]:0,0);
+		ww=SID_I4_LOAD(w),vv=SID_I4_LOAD(sid_voice);
+		for (int x=0;x<2;++x)
+			qq[x]=SID_F2_LOAD(&sid_filter_qu[x*2]),ff[x]=SID_F2_LOAD(&sid_filter_fu[x*2]),
+			hw[x]=SID_F2_LOAD(&sid_filter_hw[x*2]),bw[x]=SID_F2_LOAD(&sid_filter_bw[x*2]),lw[x]=SID_F2_LOAD(&sid_filter_lw[x*2]),
+			hh[x]=SID_F2_LOAD(&sid_filter_h[x*2]),bb[x]=SID_F2_LOAD(&sid_filter_b[x*2]),ll[x]=SID_F2_LOAD(&sid_filter_l[x*2]),mm[x]=SID_F2_LOAD(&sid_filter_m[x*2]);
+	}
+	#endif
 	do
 	{
-		static unsigned int crash[3]={1,1,1};
 		#if !AUDIO_ALWAYS_MONO
 		static int n=0,o0=0,o1=0; // output averages
 		#else
@@ -328,6 +409,62 @@ void sid_main(int t/*,int d*/)
 			#if SID_MAIN_EXTRABITS
 			a=1<<SID_MAIN_EXTRABITS;
 			#endif
+			#ifdef SID_I4
+			if (l)
+			{
+				SID_I4 i4,m4; SID_F2 i2,m2;
+				for (int x=sid_chips;x--;)
+				{
+					crash[x]<<=1; crash[x]+=(((crash[x]>>23)^(crash[x]>>18))&1); // see below
+					int c,u,v,k; SID_I4 o4=SID_I4_SUB(SID_I4_LOAD(sid_tone_cycle[x]),SID_I4_SET(1,1,1,1)),n4;
+					SID_I4_SAVE(sid_tone_cycle[x],o4);
+					if (UNLIKELY(k=SID_I4_BITS(SID_I4_GT(SID_I4_SET(1,1,1,1),o4))&7)) // update the channels' ADSR?
+						for (c=0;k;++c,k>>=1) if (k&1) SID_TONE_ADSR(x,c);
+					n4=SID_I4_ADD(o4=SID_I4_LOAD(sid_tone_count[x]),kk[x]);
+					if (UNLIKELY(SID_I4_BITS(SID_I4_GT(n4,SID_I4_SET(0XFFFFF,0XFFFFF,0XFFFFF,0XFFFFF))))) // OVERFLOW? SYNC must go voice by voice
+						for (c=0;c<3;++c)
+						{
+							if ((u=sid_tone_shape[x][c])<16)
+							{
+								if ((sid_tone_count[x][c]=(v=sid_tone_count[x][c])+sid_tone_limit[x][c])&~0XFFFFF)
+									*sid_tone_syncc[x][c]=sid_tone_count[x][c]&=0XFFFFF;
+								SID_TONE_WAVE(x,c,u,*sid_tone_ringg[x][c],(v^sid_tone_count[x][c])&~0XFFFF);
+							}
+						}
+					else
+					{
+						v=*sid_tone_ringg[x][0]; // the first voice is updated before the RING source can be the third one
+						SID_I4_SAVE(sid_tone_count[x],n4);
+						k=SID_I4_BITS(SID_I4_GT(SID_I4_AND(SID_I4_XOR(o4,n4),SID_I4_SET(~0XFFFF,~0XFFFF,~0XFFFF,~0XFFFF)),SID_I4_SET(0,0,0,0)));
+						if ((u=sid_tone_shape[x][0])<16) { SID_TONE_WAVE(x,0,u,v,k&1); }
+						if ((u=sid_tone_shape[x][1])<16) { SID_TONE_WAVE(x,1,u,*sid_tone_ringg[x][1],k&2); }
+						if ((u=sid_tone_shape[x][2])<16) { SID_TONE_WAVE(x,2,u,*sid_tone_ringg[x][2],k&4); }
+					}
+					f[x]=(sid_filter_flt[x][0]&sid_tone_value[x][0])+(sid_filter_flt[x][1]&sid_tone_value[x][1])+(sid_filter_flt[x][2]&sid_tone_value[x][2]);
+				}
+				// the antialiasing and the filters of all the chips at once; the lanes of unused chips are never saved
+				m4=SID_I4_SAR(SID_I4_SUB(SID_I4_ADD(ww,vv),SID_I4_GT(vv,ww)),1);
+				if (sid_filters)
+				{
+					ww=m4; i4=SID_I4_SET(f[0],sid_chips>1?f[1]:0,sid_chips>2?f[2]:0,0);
+					for (int x=0;x<(sid_chips>2?2:1);++x)
+					{
+						i2=x?SID_I4_F2HI(i4):SID_I4_F2LO(i4);
+						ll[x]=SID_F2_ADD(ll[x],SID_F2_MUL(ff[x],bb[x]));
+						mm[x]=SID_F2_SUB(i2,SID_F2_MUL(qq[x],bb[x]));
+						hh[x]=SID_F2_SUB(mm[x],ll[x]);
+						bb[x]=SID_F2_ADD(bb[x],SID_F2_MUL(ff[x],hh[x]));
+					}
+					m2=SID_F2_SET1(.5);
+					SID_I4 j4=SID_F2_I4(SID_F2_ADD(SID_F2_ADD(SID_F2_ADD(SID_F2_MUL(hh[0],hw[0]),SID_F2_MUL(bb[0],bw[0])),SID_F2_MUL(ll[0],lw[0])),m2),
+						SID_F2_ADD(SID_F2_ADD(SID_F2_ADD(SID_F2_MUL(hh[1],hw[1]),SID_F2_MUL(bb[1],bw[1])),SID_F2_MUL(ll[1],lw[1])),m2));
+					m4=SID_I4_ADD(m4,sid_nouveau?SID_I4_ADD(j4,SID_I4_SAR(SID_I4_SUB(i4,j4),8)):SID_I4_SAR(SID_I4_ADD(j4,i4),1));
+				}
+				else ww=vv;
+				SID_I4_SAVE(sid_filtered,m4);
+			}
+			else
+			#endif
 			for (int x=sid_chips;x--;)
 			{
 				// notice that the "real" LFSR is handled outside this function, as it must "tick" even when sound is off
@@ -336,44 +473,16 @@ void sid_main(int t/*,int d*/)
 				for (int c=0,u,v;c<3;++c)
 				{
 					if (--sid_tone_cycle[x][c]<=0) // update the channels' ADSR?
-						switch (sid_tone_stage[x][c]) // notice that the SID is internally handling the amplitudes as 8-bit values
-						{
-							case 0: // ATTACK
-								sid_tone_cycle[x][c]=sid_tone_adsr[x][0][c];
-								if ((sid_tone_power[x][c]+=(SID_MAX_VOICE+64)/SID_STEP_FAST_ADSR)>=SID_MAX_VOICE)
-									sid_tone_stage[x][c]=1,sid_tone_power[x][c]=SID_MAX_VOICE; // rise is linear
-								break;
-							case 1: // DECAY + SUSTAIN
-								sid_tone_cycle[x][c]=sid_tone_adsr[x][1][c]; // float towards the right volume (NOT linear though)
-								if (LIKELY((/*u=*/(v=sid_tone_adsr[x][3][c])-sid_tone_power[x][c])<0))
-									{ if ((sid_tone_power[x][c]=(sid_tone_power[x][c]*SID_STEP_SLOW_ADSR)>>9)<v) sid_tone_power[x][c]=v; }
-								//else if (UNLIKELY(u>0))
-									//{ if ((sid_tone_power[x][c]+=(SID_MAX_VOICE+64)/SID_STEP_FAST_ADSR)>v) sid_tone_power[x][c]=v; } // rise!?
-								else
-									sid_tone_cycle[x][c]=1<<9;
-								break;
-							case 2: // RELEASE
-								sid_tone_cycle[x][c]=sid_tone_adsr[x][2][c];
-								if ((sid_tone_power[x][c]=(sid_tone_power[x][c]*SID_STEP_SLOW_ADSR)>>9)>0) break; // fall is NOT linear either
-								sid_tone_stage[x][c]=3; // no `break`!
-							default: // SILENCE
-								sid_tone_power[x][c]=0,sid_tone_cycle[x][c]=1<<9;
-						}
+						SID_TONE_ADSR(x,c);
 					if ((u=sid_tone_shape[x][c])<16) // update the channels' wave generators? TEST mode must be off!
 					{
 						if ((sid_tone_count[x][c]=(v=sid_tone_count[x][c])+sid_tone_limit[x][c])&~0XFFFFF) // OVERFLOW?
 							*sid_tone_syncc[x][c]=sid_tone_count[x][c]&=0XFFFFF;
-						if (u<4) // TRIANGLE/SAWTOOTH/HYBRID? (NONE is already set by sid_reg_update)
-							{ if (u) sid_tone_value[x][c]=sid_shape_table[u][((*sid_tone_ringg[x][c]&0X80000)^sid_tone_count[x][c])>>11]*sid_tone_power[x][c]; }
-						else if (u<8) // PULSE?
-							sid_tone_value[x][c]=(sid_tone_count[x][c]>=sid_tone_pulse[x][c]?sid_shape_table[u][sid_tone_count[x][c]>>11]:-128)*sid_tone_power[x][c];
-						else // NOISE? beware, a noisy channel pointed by "ringg" cannot do `sid_tone_count[x][c]&=0XFFFF`: "Rasputin", "Swingers"...
-							{ { if ((v^sid_tone_count[x][c])&~0XFFFF) sid_tone_noisy[x][c]=(INT8)crash[x]; } sid_tone_value[x][c]=sid_tone_noisy[x][c]*sid_tone_power[x][c]; }
+						SID_TONE_WAVE(x,c,u,*sid_tone_ringg[x][c],(v^sid_tone_count[x][c])&~0XFFFF);
 					}
 				}
 				//if (sid_mixer[x]) // skip calculations if the chip is muted // the digis must play in "PULSOID" despite the bogus filter!
 				{
-					static int w[3]={0,0,0}; // minimal antialiasing; it helps!
 					sid_filtered[x]=(w[x]+sid_voice[x]+(w[x]<sid_voice[x]?1:0))>>1;
 					if (sid_filters) // skip the calculations if filters are off
 					{
@@ -430,6 +539,22 @@ void sid_main(int t/*,int d*/)
 		}
 	}
 	while ((r-=SID_TICK_STEP)>=0);
+	#ifdef SID_I4
+	if (l) // save the lanes of the chips in use
+	{
+		SID_I4_SAVE(f,ww); for (int x=sid_chips;x--;) w[x]=f[x];
+		for (int x=0;x<sid_chips;x+=2)
+			if (x+1<sid_chips)
+				SID_F2_SAVE(&sid_filter_h[x],hh[x/2]),SID_F2_SAVE(&sid_filter_b[x],bb[x/2]),SID_F2_SAVE(&sid_filter_l[x],ll[x/2]),SID_F2_SAVE(&sid_filter_m[x],mm[x/2]);
+			else
+				SID_F2_SAVELO(&sid_filter_h[x],hh[x/2]),SID_F2_SAVELO(&sid_filter_b[x],bb[x/2]),SID_F2_SAVELO(&sid_filter_l[x],ll[x/2]),SID_F2_SAVELO(&sid_filter_m[x],mm[x/2]);
+	}
+	#endif
+	// a filter without input fades away into denormals, and they're very slow in most FPUs: flush them before they last forever.
+	// the output doesn't change: the filter values are always added to integers, and the outputs are truncated integers as well.
+	for (int x=sid_chips;x--;)
+		if (sid_filter_b[x]>-1E-99&&sid_filter_b[x]<1E-99&&sid_filter_l[x]>-1E-99&&sid_filter_l[x]<1E-99)
+			sid_filter_zero(x);
 }
 
 // other operations ------------------------------------------------- //
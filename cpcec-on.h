@@ -0,0 +1,419 @@
+ //  ####  ######    ####  #######   ####  ------------------------- //
+//  ##  ##  ##  ##  ##  ##  ##   #  ##  ##  CPCEC, plain text Amstrad //
+// ##       ##  ## ##       ## #   ##       CPC emulator written in C //
+// ##       #####  ##       ####   ##       as a postgraduate project //
+// ##       ##     ##       ## #   ##       by Cesar Nicolas-Gonzalez //
+//  ##  ##  ##      ##  ##  ##   #  ##  ##  since 2018-12-01 till now //
+ //  ####  ####      ####  #######   ####  ------------------------- //
+
+// HEADLESS is the third supported platform; to compile the emulator type
+// "$(CC) -DHEADLESS -xc cpcec.c -lm -lpthread" for GCC, TCC, CLANG et al.
+// There's no window, no audio device and no user interface: frames are
+// still rendered in memory (screenshots and recordings work as usual)
+// but the emulation runs at full host speed, without any pauses, until
+// the frame budget `-nN` is spent or the debugger is summoned; `-iN`
+// runs N instances of the session in parallel, see session_spawn().
+
+// START OF HEADLESS DEFINITIONS ==================================== //
+
+#ifdef _WIN32
+	#define STRMAX 640 // 288 // widespread in Windows
+	#define PATHCHAR '\\' // WIN32
+	#include <windows.h> // GetFullPathName...
+	#include <io.h> // _chsize(),_fileno()...
+	#define fsetsize(f,l) (!_chsize(_fileno(f),(l))) // NONZERO OK, like the POSIX version
+	#define strcasecmp _stricmp
+	#define ARGVZERO (GetModuleFileName(NULL,session_substr,sizeof(session_substr))?session_substr:argv[0])
+#else
+	#include <limits.h> // PATH_MAX...
+	#ifdef PATH_MAX
+		#define STRMAX PATH_MAX
+	#else
+		#define STRMAX 640 // see the SDL2 definitions
+	#endif
+	#define PATHCHAR '/' // POSIX
+	#include <sys/stat.h> // stat()...
+	#include <unistd.h> // ftruncate(),fileno()...
+	#include <time.h> // clock_gettime()...
+	#include <strings.h> // strcasecmp()...
+	#include <sys/wait.h> // wait()...
+	#include <errno.h> // EINTR...
+	#include <signal.h> // signal()...
+	#include <pthread.h> // pthread_create()...
+	#include <semaphore.h> // sem_init()...
+	#define fsetsize(f,l) (!ftruncate(fileno(f),(l)))
+	#define INT8 signed char
+	#define BYTE unsigned char
+	#define WORD unsigned short
+	#define DWORD unsigned int // the pixel style below must be exactly 32 bits long
+	#define ARGVZERO argv[0]
+#endif
+#define I18N_MULTIPLY "x"
+
+#define MESSAGEBOX_WIDETAB "\t\t" // the console relies on monospace fonts
+#define GPL_3_LF "\n" // the console needs preset line feeds
+
+// general engine constants and variables --------------------------- //
+
+typedef signed short AUDIO_UNIT; // standard 16-bit audio
+#define AUDIO_BITDEPTH 16
+#define AUDIO_ZERO 0
+#define AUDIO_BYTESTEP (AUDIO_CHANNELS*AUDIO_BITDEPTH/8) // i.e. 1, 2 or 4 bytes
+typedef DWORD VIDEO_UNIT; // the pixel style must be 0X00RRGGBB and nothing else!
+
+VIDEO_UNIT *video_frame,*video_blend; // video + blend frames, allocated on runtime
+AUDIO_UNIT audio_frame[AUDIO_PLAYBACK/50*AUDIO_CHANNELS]; // audio frame; 50 is the lowest legal framerate
+VIDEO_UNIT *video_target; // pointer to current video pixel
+AUDIO_UNIT *audio_target; // pointer to current audio sample
+unsigned int session_joybits=0; // nobody can move a joystick here
+char session_path[STRMAX],session_parmtr[STRMAX],session_tmpstr[STRMAX],session_substr[STRMAX],session_info[STRMAX]="";
+int session_headless=0; // frame budget: 0 = endless, >0 = quit after this many frames
+int session_exitcode=0; // 0 = the frame budget was spent, 2 = the debugger was summoned
+int session_instances=0,session_workers=0,session_instance=0; // amount of instances, processes at once (0 = one per core) and current instance
+
+// the keyboard codes follow the USB standard like in SDL2, so configuration files remain interchangeable
+
+// function keys
+#define KBCODE_F1	 58
+#define KBCODE_F2	 59
+#define KBCODE_F3	 60
+#define KBCODE_F4	 61
+#define KBCODE_F5	 62
+#define KBCODE_F6	 63
+#define KBCODE_F7	 64
+#define KBCODE_F8	 65
+#define KBCODE_F9	 66
+#define KBCODE_F10	 67
+#define KBCODE_F11	 68
+#define KBCODE_F12	 69
+// leftmost keys
+#define KBCODE_ESCAPE	 41
+#define KBCODE_TAB	 43
+#define KBCODE_CAPSLOCK	 57
+#define KBCODE_L_SHIFT	225
+#define KBCODE_L_CTRL	224
+//#define KBCODE_L_ALT	226 // trapped by Win32
+// alphanumeric row 1
+#define KBCODE_1	 30
+#define KBCODE_2	 31
+#define KBCODE_3	 32
+#define KBCODE_4	 33
+#define KBCODE_5	 34
+#define KBCODE_6	 35
+#define KBCODE_7	 36
+#define KBCODE_8	 37
+#define KBCODE_9	 38
+#define KBCODE_0	 39
+#define KBCODE_CHR1_1	 45
+#define KBCODE_CHR1_2	 46
+#define KBCODE_CHR4_5	100 // this is the key before "1" in modern keyboards
+// alphanumeric row 2
+#define KBCODE_Q	 20
+#define KBCODE_W	 26
+#define KBCODE_E	  8
+#define KBCODE_R	 21
+#define KBCODE_T	 23
+#define KBCODE_Y	 28
+#define KBCODE_U	 24
+#define KBCODE_I	 12
+#define KBCODE_O	 18
+#define KBCODE_P	 19
+#define KBCODE_CHR2_1	 47
+#define KBCODE_CHR2_2	 48
+// alphanumeric row 3
+#define KBCODE_A	  4
+#define KBCODE_S	 22
+#define KBCODE_D	  7
+#define KBCODE_F	  9
+#define KBCODE_G	 10
+#define KBCODE_H	 11
+#define KBCODE_J	 13
+#define KBCODE_K	 14
+#define KBCODE_L	 15
+#define KBCODE_CHR3_1	 51
+#define KBCODE_CHR3_2	 52
+#define KBCODE_CHR3_3	 49
+// alphanumeric row 4
+#define KBCODE_Z	 29
+#define KBCODE_X	 27
+#define KBCODE_C	  6
+#define KBCODE_V	 25
+#define KBCODE_B	  5
+#define KBCODE_N	 17
+#define KBCODE_M	 16
+#define KBCODE_CHR4_1	 54
+#define KBCODE_CHR4_2	 55
+#define KBCODE_CHR4_3	 56
+#define KBCODE_CHR4_4	 53 // this is the key before "Z" in 105-key modern keyboards; missing in 104-key layouts!
+// rightmost keys
+#define KBCODE_SPACE	 44
+#define KBCODE_BKSPACE	 42
+#define KBCODE_ENTER	 40
+#define KBCODE_R_SHIFT	229
+#define KBCODE_R_CTRL	228
+// #define KBCODE_R_ALT	230 // trapped by Win32
+// extended keys
+// #define KBCODE_PRINT	 70 // trapped by Win32
+#define KBCODE_SCR_LOCK	 71
+#define KBCODE_HOLD	 72
+#define KBCODE_INSERT	 73
+#define KBCODE_DELETE	 76
+#define KBCODE_HOME	 74
+#define KBCODE_END	 77
+#define KBCODE_PRIOR	 75
+#define KBCODE_NEXT	 78
+#define KBCODE_UP	 82
+#define KBCODE_DOWN	 81
+#define KBCODE_LEFT	 80
+#define KBCODE_RIGHT	 79
+#define KBCODE_APPS	101
+// numeric keypad
+#define KBCODE_NUM_LOCK	 83
+#define KBCODE_X_7	 95
+#define KBCODE_X_8	 96
+#define KBCODE_X_9	 97
+#define KBCODE_X_4	 92
+#define KBCODE_X_5	 93
+#define KBCODE_X_6	 94
+#define KBCODE_X_1	 89
+#define KBCODE_X_2	 90
+#define KBCODE_X_3	 91
+#define KBCODE_X_0	 98
+#define KBCODE_X_DOT	 99
+#define KBCODE_X_ENTER	 88
+#define KBCODE_X_ADD	 87
+#define KBCODE_X_SUB	 86
+#define KBCODE_X_MUL	 85
+#define KBCODE_X_DIV	 84
+#define usbkey2native memcpy // no translation is needed;
+#define native2usbkey(str,n) // the keyboard is USB!
+BYTE kbd_k2j[]= // these keys can simulate a 4-button joystick
+	{ KBCODE_UP, KBCODE_DOWN, KBCODE_LEFT, KBCODE_RIGHT, KBCODE_Z, KBCODE_X, KBCODE_C, KBCODE_V };
+
+unsigned char kbd_map[256]; // key-to-key translation map
+
+// general engine functions and procedures -------------------------- //
+
+#ifdef _WIN32
+char basepath[STRMAX]; // is this long enough for the GetFullPathName() target buffer?
+char *makebasepath(const char *s) // fetch the absolute path of a relative path; returns NULL on error
+	{ char *m; return GetFullPathName(s,sizeof(basepath),basepath,&m)?basepath:NULL; }
+#else
+char basepath[8<<9]; // see the SDL2 definitions on realpath()
+#define makebasepath(s) realpath((s),basepath)
+#endif
+
+#define session_please() (session_wait=1) // there's nothing to stop...
+#define session_thanks() (session_wait=0) // ...or to resume!
+void session_kbdclear(void) // wipe keyboard and joystick bits
+	{ joy_kbd=joy_bit=session_joybits=0; MEMZERO(kbd_bit); }
+#define session_kbdreset() MEMBYTE(kbd_map,~~~0) // init and clean key map up
+void session_kbdsetup(const unsigned char *s,int l) // maps a series of virtual keys to the real ones
+{
+	session_kbdclear();
+	while (l--) { int k=*s++; kbd_map[k]=*s++; }
+}
+
+VIDEO_UNIT *debug_frame;
+BYTE session_hidemenu=0; // kept for the sake of the command line
+
+#define session_clrscr() ((void)0)
+#define session_clock (1000) // session_ticks() counts milliseconds
+void session_backupvideo(VIDEO_UNIT *t); // make a clipped copy of the current screen. Must be defined later on!
+int session_resize(void) { return 1; } // there's no window to resize
+#define session_drawme() ((void)0) // the frame is already in memory
+#define session_playme() ((void)0) // the audio frame too
+char *session_blitinfo(void) { return "NUL"; }
+
+int getftype(const char *s) // <0 = invalid path / nothing, 0 = file, >0 = directory
+{
+	#ifdef _WIN32
+	DWORD a=GetFileAttributes(s); return a==INVALID_FILE_ATTRIBUTES?-1:(a&FILE_ATTRIBUTE_DIRECTORY)?1:0;
+	#else
+	struct stat a; return !s||!*s||stat(s,&a)?-1:S_ISDIR(a.st_mode)?1:0;
+	#endif
+}
+
+// create, handle and destroy session ------------------------------- //
+
+int session_ticks(void) // get the `session_clock` tick count
+{
+	#ifdef _WIN32
+	return GetTickCount();
+	#else
+	struct timespec t; clock_gettime(CLOCK_MONOTONIC,&t); return t.tv_sec*1000+t.tv_nsec/1000000;
+	#endif
+}
+long long session_uticks(void) // get the monotonic high resolution clock in microseconds
+{
+	#ifdef _WIN32
+	static LARGE_INTEGER f={0}; LARGE_INTEGER t; if (!f.QuadPart) QueryPerformanceFrequency(&f); QueryPerformanceCounter(&t);
+	return t.QuadPart/f.QuadPart*1000000+t.QuadPart%f.QuadPart*1000000/f.QuadPart; // avoid overflows
+	#else
+	struct timespec t; clock_gettime(CLOCK_MONOTONIC,&t); return t.tv_sec*1000000LL+t.tv_nsec/1000;
+	#endif
+}
+
+// background threads: a thread launcher and counting semaphores
+#ifdef _WIN32
+#define SESSION_THREAD(f) DWORD WINAPI f(LPVOID session_thread_data) // 0 OK
+typedef HANDLE SESSION_THREADID,SESSION_SEMAPHORE;
+#define session_threadmake(t,f,p) (!(t=CreateThread(NULL,0,f,(p),0,NULL))) // 0 OK, !0 ERROR
+int session_cores(void) { SYSTEM_INFO s; GetSystemInfo(&s); return s.dwNumberOfProcessors; }
+#define session_threadwait(t) (WaitForSingleObject(t,INFINITE),CloseHandle(t))
+#define session_semaphoremake(s,n) (!(s=CreateSemaphore(NULL,n,1<<16,NULL))) // 0 OK, !0 ERROR
+#define session_semaphorefree(s) CloseHandle(s)
+#define session_semaphorewait(s) WaitForSingleObject(s,INFINITE)
+#define session_semaphoretest(s) (WaitForSingleObject(s,0)!=WAIT_OBJECT_0) // 0 OK, !0 BUSY
+#define session_semaphorepost(s) ReleaseSemaphore(s,1,NULL)
+#else
+#define SESSION_THREAD(f) void *f(void *session_thread_data) // NULL OK
+typedef pthread_t SESSION_THREADID; typedef sem_t *SESSION_SEMAPHORE;
+#define session_threadmake(t,f,p) pthread_create(&(t),NULL,f,(p)) // 0 OK, !0 ERROR
+#define session_cores() sysconf(_SC_NPROCESSORS_ONLN)
+#define session_threadwait(t) pthread_join(t,NULL)
+#define session_semaphoremake(s,n) ((s=malloc(sizeof(sem_t)))?sem_init(s,0,n)&&(free(s),1):1) // 0 OK, !0 ERROR
+#define session_semaphorefree(s) (sem_destroy(s),free(s))
+#define session_semaphorewait(s) sem_wait(s)
+#define session_semaphoretest(s) sem_trywait(s) // 0 OK, !0 BUSY
+#define session_semaphorepost(s) sem_post(s)
+#endif
+
+int session_benchmark=0,session_benchtime; // `-b` reports the emulation speed when the session ends, `-bb` also measures the video filters and the sound, `-bbb` the ZIP archives and the PNG screenshots
+void video_benchscanlines(void),audio_benchmain(void),audio_benchresample(void),session_benchscrn(void); // see cpcec-rt.h
+
+INLINE char *session_create(char *s) // create video+audio buffers; the menu `s` is ignored; NULL OK, *char ERROR!
+{
+	strcpy(session_version,"0.0"); // no library to speak of
+	if (!(video_frame=malloc(sizeof(VIDEO_UNIT[VIDEO_LENGTH_X*VIDEO_LENGTH_Y])))||
+		!(video_blend=malloc(sizeof(VIDEO_UNIT[16+(VIDEO_PIXELS_Y>>!!VIDEO_HALFBLEND)*VIDEO_PIXELS_X])))||
+		!(debug_frame=malloc(sizeof(VIDEO_UNIT[VIDEO_PIXELS_X*VIDEO_PIXELS_Y]))))
+		return "out of memory";
+	session_hardblit=session_audio=session_stick=0; // no devices at all
+	#ifndef _WIN32
+	signal(SIGPIPE,SIG_IGN); // a stream reader that quits early must not kill us: session_writestream() sees the short write instead
+	#endif
+	session_clean(); session_please();
+	session_benchtime=session_ticks();
+	return NULL;
+}
+
+INLINE void session_byebye(void) // delete video+audio buffers
+{
+	if (session_benchmark&&video_pos_z) // the parent of several instances doesn't emulate anything
+	{
+		int t=session_ticks()-session_benchtime; if (t<1) t=1;
+		fprintf(stderr,"#%d: %d frames in %d ms, %d fps\n",session_instance,video_pos_z,t,(int)(video_pos_z*1000LL/t));
+		if (session_benchmark>1) video_benchscanlines(),audio_benchmain(),audio_benchresample();
+		if (session_benchmark>2) session_benchscrn();
+	}
+	free(debug_frame); free(video_blend); free(video_frame);
+}
+
+// operations summonned by session_listen() and session_update()
+
+#define session_title(s) ((void)0) // there's no caption
+#define session_sleep() ((void)0) // nothing can wake us up; see session_queue()
+#define session_delay(i) ((void)0) // never wait: run at full host speed
+#define session_pacing(t) ((void)0) // ditto
+#define audio_mustsync() ((void)0) // nothing to do here;
+#define audio_resyncme() // there's no audio device!
+int session_queue(void) // walk message queue: NONZERO = QUIT
+{
+	if (session_signal&(SESSION_SIGNAL_DEBUG|SESSION_SIGNAL_PAUSE))
+		return session_exitcode=2,1; // nobody can operate the debugger or resume the emulation!
+	if (session_headless>0&&video_pos_z>=session_headless)
+		return 1; // frame budget spent: it's over
+	if (session_event)
+	{
+		if (0X0080==session_event) // Menu entry "Exit"
+			return 1;
+		session_dirty=1,session_user(session_event);
+		session_event=0;
+	}
+	return 0; // OK
+}
+int session_joy2k(void) // turn the joystick status into bits
+	{ return session_joybits; }
+
+// batch instances -------------------------------------------------- //
+
+// the emulation state lives in global variables, so the instances can't
+// share a process; instead, the session forks one worker per instance and
+// keeps up to `session_workers` of them running at once: as soon as one
+// ends, the next instance takes its place, and the cores never starve.
+
+int session_spawn(void) // run the instances, if any; 0 = no instances, >0 = we're an instance, <0 = all instances are over
+{
+	if (session_instances<1) return 0;
+	#ifdef _WIN32
+	return printf("warning: instances are handled one at a time here\n"),0; // no fork() in Windows!
+	#else
+	int n=session_workers>0?session_workers:session_cores(),i=0,busy=0,s; pid_t p;
+	if (n<1) n=1; fflush(stdout); // the workers mustn't inherit pending output
+	while (i<session_instances||busy)
+	{
+		if (i<session_instances&&busy<n&&(p=fork())>=0)
+		{
+			if (!p) return session_instance=i,i+1; // the worker begins here
+			++i,++busy;
+		}
+		else if (busy)
+		{
+			if (wait(&s)<0)
+			{
+				if (errno==EINTR) continue; // a signal woke us up: wait again
+				session_exitcode=1; break; // we lost track of the workers!
+			}
+			--busy; s=WIFEXITED(s)?WEXITSTATUS(s):1; // a crash is an error, too
+			if (session_exitcode<s) session_exitcode=s; // keep the worst result
+		}
+		else
+			{ session_exitcode=1; break; } // we can't launch anything!
+	}
+	return -1;
+	#endif
+}
+
+// menu item functions ---------------------------------------------- //
+
+#define session_menucheck(id,q) ((void)0) // there's no menu
+#define session_menuradio(id,a,z) ((void)0) // ditto
+
+// message box ------------------------------------------------------ //
+
+int session_message(char *s,char *t) { return printf("%s: %s\n",t,s); } // dump multi-lined text `s` under caption `t`
+#define session_aboutme(s,t) session_message((s),(t)) // special case: "About.."
+
+// dialogs: nobody can answer them, so they always fail ------------- //
+
+#define session_line(t) (-1)
+#define session_list(i,s,t) (-1)
+#define session_scan(s) (-1)
+BYTE session_readonly=1;
+#define session_filedialog_get_readonly() (session_readonly)
+#define session_filedialog_set_readonly(q) (session_readonly=!!(q))
+#define session_newfile(r,s,t) ((char*)NULL)
+#define session_getfile(r,s,t) ((char*)NULL)
+#define session_getfilereadonly(r,s,t,q) ((char*)NULL)
+
+// final definitions ------------------------------------------------ //
+
+#define SDL_LIL_ENDIAN 1234 // borrowed from SDL2
+#define SDL_BIG_ENDIAN 4321
+#if defined(__BYTE_ORDER__)&&__BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+#define SDL_BYTEORDER SDL_BIG_ENDIAN
+#else
+#define SDL_BYTEORDER SDL_LIL_ENDIAN
+#endif
+
+#include <math.h>
+#ifndef M_PI
+#define M_PI 3.14159265358979323846264338327950288
+#endif
+#define SDL_pow pow
+#define SDL_sin sin
+
+#define BOOTSTRAP // the headless version is terminal-driven
+
+// ====================================== END OF HEADLESS DEFINITIONS //
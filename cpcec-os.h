@@ -24,7 +24,7 @@
 #define STRMAX 640 // 288 // widespread in Windows
 #define PATHCHAR '\\' // unlike '/' (POSIX)
 #define strcasecmp _stricmp // from MSVCRT!
-#define fsetsize(f,l) _chsize(_fileno(f),(l))
+#define fsetsize(f,l) (!_chsize(_fileno(f),(l))) // NONZERO OK, like the POSIX version
 #include <io.h> // _chsize(),_fileno()...
 // WIN32 is never UTF-8; it's either ANSI (...A) or UNICODE (...W)
 #define ARGVZERO (GetModuleFileName(NULL,session_substr,sizeof(session_substr))?session_substr:argv[0])
@@ -264,6 +264,7 @@ int session_k2joy(int k) // translate key code; -8..-1 = joystick bit 0..7, 0..1
 
 #define session_clrscr() InvalidateRect(session_hwnd,NULL,1)
 int session_clock=1000; // by default the unit is the millisecond from the internal tick count
+UINT session_timeperiod=1; // the resolution of Sleep() in milliseconds, as set by timeBeginPeriod()
 int session_r_x,session_r_y,session_r_w,session_r_h; // actual location and size of the bitmap
 void session_desktop(RECT *r) { SystemParametersInfo(SPI_GETWORKAREA,0,r,0); r->right-=r->left,r->bottom-=r->top; } // i.e. width and height
 int session_resize(void) // dunno why, but one 100% render must happen before the resizing; performance falls otherwise :-/
@@ -674,7 +675,8 @@ INLINE char *session_create(char *s) // create video+audio devices and set menu;
 	}
 	session_clean(); session_please();
 	session_redraw(session_hwnd,session_dc1); // dummy first redraw, session_resize() hinges on it
-	timeBeginPeriod(8); // WIN10 sets this value too high by default; 8 is recommended in multiple sources
+	{ TIMECAPS tc; session_timeperiod=timeGetDevCaps(&tc,sizeof(tc))==TIMERR_NOERROR&&tc.wPeriodMin>1?tc.wPeriodMin:1; }
+	timeBeginPeriod(session_timeperiod); // WIN10 sets this value too high by default; the frame pacing wants the finest one
 	return NULL;
 }
 
@@ -698,7 +700,7 @@ INLINE void session_byebye(void) // delete video+audio devices
 	if (session_dib) DeleteObject(session_dib);
 	ReleaseDC(session_hwnd,session_dc1);
 	free(video_blend);
-	timeEndPeriod(8); // possibly unnecessary even on WIN10, as the programme is ending
+	timeEndPeriod(session_timeperiod); // possibly unnecessary even on WIN10, as the programme is ending
 }
 
 // operations summonned by session_listen() and session_update()
@@ -706,6 +708,7 @@ INLINE void session_byebye(void) // delete video+audio devices
 #define session_title(s) SetWindowText(session_hwnd,(s)) // set the window caption
 #define session_sleep() WaitMessage() // sleep till a system event happens
 #define session_delay(i) Sleep(i) // wait for approx `i` milliseconds
+#define SESSION_SPIN_MAX (session_timeperiod*1000+3000) // a Sleep() can wake up a whole timer period late
 char audio_needsync=0;
 #define audio_mustsync() (audio_needsync=1) // we must handle the sync
 void audio_resyncme(void) // because WinMM won't do it on its own <:-(
@@ -760,6 +763,25 @@ int session_ticks(void) // get the current system time; see also "session_clock"
 	}
 	else return GetTickCount(); // questionable for similar reasons, albeit every 23 days :-(
 }
+long long session_uticks(void) // get the current time in microseconds, following the same clock as session_ticks()
+{
+	if (session_audio) // the audio clock keeps the timer and the sound together; see above
+		return waveOutGetPosition(session_wo,&session_mmtime,sizeof(session_mmtime)),(int)session_mmtime.u.sample*1000000LL/AUDIO_PLAYBACK;
+	static LARGE_INTEGER f={0}; LARGE_INTEGER t; if (!f.QuadPart) QueryPerformanceFrequency(&f); QueryPerformanceCounter(&t);
+	return t.QuadPart/f.QuadPart*1000000+t.QuadPart%f.QuadPart*1000000/f.QuadPart; // avoid overflows
+}
+
+// background threads: a thread launcher and counting semaphores
+#define SESSION_THREAD(f) DWORD WINAPI f(LPVOID session_thread_data) // 0 OK
+typedef HANDLE SESSION_THREADID,SESSION_SEMAPHORE;
+#define session_threadmake(t,f,p) (!(t=CreateThread(NULL,0,f,(p),0,NULL))) // 0 OK, !0 ERROR
+int session_cores(void) { SYSTEM_INFO s; GetSystemInfo(&s); return s.dwNumberOfProcessors; }
+#define session_threadwait(t) (WaitForSingleObject(t,INFINITE),CloseHandle(t))
+#define session_semaphoremake(s,n) (!(s=CreateSemaphore(NULL,n,1<<16,NULL))) // 0 OK, !0 ERROR
+#define session_semaphorefree(s) CloseHandle(s)
+#define session_semaphorewait(s) WaitForSingleObject(s,INFINITE)
+#define session_semaphoretest(s) (WaitForSingleObject(s,0)!=WAIT_OBJECT_0) // 0 OK, !0 BUSY
+#define session_semaphorepost(s) ReleaseSemaphore(s,1,NULL)
 
 // menu item functions ---------------------------------------------- //
 
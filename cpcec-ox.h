@@ -27,7 +27,7 @@
 	#define PATHCHAR '\\' // WIN32
 	#include <windows.h> // FindFirstFile...
 	#include <io.h> // _chsize(),_fileno()...
-	#define fsetsize(f,l) _chsize(_fileno(f),(l))
+	#define fsetsize(f,l) (!_chsize(_fileno(f),(l))) // NONZERO OK, like the POSIX version
 	#define strcasecmp _stricmp // see also SDL_strcasecmp
 	// WIN32 is never UTF-8; it's either ANSI (...A) or UNICODE (...W)
 	#define ARGVZERO (GetModuleFileName(NULL,session_substr,sizeof(session_substr))?session_substr:argv[0])
@@ -320,18 +320,58 @@ void session_redraw(int q) // redraw main canvas (!0) or user interface (0)
 	}
 }
 #define session_drawme() session_redraw(1) // video shortcut!
+
+// the audio device pulls the samples thru a callback from a lock-free ring: the emulation is the only side that moves `audio_ring_w`
+// and the callback is the only one that moves `audio_ring_r`, so neither ever waits for the other. The ring is kept near the target
+// latency by resampling every frame a little faster or slower (0.5% at most, too little to hear) rather than by bending `session_timer`.
+// The device is opened at its own rate, so the same resampler (see cpcec-rt.h) also turns AUDIO_PLAYBACK into 48000 Hz or whatever.
+#define AUDIO_RING_MAXHZ 192000 // the highest device rate we resample to; faster devices are left to SDL
+#define AUDIO_L2RING (AUDIO_L2BUFFER+3) // =128K samples (683 ms at AUDIO_RING_MAXHZ), more than twice the longest latency
+AUDIO_UNIT audio_ring[AUDIO_CHANNELS<<AUDIO_L2RING]; SDL_atomic_t audio_ring_r,audio_ring_w; // the samples, the reader and the writer
+int audio_ring_z,audio_ring_f=0,audio_ring_i=0; SDL_atomic_t audio_ring_lost; // target and average length in samples, rate drift and underruns
+int audio_ring_hz; // the rate of the device
+void audio_resample_setup(int); int audio_resample(AUDIO_UNIT*,AUDIO_UNIT*,int,int); // see cpcec-rt.h
+void SDLCALL session_playback(void *u,Uint8 *t,int l) // the callback itself; bear in mind that it runs in the audio thread!
+{
+	static AUDIO_UNIT z[AUDIO_CHANNELS]={AUDIO_ZERO}; static BYTE s=1; // the last sample, in case of underrun, and whether the ring already ran dry
+	unsigned int r=SDL_AtomicGet(&audio_ring_r); int n=SDL_AtomicGet(&audio_ring_w)-r,i,j;
+	if (n>=(l/=AUDIO_BYTESTEP)) n=l,s=0; else if (!s) s=1,SDL_AtomicAdd(&audio_ring_lost,1); // a long stall counts as a single underrun
+	for (i=n;i>0;t+=j*AUDIO_BYTESTEP,r+=j,i-=j) // copy the samples in up to two blocks, before and after the end of the ring
+	{
+		if ((j=(1<<AUDIO_L2RING)-(r&((1<<AUDIO_L2RING)-1)))>i) j=i;
+		memcpy(t,&audio_ring[(r&((1<<AUDIO_L2RING)-1))*AUDIO_CHANNELS],j*AUDIO_BYTESTEP);
+	}
+	SDL_AtomicSet(&audio_ring_r,r); if (n) memcpy(z,t-AUDIO_BYTESTEP,AUDIO_BYTESTEP);
+	for (l-=n;l>0;--l) for (i=0;i<AUDIO_CHANNELS;++i) *((AUDIO_UNIT*)t)=z[i],t+=sizeof(AUDIO_UNIT); // repeat the last sample rather than clicking
+	(void)u;
+}
 void session_playme(void) // audio shortcut!
 {
 	static BYTE s=1; if (s!=!!audio_disabled) if (s=!s) MEMBYTE(audio_frame,AUDIO_ZERO); // mute mode cleanup!
-	int i=audio_session/((4-session_softplay)<<(AUDIO_L2BUFFER+AUDIO_BYTESTEP/2-(2)-3));
-	if (i<=8) // 0 void... 4 half... 8 full
+	static AUDIO_UNIT y[(AUDIO_RING_MAXHZ/50+AUDIO_RING_MAXHZ/1000)*AUDIO_CHANNELS],z[AUDIO_CHANNELS]={AUDIO_ZERO}; // resampled frame and its last sample
+	unsigned int w=SDL_AtomicGet(&audio_ring_w); int n=w-SDL_AtomicGet(&audio_ring_r),k; // `n` samples are waiting in the ring
+	int l=AUDIO_LENGTH_Z*audio_ring_hz/AUDIO_PLAYBACK; // the length of a frame at the rate of the device
+	audio_ring_f+=(n-audio_ring_f)/8; // the callback consumes the ring in bursts: the average is steadier than the current length
+	if (n<audio_ring_z/4) // nearly empty? (the beginning, or a long stall) pad the ring up to the target with the last sample
+		for (audio_ring_f=k=audio_ring_z-l/2;n<k;++n,++w)
+			for (int i=0;i<AUDIO_CHANNELS;++i) audio_ring[(w&((1<<AUDIO_L2RING)-1))*AUDIO_CHANNELS+i]=z[i];
+	if (n<=audio_ring_z*2+l) // skip the frame if the ring is overflowing, f.e. when the emulation runs at full speed
 	{
-		//session_timer+=i-4; // stronger: -4 -3 -2 -1 =0 +1 +2 +3 +4
-		if (i<3) session_timer+=i-3; else if (i>5) session_timer+=i-5; // average: -3 -2 -1 =0 =0 =0 +1 +2 +3
-		//session_timer+=(i-4)/2; // softer: -2 -1 -1 =0 =0 =0 +1 +1 +2
-		SDL_QueueAudio(session_audio,audio_frame,AUDIO_LENGTH_Z*AUDIO_BYTESTEP);
+		// the error is +65536 when the average doubles the target and -65536 when it's empty; the drift between the clocks of the
+		// emulation and the audio device slowly builds up in `audio_ring_i`, and the rate stays within 0.5% (328/65536) of the original
+		k=(audio_ring_f+l/2-audio_ring_z)*65536/audio_ring_z;
+		if ((audio_ring_i+=k/2048)>328*64) audio_ring_i=328*64; else if (audio_ring_i<-328*64) audio_ring_i=-328*64;
+		if ((k=(k*328>>16)+(audio_ring_i>>6))>328) k=328; else if (k<-328) k=-328;
+		if ((k=audio_resample(y,audio_frame,AUDIO_LENGTH_Z,k))>0) // a faster step yields fewer samples, a slower one yields more
+			MEMNCPY(z,&y[(k-1)*AUDIO_CHANNELS],AUDIO_CHANNELS);
+		for (AUDIO_UNIT *a=y;k>0;) // the frame may wrap around the end of the ring
+		{
+			int i=(1<<AUDIO_L2RING)-(w&((1<<AUDIO_L2RING)-1)); if (i>k) i=k;
+			MEMNCPY(&audio_ring[(w&((1<<AUDIO_L2RING)-1))*AUDIO_CHANNELS],a,i*AUDIO_CHANNELS); a+=i*AUDIO_CHANNELS,w+=i,n+=i,k-=i;
+		}
+		SDL_AtomicSet(&audio_ring_w,w);
 	}
-	audio_session=SDL_GetQueuedAudioSize(session_audio); // ensure that the first `audio_session` is zero
+	audio_session=(int)((long long)n*AUDIO_PLAYBACK/audio_ring_hz)*AUDIO_BYTESTEP; // the onscreen gauge expects bytes at AUDIO_PLAYBACK
 }
 char *session_blitinfo(void) { return session_hardblit?"SDL":"sdl"; }
 
@@ -1399,7 +1439,7 @@ INLINE char *session_create(char *s) // create video+audio devices and set menu;
 		!(video_blend=malloc(sizeof(VIDEO_UNIT[16+(VIDEO_PIXELS_Y>>!!VIDEO_HALFBLEND)*VIDEO_PIXELS_X])))
 		) return SDL_Quit(),(char*)SDL_GetError();
 
-	if (!session_softblit&&(session_blitter=SDL_CreateRenderer(session_hwnd,-1,0))) // ...SDL_CreateRenderer(session_hwnd,-1,SDL_RENDERER_SOFTWARE)
+	if (!session_softblit&&(session_blitter=SDL_CreateRenderer(session_hwnd,-1,session_vsync?SDL_RENDERER_PRESENTVSYNC:0))) // ...SDL_CreateRenderer(session_hwnd,-1,SDL_RENDERER_SOFTWARE)
 	{
 		session_hardblit=1;
 		SDL_SetRenderTarget(session_blitter,NULL); // necessary?
@@ -1518,11 +1558,22 @@ INLINE char *session_create(char *s) // create video+audio devices and set menu;
 	}
 	if (session_audio)
 	{
-		SDL_AudioSpec spec; SDL_zero(spec);
-		spec.freq=AUDIO_PLAYBACK; spec.channels=AUDIO_CHANNELS;
+		SDL_AudioSpec spec,have; SDL_zero(spec);
+		spec.freq=audio_rate?audio_rate:AUDIO_PLAYBACK; spec.channels=AUDIO_CHANNELS;
 		spec.format=AUDIO_BITDEPTH>8?AUDIO_S16SYS:AUDIO_U8;
-		//spec.samples=AUDIO_LENGTH_Z*1; // 0 = SDL2 default; users may try 1, 2, 3...
-		session_audio=SDL_OpenAudioDevice(NULL,0,&spec,NULL,0);
+		// the target latency is either explicit or a matter of the audio acceleration: 160, 80, 40 or 20 ms
+		int z=audio_latency?audio_latency:160>>session_softplay;
+		for (spec.samples=4096;spec.samples>256&&spec.samples*2000>z*spec.freq;) spec.samples>>=1; // the device's own buffer must be shorter
+		spec.callback=session_playback; SDL_AtomicSet(&audio_ring_r,0); SDL_AtomicSet(&audio_ring_w,0); SDL_AtomicSet(&audio_ring_lost,0);
+		// let the device keep its own rate: SDL's conversion would only stack a second resampler on ours, which must run anyway to follow the drift
+		if ((session_audio=SDL_OpenAudioDevice(NULL,0,&spec,&have,SDL_AUDIO_ALLOW_FREQUENCY_CHANGE))&&(have.freq<8000||have.freq>AUDIO_RING_MAXHZ))
+			SDL_CloseAudioDevice(session_audio),session_audio=SDL_OpenAudioDevice(NULL,0,&spec,&have,0);
+		if (session_audio)
+		{
+			audio_ring_z=z*(audio_ring_hz=have.freq)/1000;
+			if (audio_ring_z<have.samples*2) audio_ring_z=have.samples*2; // the device's own buffer must fit twice
+			audio_resample_setup(audio_ring_hz); cprintf("Audio device: %d Hz, %d samples\n",have.freq,have.samples);
+		}
 	}
 	session_clean(); session_please();
 	//session_timer=SDL_GetTicks();
@@ -1563,7 +1614,7 @@ INLINE void session_byebye(void) // delete video+audio devices
 	if (session_joy)
 		session_pad?SDL_GameControllerClose(session_joy):SDL_JoystickClose(session_joy);
 	if (session_audio)
-		SDL_ClearQueuedAudio(session_audio),SDL_CloseAudioDevice(session_audio);
+		SDL_CloseAudioDevice(session_audio);
 	SDL_StopTextInput();
 	if (session_hardblit)
 	{
@@ -1584,6 +1635,7 @@ INLINE void session_byebye(void) // delete video+audio devices
 	SDL_DestroyWindow(session_hwnd);
 	SDL_FreeSurface(session_ui_icon);
 	#endif
+	if (session_audio) cprintf("Audio device: %d underruns\n",SDL_AtomicGet(&audio_ring_lost));
 	SDL_Quit();
 	free(video_blend);
 }
@@ -1747,6 +1799,23 @@ int session_joy2k(void) // turn the joystick status into bits
 	{ return session_joybits; }
 int session_ticks(void) // get the `session_clock` tick count
 	{ return SDL_GetTicks(); } // stick to system clock; unlike Win32, the audio clock is unreliable in SDL2 :-(
+long long session_uticks(void) // get the monotonic high resolution clock in microseconds
+{
+	static Uint64 f=0; if (!f) f=SDL_GetPerformanceFrequency();
+	Uint64 t=SDL_GetPerformanceCounter(); return (long long)(t/f)*1000000+(long long)(t%f)*1000000/f; // avoid overflows
+}
+
+// background threads: a thread launcher and counting semaphores
+#define SESSION_THREAD(f) int SDLCALL f(void *session_thread_data) // 0 OK
+typedef SDL_Thread *SESSION_THREADID; typedef SDL_sem *SESSION_SEMAPHORE;
+#define session_threadmake(t,f,p) (!(t=SDL_CreateThread(f,"",(p)))) // 0 OK, !0 ERROR
+#define session_cores() SDL_GetCPUCount()
+#define session_threadwait(t) SDL_WaitThread(t,NULL)
+#define session_semaphoremake(s,n) (!(s=SDL_CreateSemaphore(n))) // 0 OK, !0 ERROR
+#define session_semaphorefree(s) SDL_DestroySemaphore(s)
+#define session_semaphorewait(s) SDL_SemWait(s)
+#define session_semaphoretest(s) SDL_SemTryWait(s) // 0 OK, !0 BUSY
+#define session_semaphorepost(s) SDL_SemPost(s)
 
 // menu item functions ---------------------------------------------- //
 
@@ -29,7 +29,7 @@
 #define WIN32_LEAN_AND_MEAN 1 // reduce dependencies!
 #endif
 #else
-#ifndef SDL2
+#if !defined(SDL2)&&!defined(HEADLESS)
 #define SDL2 // SDL2 is required in non-Win32 systems
 #endif
 #endif
@@ -77,6 +77,8 @@ int video_pos_z=0; // frame counter for timekeeping, statistics and debugging
 char video_interlaced=0,video_interlaces=0; // video scanline field (odd or even)
 char video_framelimit=0,video_framecount=0; // video frameskip counters: 0 = 100%, 1 = 50%, 2 = 33%...
 char audio_disabled=0,audio_required=0,video_required=0; int audio_session=0; // audio/video status and audio buffer
+int audio_latency=0; // target audio latency in milliseconds; zero lets the audio acceleration choose (SDL2 only)
+int audio_rate=0; // rate of the sound device in Hz; zero requests AUDIO_PLAYBACK, but the device may choose its own (SDL2 only)
 // "disabled" and "required" are independent because audio recording on wave and film files must happen even if the emulator is mute or sped-up
 #ifndef audio_fastmute
 #define audio_fastmute 1 // is there any reason to play sound back at full speed? :-(
@@ -86,6 +88,8 @@ char audio_disabled=0,audio_required=0,video_required=0; int audio_session=0; //
 #define SESSION_SIGNAL_DEBUG 2
 #define SESSION_SIGNAL_PAUSE 4
 int session_timer,session_event=0; // timing synchronisation and user command
+long long session_utimer; // the same timer in microseconds; `session_timer` follows it in `session_clock` units
+char session_vsync=0; // present the frames on the vertical retrace (SDL2 only)
 char session_fast=0,session_rhythm=0,session_wait=0,session_softblit=1,session_hardblit,session_softplay=0; // software blitting enabled by default
 char session_audio=1,session_stick=1,session_shift=0,session_key2joy=0; // keyboard and joystick
 int session_maus_x=0,session_maus_y=0; // mouse coordinates (debugger + SDL2 UI + optional emulation)
@@ -99,8 +103,10 @@ char session_dirty=0,debug_dirty=0; // cfr. session_clean()
 
 #define session_getscanline(i) (&video_frame[i*VIDEO_LENGTH_X+VIDEO_OFFSET_X]) // pointer to scanline `i`
 FILE *session_wavefile=NULL,*session_filmfile=NULL; // audio + video recording is done on each done frame
+FILE *session_streamv=NULL,*session_streama=NULL; // raw video and audio streams, only in headless sessions
 void session_writewave(void); // save the current sample frame. Must be defined later on!
-void session_writefilm(void); int session_closefilm(void); // must be defined later on, too!
+void session_writestream(void); // ditto, send the current frame to the raw streams
+void session_writefilm(void); int session_closefilm(void); char *session_filminfo(void); // must be defined later on, too!
 #ifndef VIDEO_PLAYBACK // variable mode?
 int AUDIO_LENGTH_Z; char VIDEO_PLAYBACK=0;
 int session_ntsc(int q) // sets NTSC (60 Hz) mode if `q` is nonzero, sets PAL (50 Hz) mode instead; returns `q`
@@ -132,7 +138,9 @@ void session_debug_show(void); // redraw the debugger text, reloading it if requ
 int session_debug_user(int); // debug logic takes priority: 0 UNKNOWN COMMAND, !0 OK
 int debug_xlat(int); // translate debug keys into codes (f.e. cursors)
 
-#ifdef SDL2 // optional inside Win32, required elsewhere!
+#ifdef HEADLESS // no window, no audio, no user interface
+#include "cpcec-on.h"
+#elif defined(SDL2) // optional inside Win32, required elsewhere!
 #include "cpcec-ox.h"
 #else // Win32 (+4.0)
 #include "cpcec-os.h"
@@ -513,7 +521,7 @@ int lzf2bin(BYTE *t,int o,const BYTE *s,int i) // decode up to `i` bytes from so
 #endif
 
 #ifdef SHA1_CALCULATOR
-// extremely suboptimal SHA-1 calculator:
+// compact SHA-1 calculator:
 // 1.- sha1_init() resets all internal vars before a fresh start;
 // 2.- sha1_hash(s) processes a 64-byte page `s` from the stream;
 // 3.- sha1_exit(s,0..63) processes the last bytes in the stream,
@@ -523,38 +531,34 @@ int lzf2bin(BYTE *t,int o,const BYTE *s,int i) // decode up to `i` bytes from so
 unsigned int sha1_o[5]; long long int sha1_i;
 void sha1_init(void)
 	{ sha1_o[0]=0x67452301,sha1_o[1]=0xEFCDAB89,sha1_o[2]=0x98BADCFE,sha1_o[3]=0x10325476,sha1_o[4]=0xC3D2E1F0; sha1_i=0; }
+// the 80 rounds are unrolled in groups of five that rotate the variables instead of moving them,
+// and the message schedule is a window of 16 words that each round from 16 onwards overwrites.
+#define SHA1_ROL(x,n) (((x)<<(n))|((x)>>(32-(n))))
+#define SHA1_W(i) ((i)<16?z[i]:(z[(i)&15]=SHA1_ROL(z[((i)+13)&15]^z[((i)+8)&15]^z[((i)+2)&15]^z[(i)&15],1)))
+#define SHA1_F0(b,c,d) (((c^d)&b)^d)
+#define SHA1_F1(b,c,d) (b^c^d)
+#define SHA1_F2(b,c,d) (((b|c)&d)|(b&c))
+#define SHA1_R1(f,k,i,a,b,c,d,e) (e+=SHA1_ROL(a,5)+f(b,c,d)+k+SHA1_W(i),b=SHA1_ROL(b,30))
+#define SHA1_R5(f,k,i) (SHA1_R1(f,k,i+0,a,b,c,d,e),SHA1_R1(f,k,i+1,e,a,b,c,d),SHA1_R1(f,k,i+2,d,e,a,b,c),\
+	SHA1_R1(f,k,i+3,c,d,e,a,b),SHA1_R1(f,k,i+4,b,c,d,e,a))
 void sha1_hash(const BYTE *s)
 {
-	static unsigned int z[80]; // don't abuse the poor stack! we don't have to allocate and release this buffer again and again!
-	unsigned int a=sha1_o[0]&0XFFFFFFFF,b=sha1_o[1]&0XFFFFFFFF,c=sha1_o[2]&0XFFFFFFFF,d=sha1_o[3]&0XFFFFFFFF,e=sha1_o[4]&0XFFFFFFFF,f,i=0;
-	for (;i<16;++i) // first 16 fields
-		z[i]=s[i*4+0]<<24|s[i*4+1]<<16|s[i*4+2]<<8|s[i*4+3];
-	for (;i<80;++i) // up to 80 fields
-		f=(z[i-3]^z[i-8]^z[i-14]^z[i-16])&0XFFFFFFFF,z[i]=((f<<1)&0XFFFFFFFF)|f>>31;
-	for (i=0;i<80;++i)
-	{
-		if (i<40)
-			if (i<20)
-				f=   (((c^d)&b)^d)   +0X5A827999;
-			else
-				f=      (b^c^d)      +0X6ED9EBA1;
-		else
-			if (i<60)
-				f=((b&c)^(b&d)^(c&d))+0X8F1BBCDC;
-			else
-				f=      (b^c^d)      +0XCA62C1D6;
-		f+=(a<<5)+(a>>27)+e+z[i]; e=d; d=c;
-		c=(b<<30)+(b>>2); b=a; a=f&0XFFFFFFFF;
-	}
-	sha1_i+=512,sha1_o[0]+=a,sha1_o[1]+=b,sha1_o[2]+=c,sha1_o[3]+=d,sha1_o[4]+=e;
+	DWORD z[16],a=sha1_o[0],b=sha1_o[1],c=sha1_o[2],d=sha1_o[3],e=sha1_o[4];
+	for (int i=0;i<16;++i) z[i]=(DWORD)mgetmmmm(&s[i*4]);
+	SHA1_R5(SHA1_F0,0X5A827999, 0),SHA1_R5(SHA1_F0,0X5A827999, 5),SHA1_R5(SHA1_F0,0X5A827999,10),SHA1_R5(SHA1_F0,0X5A827999,15);
+	SHA1_R5(SHA1_F1,0X6ED9EBA1,20),SHA1_R5(SHA1_F1,0X6ED9EBA1,25),SHA1_R5(SHA1_F1,0X6ED9EBA1,30),SHA1_R5(SHA1_F1,0X6ED9EBA1,35);
+	SHA1_R5(SHA1_F2,0X8F1BBCDC,40),SHA1_R5(SHA1_F2,0X8F1BBCDC,45),SHA1_R5(SHA1_F2,0X8F1BBCDC,50),SHA1_R5(SHA1_F2,0X8F1BBCDC,55);
+	SHA1_R5(SHA1_F1,0XCA62C1D6,60),SHA1_R5(SHA1_F1,0XCA62C1D6,65),SHA1_R5(SHA1_F1,0XCA62C1D6,70),SHA1_R5(SHA1_F1,0XCA62C1D6,75);
+	sha1_i+=512,sha1_o[0]=(sha1_o[0]+a)&0XFFFFFFFF,sha1_o[1]=(sha1_o[1]+b)&0XFFFFFFFF,
+	sha1_o[2]=(sha1_o[2]+c)&0XFFFFFFFF,sha1_o[3]=(sha1_o[3]+d)&0XFFFFFFFF,sha1_o[4]=(sha1_o[4]+e)&0XFFFFFFFF;
 }
 void sha1_exit(const BYTE *s,int n)
 {
-	static BYTE t[64]; sha1_i+=n<<3; memcpy(t,s,n); t[n++]=128;
-	if (n>=56) { while (n<64) t[n++]=0; sha1_hash(t); n=0; }
+	static BYTE t[64]; long long int i=sha1_i+=n<<3; memcpy(t,s,n); t[n++]=128; // the padding block must not count!
+	if (n>56) { while (n<64) t[n++]=0; sha1_hash(t); n=0; }
 	while (n<56) t[n++]=0;
-	t[n++]=sha1_i>>56; t[n++]=sha1_i>>48; t[n++]=sha1_i>>40; t[n++]=sha1_i>>32;
-	t[n++]=sha1_i>>24; t[n++]=sha1_i>>16; t[n++]=sha1_i>> 8; t[n++]=sha1_i    ;
+	t[n++]=i>>56; t[n++]=i>>48; t[n++]=i>>40; t[n++]=i>>32;
+	t[n++]=i>>24; t[n++]=i>>16; t[n++]=i>> 8; t[n++]=i    ;
 	sha1_hash(t);
 	sha1_o[0]&=0XFFFFFFFF,sha1_o[1]&=0XFFFFFFFF,sha1_o[2]&=0XFFFFFFFF,sha1_o[3]&=0XFFFFFFFF,sha1_o[4]&=0XFFFFFFFF;
 }
@@ -646,6 +650,23 @@ void video_praecalc(void) // build the precalc'd video filter tables
 #define VIDEO_FILTER_SRGB(x,y) (video_srgb[((x>>8)&0XFF00)|(y>>16)]<<16)|(video_srgb[(x&0XFF00)|((y>>8)&255)]<<8)|video_srgb[((x&255)<<8)|(y&255)] // old-new avg.
 #define VIDEO_FILTER_HALF(x,y) (x==y?x:VIDEO_FILTER_SRGB(x,y))
 
+// the filters are table lookups that SIMD can't gather, but most pixels come in runs of the same colour, and SIMD can
+// spot them: the loops below walk the scanlines in blocks of 4 pixels, skipping the blocks that blending won't change
+// and filling the flat blocks with one lookup. `-DVIDEO_FILTER_SCALAR` leaves the original pixel-by-pixel loops alone.
+#ifndef VIDEO_FILTER_SCALAR
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VIDEO_FILTER_SAME4(x,y) (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((__m128i const*)(x)),_mm_loadu_si128((__m128i const*)(y))))==0XFFFF) // x[0..3]==y[0..3]
+#define VIDEO_FILTER_FLAT4(x) (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((__m128i const*)(x)),_mm_set1_epi32(*(x))))==0XFFFF) // x[0]==x[1..3]
+#define VIDEO_FILTER_FILL4(x,a,b) _mm_storeu_si128((__m128i*)(x),_mm_set_epi32(b,a,b,a)) // x[0..3]=a,b,a,b
+#endif
+#endif
+#ifdef VIDEO_FILTER_SAME4
+#define VIDEO_FILTER_RUN4(c,x) for (vk=vi;vk<vl;) if (vk+=4,c) x,vi+=4; else // the loop that follows must stop at `vk`
+#else
+#define VIDEO_FILTER_RUN4(c,x) for (vk=vl;vk;vk=NULL) // a single pass, pixel by pixel
+#endif
+
 #ifdef VIDEO_LO_X_RES
 // 4-pixel lo-res blur: ABBC,BBCC,BCCD,CCDD...
 #define VIDEO_FILTER_BLURDATA VIDEO_UNIT v2z,v1z,v0z
@@ -673,7 +694,10 @@ void video_resetscanline(void) // reset configuration values on new video option
 // do not manually unroll the following operations, GCC is smart enough to do a better job on its own!
 void video_callscanline(VIDEO_UNIT *vl)
 {
-	VIDEO_UNIT *vi=vl-VIDEO_PIXELS_X,vt; if (frame_scanline<2) // all scanlines + avg. scanlines in final line
+	#ifdef VIDEO_FILTER_SAME4
+	VIDEO_UNIT vs; // the flat blocks need two colours
+	#endif
+	VIDEO_UNIT *vi=vl-VIDEO_PIXELS_X,*vk,vt; if (frame_scanline<2) // all scanlines + avg. scanlines in final line
 	{
 		VIDEO_UNIT *vo=vi+VIDEO_LENGTH_X;
 		switch (video_filterz&(VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Y))
@@ -682,21 +706,24 @@ void video_callscanline(VIDEO_UNIT *vl)
 				MEMNCPY(vo,vi,VIDEO_PIXELS_X);
 				break;
 			case VIDEO_FILTER_MASK_Y:
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_FLAT4(vi),(vt=VIDEO_FILTER_DOT0(*vi),VIDEO_FILTER_FILL4(vo,vt,vt),vo+=4))
 				do
 					*vo=VIDEO_FILTER_DOT0(*vi);
-				while (++vo,++vi<vl);
+				while (++vo,++vi<vk);
 				break;
 			case VIDEO_FILTER_MASK_X:
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_FLAT4(vi),(vt=VIDEO_FILTER_DOT1(*vi),vs=VIDEO_FILTER_DOT2(*vi),VIDEO_FILTER_FILL4(vi,vt,vs),VIDEO_FILTER_FILL4(vo,vt,vs),vo+=4))
 				do
 					vt=*vi,*vo=*vi=VIDEO_FILTER_DOT1(vt),++vo,++vi,
 					vt=*vi,*vo=*vi=VIDEO_FILTER_DOT2(vt);
-				while (++vo,++vi<vl);
+				while (++vo,++vi<vk);
 				break;
 			case VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Y:
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_FLAT4(vi),(vt=*vi,VIDEO_FILTER_FILL4(vo,VIDEO_FILTER_DOT3(vt),VIDEO_FILTER_DOT4(vt)),vs=VIDEO_FILTER_DOT2(vt),vt=VIDEO_FILTER_DOT1(vt),VIDEO_FILTER_FILL4(vi,vt,vs),vo+=4))
 				do
 					vt=*vi,*vi=VIDEO_FILTER_DOT1(vt),*vo=VIDEO_FILTER_DOT3(vt),++vo,++vi,
 					vt=*vi,*vi=VIDEO_FILTER_DOT2(vt),*vo=VIDEO_FILTER_DOT4(vt);
-				while (++vo,++vi<vl);
+				while (++vo,++vi<vk);
 				break;
 		}
 	}
@@ -704,29 +731,32 @@ void video_callscanline(VIDEO_UNIT *vl)
 	{
 		// half/single/double scanlines: bottom lines add VIDEO_FILTER_MASK_Z
 		case VIDEO_FILTER_MASK_Y+VIDEO_FILTER_MASK_Z:
+			VIDEO_FILTER_RUN4(VIDEO_FILTER_FLAT4(vi),(vt=VIDEO_FILTER_DOT0(*vi),VIDEO_FILTER_FILL4(vi,vt,vt)))
 			do
 				*vi=VIDEO_FILTER_DOT0(*vi);
-			while (++vi<vl);
+			while (++vi<vk);
 			break;
 		case VIDEO_FILTER_MASK_X:
 		case VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Z:
 		case VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Y:
+			VIDEO_FILTER_RUN4(VIDEO_FILTER_FLAT4(vi),(vt=VIDEO_FILTER_DOT1(*vi),vs=VIDEO_FILTER_DOT2(*vi),VIDEO_FILTER_FILL4(vi,vt,vs)))
 			do
 				*vi=VIDEO_FILTER_DOT1(*vi),++vi,
 				*vi=VIDEO_FILTER_DOT2(*vi);
-			while (++vi<vl);
+			while (++vi<vk);
 			break;
 		case VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Y+VIDEO_FILTER_MASK_Z:
+			VIDEO_FILTER_RUN4(VIDEO_FILTER_FLAT4(vi),(vt=VIDEO_FILTER_DOT3(*vi),vs=VIDEO_FILTER_DOT4(*vi),VIDEO_FILTER_FILL4(vi,vt,vs)))
 			do
 				*vi=VIDEO_FILTER_DOT3(*vi),++vi,
 				*vi=VIDEO_FILTER_DOT4(*vi);
-			while (++vi<vl);
+			while (++vi<vk);
 			break;
 	}
 }
 INLINE void video_drawscanline(void) // call after each drawn scanline; memory caching makes this more convenient than gathering all operations in video_endscanlines()
 {
-	VIDEO_UNIT vt,vs,*vi=video_target-video_pos_x+VIDEO_OFFSET_X,*vl=vi+VIDEO_PIXELS_X,*vo;
+	VIDEO_UNIT vt,vs,*vi=video_target-video_pos_x+VIDEO_OFFSET_X,*vl=vi+VIDEO_PIXELS_X,*vo,*vk;
 	#ifdef MAUS_LIGHTGUNS
 	if (!(((session_maus_y+VIDEO_OFFSET_Y)^video_pos_y)&-2)) // does the lightgun aim at the current scanline?
 		video_litegun=session_maus_x>=0&&session_maus_x<VIDEO_PIXELS_X?vi[session_maus_x]|vi[session_maus_x^1]:0; // keep the colours BEFORE any filtering happens!
@@ -750,9 +780,10 @@ INLINE void video_drawscanline(void) // call after each drawn scanline; memory c
 			#ifndef VIDEO_LO_X_RES
 			BYTE vq=vx[-1]==vp?vp:(vp=2);
 			if (vq&2)
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) *vo=vs,*vi=VIDEO_FILTER_SRGB(vs,vt);
-				while (++vo,++vi<vl); // read hi-res pixels
+				while (++vo,++vi<vk); // read hi-res pixels
 			else
 			{
 				if (vq) // 1st pixel?
@@ -760,15 +791,17 @@ INLINE void video_drawscanline(void) // call after each drawn scanline; memory c
 					if ((vt=*vo)!=(vs=*vi)) *vo=vs,*vi=VIDEO_FILTER_SRGB(vs,vt);
 					++vo,++vi; // 1st pixel
 				}
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) vo[1]=*vo=vs,vi[1]=*vi=VIDEO_FILTER_SRGB(vs,vt);
-				while (vo+=2,(vi+=2)<vl); // skip lo-res pixels
+				while (vo+=2,(vi+=2)<vk); // skip lo-res pixels
 			}
 			#else
 			{
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) vo[1]=*vo=vs,vi[1]=*vi=VIDEO_FILTER_SRGB(vs,vt);
-				while (vo+=2,(vi+=2)<vl); // skip lo-res pixels
+				while (vo+=2,(vi+=2)<vk); // skip lo-res pixels
 			}
 			#endif
 			#endif
@@ -792,9 +825,10 @@ INLINE void video_drawscanline(void) // call after each drawn scanline; memory c
 		{
 			#ifndef VIDEO_LO_X_RES
 			if (vq&2)
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) *vo=*vi=VIDEO_FILTER_SRGB(vs,vt); // accumulative
-				while (++vo,++vi<vl); // read hi-res pixels
+				while (++vo,++vi<vk); // read hi-res pixels
 			else
 			{
 				if (vq) // 1st pixel?
@@ -802,15 +836,17 @@ INLINE void video_drawscanline(void) // call after each drawn scanline; memory c
 					if ((vt=*vo)!=(vs=*vi)) *vo=*vi=VIDEO_FILTER_SRGB(vs,vt); // accumulative
 					++vo,++vi; // 1st pixel
 				}
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) vo[1]=*vo=vi[1]=*vi=VIDEO_FILTER_SRGB(vs,vt); // accumulative
-				while (vo+=2,(vi+=2)<vl); // skip lo-res pixels
+				while (vo+=2,(vi+=2)<vk); // skip lo-res pixels
 			}
 			#else
 			{
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) vo[1]=*vo=vi[1]=*vi=VIDEO_FILTER_SRGB(vs,vt); // accumulative
-				while (vo+=2,(vi+=2)<vl); // skip lo-res pixels
+				while (vo+=2,(vi+=2)<vk); // skip lo-res pixels
 			}
 			#endif
 		}
@@ -818,9 +854,10 @@ INLINE void video_drawscanline(void) // call after each drawn scanline; memory c
 		{
 			#ifndef VIDEO_LO_X_RES // do all pixels in hi-res!
 			if (vq&2)
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) *vo=vs,*vi=VIDEO_FILTER_SRGB(vs,vt); // simple
-				while (++vo,++vi<vl); // read hi-res pixels
+				while (++vo,++vi<vk); // read hi-res pixels
 			else
 			{
 				if (vq) // 1st pixel?
@@ -828,15 +865,17 @@ INLINE void video_drawscanline(void) // call after each drawn scanline; memory c
 					if ((vt=*vo)!=(vs=*vi)) *vo=vs,*vi=VIDEO_FILTER_SRGB(vs,vt); // simple
 					++vo,++vi; // 1st pixel
 				}
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) vo[1]=*vo=vs,vi[1]=*vi=VIDEO_FILTER_SRGB(vs,vt); // simple
-				while (vo+=2,(vi+=2)<vl); // skip lo-res pixels
+				while (vo+=2,(vi+=2)<vk); // skip lo-res pixels
 			}
 			#else
 			{
+				VIDEO_FILTER_RUN4(VIDEO_FILTER_SAME4(vo,vi),vo+=4)
 				do
 					if ((vt=*vo)!=(vs=*vi)) vo[1]=*vo=vs,vi[1]=*vi=VIDEO_FILTER_SRGB(vs,vt); // simple
-				while (vo+=2,(vi+=2)<vl); // skip lo-res pixels
+				while (vo+=2,(vi+=2)<vk); // skip lo-res pixels
 			}
 			#endif
 		}
@@ -963,15 +1002,16 @@ INLINE void video_endscanlines(void) // call after each drawn frame: end the cur
 	VIDEO_UNIT *vl=video_frame+VIDEO_OFFSET_X+(VIDEO_OFFSET_Y+VIDEO_PIXELS_Y-2+(video_pos_y&1))*VIDEO_LENGTH_X+VIDEO_PIXELS_X;
 	video_callscanline(vl); // also used in video_drawscanline()
 }
+INLINE void video_setfilterz(void) // turn `video_filter` into the filter flags of the next frame
+{
+	BYTE b=video_finemicro&&(video_filter&(VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Z))==VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Z;
+	video_filterz=b?video_filter&~VIDEO_FILTER_MASK_Z:video_filter; // detect the special case MASK_X && MASK_Z && FINEMICRO!
+	if (video_praecalc_flag!=b) video_praecalc_flag=b,video_praecalc(); // recalc this as seldom as possible!
+}
 INLINE void video_newscanlines(int x,int y) // call before each new frame: reset `video_target`, `video_pos_x` and `video_pos_y`
 {
 	if (!video_framecount) // finish old frame if needed!
-	{
-		BYTE b=video_finemicro&&(video_filter&(VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Z))==VIDEO_FILTER_MASK_X+VIDEO_FILTER_MASK_Z;
-		video_filterz=b?video_filter&~VIDEO_FILTER_MASK_Z:video_filter; // detect the special case MASK_X && MASK_Z && FINEMICRO!
-		if (video_praecalc_flag!=b) video_praecalc_flag=b,video_praecalc(); // recalc this as seldom as possible!
-		video_endscanlines();
-	}
+		video_setfilterz(),video_endscanlines();
 	++video_pos_z; session_signal|=SESSION_SIGNAL_FRAME+session_signal_frames; // frame event!
 	#ifdef MAUS_LIGHTGUNS
 	video_litegun=0; // the lightgun signal fades away between frames
@@ -981,6 +1021,134 @@ INLINE void video_newscanlines(int x,int y) // call before each new frame: reset
 	video_target=video_frame+(video_pos_y=y)*VIDEO_LENGTH_X+(video_pos_x=x); // new coordinates
 }
 
+// polyphase resampler: the sound chips always render at AUDIO_PLAYBACK, but the sound device may run at its own rate (48000, 96000...)
+// so every output sample is the dot product of 32 input samples and one of 1024 phases of a windowed sinc. The coefficients are 16-bit
+// fixed point numbers (32768 = 1.0) and the sums stay within 32 bits, so the SIMD dot products below are exactly the same as the scalar.
+// The history keeps the samples as signed 16-bit values around zero whatever AUDIO_BITDEPTH and AUDIO_ZERO are, so 8-bit audio works too.
+// The Win32 backend plays at AUDIO_PLAYBACK thru waveOut, so only SDL2 (and the headless benchmark) need the resampler at all.
+#if defined(SDL2) || defined(HEADLESS)
+#define AUDIO_RESAMPLE_TAPS 32 // input samples per output sample
+#define AUDIO_RESAMPLE_L2PHASES 10 // 1024 phases between two input samples
+#define AUDIO_RESAMPLE_SHIFT (16-AUDIO_BITDEPTH) // 8-bit samples are scaled up to keep the precision of the sums
+#define AUDIO_RESAMPLE_LIMIT (1<<(AUDIO_BITDEPTH-1)) // the output must stay within AUDIO_ZERO-LIMIT and AUDIO_ZERO+LIMIT-1
+short audio_resample_k[1<<AUDIO_RESAMPLE_L2PHASES][AUDIO_RESAMPLE_TAPS]; // the windowed sinc, phase by phase
+short audio_resample_x[AUDIO_CHANNELS][AUDIO_RESAMPLE_TAPS-1+AUDIO_PLAYBACK/50]; // the tail of the last frame, then the current frame
+int audio_resample_p,audio_resample_d; // position in `audio_resample_x` and step per output sample, both in 16.16 fixed point
+#ifndef AUDIO_RESAMPLE_SCALAR
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_RESAMPLE_DOT(a,x,k) do{ __m128i m=_mm_setzero_si128(); for (int q=0;q<AUDIO_RESAMPLE_TAPS;q+=8) m=_mm_add_epi32(m,_mm_madd_epi16( \
+	_mm_loadu_si128((__m128i const*)&(x)[q]),_mm_loadu_si128((__m128i const*)&(k)[q]))); m=_mm_add_epi32(m,_mm_shuffle_epi32(m,0X4E)); \
+	a=_mm_cvtsi128_si32(_mm_add_epi32(m,_mm_shuffle_epi32(m,0XB1))); }while(0)
+#endif
+#endif
+#ifdef AUDIO_RESAMPLE_DOT
+char audio_resample_fast=1; // the SIMD dot product can be disabled to compare it with the scalar one
+#endif
+void audio_resample_setup(int r) // prepare the conversion from AUDIO_PLAYBACK to `r` Hz and clear the history
+{
+	double c=(r<AUDIO_PLAYBACK?r:AUDIO_PLAYBACK)*.9/AUDIO_PLAYBACK; // the cutoff lies a bit below the lower of both Nyquist frequencies
+	for (int p=0;p<(1<<AUDIO_RESAMPLE_L2PHASES);++p)
+	{
+		double k[AUDIO_RESAMPLE_TAPS],s=0; int i,j=0,z=32768;
+		for (i=0;i<AUDIO_RESAMPLE_TAPS;++i) // the sinc is centered on the phase, the Blackman window spans all the taps
+		{
+			double x=i+1-AUDIO_RESAMPLE_TAPS/2-(double)p/(1<<AUDIO_RESAMPLE_L2PHASES),y=(x/AUDIO_RESAMPLE_TAPS+.5)*2*M_PI;
+			s+=k[i]=(x?SDL_sin(x*c*M_PI)/(x*M_PI):c)*(.42+.5*SDL_sin(y-M_PI/2)+.08*SDL_sin(y*2+M_PI/2)); if (k[i]>k[j]) j=i;
+		}
+		for (i=0;i<AUDIO_RESAMPLE_TAPS;++i) z-=audio_resample_k[p][i]=(int)(k[i]*32768/s+32768.5)-32768; // unity gain...
+		audio_resample_k[p][j]+=z; // ...even after rounding
+	}
+	audio_resample_d=(int)(((long long)AUDIO_PLAYBACK<<16)/r),audio_resample_p=(AUDIO_RESAMPLE_TAPS/2-1)<<16;
+	MEMZERO(audio_resample_x);
+}
+int audio_resample(AUDIO_UNIT *t,AUDIO_UNIT *s,int n,int k) // resample `n` samples from `s` into `t`, with the step nudged by `k` (65536 = 100%); returns the output samples
+{
+	int i,o=0,d=audio_resample_d+(int)(((long long)audio_resample_d*k)>>16);
+	for (i=0;i<n;++i) for (int c=0;c<AUDIO_CHANNELS;++c) audio_resample_x[c][AUDIO_RESAMPLE_TAPS-1+i]=(*s++-AUDIO_ZERO)*(1<<AUDIO_RESAMPLE_SHIFT);
+	for (;(i=audio_resample_p>>16)<n+AUDIO_RESAMPLE_TAPS/2-1;audio_resample_p+=d,++o) // the last taps must fit in the current frame
+	{
+		short *kk=audio_resample_k[(audio_resample_p&65535)>>(16-AUDIO_RESAMPLE_L2PHASES)];
+		for (int c=0;c<AUDIO_CHANNELS;++c)
+		{
+			short *xx=&audio_resample_x[c][i+1-AUDIO_RESAMPLE_TAPS/2]; int a;
+			#ifdef AUDIO_RESAMPLE_DOT
+			if (audio_resample_fast) AUDIO_RESAMPLE_DOT(a,xx,kk); else
+			#endif
+			{ a=0; for (int q=0;q<AUDIO_RESAMPLE_TAPS;++q) a+=xx[q]*kk[q]; }
+			a=(a+(16384<<AUDIO_RESAMPLE_SHIFT))>>(15+AUDIO_RESAMPLE_SHIFT); // the sinc can ring beyond the limits
+			*t++=(a>=AUDIO_RESAMPLE_LIMIT?AUDIO_RESAMPLE_LIMIT-1:a<-AUDIO_RESAMPLE_LIMIT?-AUDIO_RESAMPLE_LIMIT:a)+AUDIO_ZERO;
+		}
+	}
+	audio_resample_p-=n<<16;
+	for (int c=0;c<AUDIO_CHANNELS;++c) memmove(audio_resample_x[c],&audio_resample_x[c][n],sizeof(short[AUDIO_RESAMPLE_TAPS-1]));
+	return o;
+}
+#endif
+
+#ifdef HEADLESS
+void video_benchscanlines(void) // `-bb` runs the last frame thru every combination of `video_filter` and line/page blending
+{
+	VIDEO_UNIT *vv; if (!video_pos_z||!(vv=malloc(sizeof(VIDEO_UNIT[VIDEO_LENGTH_X*VIDEO_LENGTH_Y])))) return;
+	MEMNCPY(vv,video_frame,VIDEO_LENGTH_X*VIDEO_LENGTH_Y);
+	BYTE f=video_filter,l=video_lineblend,p=video_pageblend,s=video_scanline; int x=video_pos_x,y=video_pos_y;
+	for (int i=0;i<32;++i)
+	{
+		video_filter=i&7,video_lineblend=(i>>3)&1,video_pageblend=i>>4,
+		frame_scanline=video_scanline=0,video_resetscanline(),video_setfilterz();
+		int t,n=0,tt=session_ticks();
+		do // repeat the whole frame as many times as we can in a tenth of second
+		{
+			MEMNCPY(video_frame,vv,VIDEO_LENGTH_X*VIDEO_LENGTH_Y);
+			for (video_pos_y=VIDEO_OFFSET_Y;video_pos_y<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;video_pos_y+=2)
+				video_target=video_frame+video_pos_y*VIDEO_LENGTH_X+(video_pos_x=VIDEO_OFFSET_X+VIDEO_PIXELS_X),video_drawscanline();
+			video_endscanlines();
+		}
+		while (++n,(t=session_ticks()-tt)<100);
+		fprintf(stderr,"#%d: filter %d%s%s, %d.%03d ms/frame\n",session_instance,i&7,i&8?" + lineblend":"",i&16?" + pageblend":"",t/n,t*1000/n%1000);
+	}
+	video_filter=f,video_lineblend=l,video_pageblend=p,frame_scanline=video_scanline=s,video_pos_x=x,video_pos_y=y;
+	video_target=video_frame+y*VIDEO_LENGTH_X+x,video_setfilterz(),video_resetscanline();
+	MEMNCPY(video_frame,vv,VIDEO_LENGTH_X*VIDEO_LENGTH_Y); free(vv);
+}
+void audio_main(int t); // see the emulators
+void audio_benchmark(char *s) // render the sound of the last frame as many times as it can in a tenth of second; `s` names the setup
+{
+	AUDIO_UNIT *a=audio_target; int z=audio_pos_z,t,n=0,tt=session_ticks(); if (!video_pos_z) return;
+	do // the sound chips keep the state of the last frame: the tones and the noise play on, the registers don't change
+		for (audio_target=audio_frame,audio_pos_z=0;audio_pos_z<AUDIO_LENGTH_Z;) audio_main(1<<12);
+	while (++n,(t=session_ticks()-tt)<100);
+	fprintf(stderr,"#%d: audio%s %d samples/frame, %d.%03d ms/frame, %d ksamples/s\n",session_instance,
+		s,AUDIO_LENGTH_Z,t/n,t*1000/n%1000,(int)((long long)AUDIO_LENGTH_Z*n/t));
+	audio_target=a,audio_pos_z=z;
+}
+#ifndef AUDIO_BENCHMAIN // machines with several sound setups can define it and compare them in their own `audio_benchmain`
+void audio_benchmain(void) { audio_benchmark(""); } // `-bb` also measures the speed of the sound chips
+#endif
+void audio_benchresample(void) // convert the last frame to several device rates as many times as it can in a tenth of second
+{
+	static const int rr[]={22050,48000,96000}; static AUDIO_UNIT y[192000/50*AUDIO_CHANNELS*2]; if (!video_pos_z) return;
+	for (int r=0;r<(int)length(rr);++r)
+		#ifdef AUDIO_RESAMPLE_DOT
+		for (audio_resample_fast=0;audio_resample_fast<2;++audio_resample_fast)
+		#endif
+		{
+			int t,n=0,o=0,tt=session_ticks(); audio_resample_setup(rr[r]);
+			do o+=audio_resample(y,audio_frame,AUDIO_LENGTH_Z,0); while (++n,(t=session_ticks()-tt)<100);
+			fprintf(stderr,"#%d: resample %d to %d Hz%s, %d.%03d ms/frame, %d ksamples/s\n",session_instance,AUDIO_PLAYBACK,rr[r],
+				#ifdef AUDIO_RESAMPLE_DOT
+				audio_resample_fast?" SIMD":" scalar",
+				#else
+				"",
+				#endif
+				t/n,t*1000/n%1000,(int)((long long)o/t));
+		}
+	#ifdef AUDIO_RESAMPLE_DOT
+	audio_resample_fast=1;
+	#endif
+}
+#endif
+
 INLINE void audio_playframe(void) // filter the audio signal
 {
 	AUDIO_UNIT *ao=audio_frame; int i=AUDIO_LENGTH_Z,aa;
@@ -1051,10 +1219,40 @@ INLINE int session_listen(void) // check the pending messages and update stuff a
 	return session_kbjoy(); // sync the keyboard and joystick
 }
 
+// frame pacing: the timer runs in microseconds, so 60 Hz frames last 16666 or 16667 us rather than 16 or 17 ms; the waits sleep while the
+// deadline is far and spin thru the last stretch, whose length follows how late the sleeps of the system wake up (up to SESSION_SPIN_MAX us).
+int session_pacing_n=0,session_pacing_late=0,session_pacing_min,session_pacing_max; long long session_pacing_sum=0; // frame time stats
+#ifndef session_pacing
+#ifndef SESSION_SPIN_MAX
+#define SESSION_SPIN_MAX 4000 // backends whose sleeps can be coarser than 1 ms must define their own limit
+#endif
+int session_spin=2000; // how many microseconds must be spun rather than slept
+void session_pacing(long long t) // wait till the microsecond `t`
+{
+	for (long long u,v;(u=t-session_uticks())>0;)
+		if ((v=(u-session_spin)/1000)>0) // sleep?
+		{
+			u=session_uticks(); session_delay(v); // the overshoot becomes the new margin at once, but it shrinks slowly
+			if ((u=session_uticks()-u-v*1000)>session_spin) session_spin=u>SESSION_SPIN_MAX?SESSION_SPIN_MAX:u; else if ((session_spin-=session_spin>>4)<500) session_spin=500;
+		}
+		// else spin!
+}
+#endif
+char *session_pacinginfo(void) // frame time statistics of the last second: minimum, average and maximum, and late frames; empty if we didn't wait
+{
+	static char s[64]; *s=0; if (session_pacing_n)
+	{
+		int a=session_pacing_sum/session_pacing_n;
+		sprintf(s," | %d.%d<%d.%d<%d.%d ms, %d late",session_pacing_min/1000,session_pacing_min/100%10,a/1000,a/100%10,
+			session_pacing_max/1000,session_pacing_max/100%10,session_pacing_late);
+	}
+	session_pacing_n=session_pacing_late=0,session_pacing_sum=0; return s;
+}
+
 INLINE void session_update(void) // render video+audio and handle self-adjusting realtime delays, automatic frameskip, etc.
 {
 	int i,j; static int performance_t=0,performance_f=0,performance_b=0; ++performance_f;
-	session_writewave(); session_writefilm(); // record wave+film frame
+	session_writewave(); session_writefilm(); session_writestream(); // record wave+film frame
 	if (session_key2joy) // virtual joystick?
 	{
 		joy_bit=joy_kbd;
@@ -1064,8 +1262,8 @@ INLINE void session_update(void) // render video+audio and handle self-adjusting
 	else joy_bit=session_stick?session_joy2k():0; // real joystick or nothing
 	i=session_ticks(); { static BYTE q=0; if (!q) q=1,performance_t=i; } if ((j=i-performance_t)>=0) // update performance percentage?
 	{
-		sprintf(session_tmpstr,"%s | %s | %s %s %d:%d%%",session_caption,session_info,session_blitinfo(),session_version,
-			(performance_b*100+VIDEO_PLAYBACK/2)/VIDEO_PLAYBACK,(performance_f*100+VIDEO_PLAYBACK/2)/VIDEO_PLAYBACK);
+		sprintf(session_tmpstr,"%s | %s | %s %s %d:%d%%%s%s",session_caption,session_info,session_blitinfo(),session_version,
+			(performance_b*100+VIDEO_PLAYBACK/2)/VIDEO_PLAYBACK,(performance_f*100+VIDEO_PLAYBACK/2)/VIDEO_PLAYBACK,session_filminfo(),session_pacinginfo());
 		performance_t+=session_clock; performance_f=performance_b=session_paused=0;
 		session_title(session_tmpstr);
 	}
@@ -1074,43 +1272,75 @@ INLINE void session_update(void) // render video+audio and handle self-adjusting
 			{ performance_b+=video_interlaced+1; session_drawme(); }
 	static BYTE r=0; if (!video_interlaces||frame_scanline<2) // update the two frame counters: Nx100% speed and frameskip
 	{
-		if ((j=session_fast&&!session_filmfile?4:session_rhythm),!r||r>j) // 0..3 = 100%..400%; 4=500% > 1<<2=400%
+		if ((j=session_fast&&!session_filmfile&&!session_streamv?4:session_rhythm),!r||r>j) // 0..3 = 100%..400%; 4=500% > 1<<2=400%
 			if (r=j,j=(session_fast&2)?(MAIN_FRAMESKIP_MASK+1)>>2:video_framelimit,!video_framecount||video_framecount>j+1)
 				video_framecount=j; // bit 1 of session_fast = emulator is temporarily requesting full throttle
 			else --video_framecount;
 		else --r;
 	}
+	static long long uu=0; // the end of the last paced frame, zero if it wasn't paced
 	if (session_wait|session_fast)
 	{
-		session_timer=i; // ensure that the next frame can be valid!
+		session_timer=i,session_utimer=session_uticks(),uu=0; // ensure that the next frame can be valid!
 		audio_mustsync(); if (audio_fastmute) audio_disabled|=+8;
 	}
 	else if (!r) // handle timers and do pauses
 	{
 		audio_disabled&=~8; audio_resyncme(); // recalc audio buffer, if required!
-		if (VIDEO_PLAYBACK==50) // always true on pure PAL systems
-			j=session_clock/50; // PAL never needs any adjusting (a frame always lasts exactly 20 ms)
-		else // (we avoid a warning here) always true on pure NTSC systems
-			{ static int jj=0; j=(jj+=session_clock)/VIDEO_PLAYBACK; jj%=VIDEO_PLAYBACK; } // 60 Hz: [16,17,17]
-		if ((i=(session_timer+=j)-i)>=0)
-			{ if (i=(i>j?j:i)*1000/session_clock) session_delay(i); } // avoid zero and overflows!
-		else if (i+j<0)
-			{ if (!session_filmfile) video_framecount=video_framelimit+1; } // skip one extra frame on timeout!
+		static int jj=0; j=(jj+=1000000)/VIDEO_PLAYBACK; jj%=VIDEO_PLAYBACK; // 50 Hz: [20000]; 60 Hz: [16666,16667,16667]
+		long long u=session_uticks(),k=(session_utimer+=j)-u;
+		if (session_vsync&&video_required&&k<j/4&&k>-j/4) // did the vertical retrace come near the deadline? follow the retrace!
+			session_utimer=u;
+		else if (k>=0)
+			session_pacing(k>j?u+j:session_utimer); // never wait longer than a frame
+		else if (++session_pacing_late,k+j<0)
+			{ if (!session_filmfile&&!session_streamv) video_framecount=video_framelimit+1; } // skip one extra frame on timeout!
+		session_timer=session_utimer*session_clock/1000000; // the Win32 audio clock relies on this
+		if (u=session_uticks(),uu) // update the frame time statistics
+		{
+			if (k=u-uu,!session_pacing_n++) session_pacing_min=session_pacing_max=k;
+			else if (session_pacing_min>k) session_pacing_min=k; else if (session_pacing_max<k) session_pacing_max=k;
+			session_pacing_sum+=k;
+		}
+		uu=u;
 	}
+	else uu=0;
 	if (session_audio) session_playme(); // manage audio buffer
-	audio_required=!audio_disabled||session_filmfile||session_wavefile; // ensures that audio is saved to WAV or XRF even without sound hardware
+	audio_required=!audio_disabled||session_filmfile||session_wavefile||session_streama; // ensures that audio is saved to WAV or XRF even without sound hardware
+	#ifdef HEADLESS // nobody watches the screen: only draw the frames that get recorded or streamed and the last one
+	if (!session_filmfile&&!session_streamv&&(session_headless<=0||video_pos_z+1<session_headless)) video_framecount|=1;
+	#endif
 	frame_pos_y=video_pos_y; if (!(video_required=!video_framecount&&!r)) frame_pos_y+=VIDEO_LENGTH_Y*4; // simplify several frameskipping operations
 	audio_target=audio_frame,audio_pos_z=0; session_signal&=~SESSION_SIGNAL_FRAME; // new frame!
 	session_thanks();
 }
 
+// multiple machines in a single session ---------------------------- //
+
+// a machine context is a private copy of every variable that the emulator
+// enumerates in its list of MACHINE_ITEM; switching machines means storing
+// the live variables into a context and loading them from another one.
+// The hot paths stay untouched: they keep running on plain globals.
+
+typedef struct { void *p; int l; } MACHINE_ITEM; // one variable of the machine state
+#define MACHINE_STATE(x) {&(x),sizeof(x)}
+int machine_size(const MACHINE_ITEM *m,int n) // bytes needed to store `n` items of `m`
+	{ int l=0; while (n--) l+=m++->l; return l; }
+void machine_store(BYTE *t,const MACHINE_ITEM *m,int n) // copy the live items into context `t`
+	{ for (;n--;++m) memcpy(t,m->p,m->l),t+=m->l; }
+void machine_fetch(const BYTE *s,const MACHINE_ITEM *m,int n) // copy context `s` into the live items
+	{ for (;n--;++m) memcpy(m->p,s,m->l),s+=m->l; }
+
 // elementary ZIP archive support ----------------------------------- //
 
 // the INFLATE method! ... or more properly a terribly simplified mess
-// based on the RFC1951 standard and PUFF.C from the ZLIB project.
+// based on the RFC1951 standard and PUFF.C from the ZLIB project;
+// the Huffman codes are looked up in tables, as INFTREES.C does.
 
-BYTE *puff_data; int puff_size,puff_word,puff_bits; // stream cursor
-int puff_len_c[16+288],puff_off_c[16+32]; // Huffman tables: 16 bases + N values
+BYTE *puff_data; unsigned long long puff_word; int puff_size,puff_bits; // stream cursor; the bit buffer holds up to 64 bits
+#define PUFF_LEN_BITS 9 // length codes are looked up by their first 9 bits,
+#define PUFF_OFF_BITS 6 // offset codes by their first 6; longer codes need a subtable
+int puff_len_c[852],puff_off_c[592]; // Huffman tables: main table + subtables, sizes are ENOUGH_LENS and ENOUGH_DISTS from ZLIB
 char puff_cnt_c[320]; // bit counts: 0..287 length codes + 288..319 offset codes
 
 const int puff_len_k[2][32]={ // length constants; 0, 30 and 31 are reserved
@@ -1130,34 +1360,66 @@ void puff_default(void) // generate the default static Huffman bit counts
 	while (i<320) puff_cnt_c[i++]=5; // notice that the reserved codes take part in the calculations!
 }
 // Huffman-bitwise operations
-int puff_recv(int n) // receive `n` bits from source; <0 ERROR, >=0 OUTPUT
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+#define PUFF_GET8(x) (((unsigned long long)mgetiiii((x)+4)<<32)+(unsigned)mgetiiii(x))
+#else
+#define PUFF_GET8(x) (*(unsigned long long*)(x))
+#endif
+// refill the bit buffer `w` of `b` bits from source `d` of `z` bytes; past the end of the source, `z` goes negative and `w` receives zeros.
+// the bits beyond `b` are harmless: they're always the right ones, and the next refill will write them again.
+#define PUFF_FILL(d,z,w,b) do{ if (LIKELY(z>=8)) { int n_=(63-b)>>3; w|=PUFF_GET8(d)<<b,d+=n_,z-=n_,b+=n_<<3; } \
+	else while (b<=56) { if (--z>=0) w|=(unsigned long long)*d++<<b; b+=8; } }while(0)
+void puff_fill(void) { PUFF_FILL(puff_data,puff_size,puff_word,puff_bits); }
+#define puff_underrun() (puff_bits+puff_size*8<0) // did we consume any of the zeros past the end of the source?
+int puff_flush(void) // drop any bits left in the current byte and give the whole bytes back to the source; 0 OK, !0 ERROR
 {
-	int w=puff_word; while (puff_bits<n) // we'll need `w` later
-		if (UNLIKELY(--puff_size<0)) return -1; // source underrun!
-		else w+=*puff_data++<<puff_bits,puff_bits+=8; // read byte from source
-	return puff_word=w>>n,puff_bits-=n,w&((1<<n)-1); // flush bits and return
+	int n=puff_bits>>3; if (puff_size<0) n+=puff_size,puff_size=0; // the zeros past the end were never read
+	return puff_word=puff_bits=0,n<0?-1:(puff_data-=n,puff_size+=n,0);
 }
-int puff_decode(int *h) // receive code from Huffman source; <0 ERROR, >=0 OUTPUT
+int puff_recv(int n) // receive `n` bits from source; <0 ERROR, >=0 OUTPUT
 {
-	for (int w=puff_word,b=puff_bits,l=1,i=0,base=0,code=0;;) // extract bits till they fit within an interval
+	if (puff_bits<n) puff_fill();
+	int i=puff_word&((1<<n)-1); puff_word>>=n,puff_bits-=n;
+	return UNLIKELY(puff_underrun())?-1:i; // source underrun!
+}
+int puff_decode(int *h,int r) // receive code from Huffman source; <0 ERROR, >=0 OUTPUT
+{
+	if (puff_bits<15) puff_fill(); // the longest code is 15 bits long
+	int i=h[puff_word&((1<<r)-1)]; // `i` is either VALUE*256+BITS or SUBTABLE*256+16+SUBTABLE BITS
+	if (i&16) i=h[(i>>8)+((puff_word>>r)&((1<<(i&15))-1))]; // the longest codes need a second look-up
+	if (UNLIKELY(!(i&15))) return -1; // bad value!
+	puff_word>>=i&15,puff_bits-=i&15;
+	return UNLIKELY(puff_underrun())?-1:i>>8; // source underrun!
+}
+int puff_tables(int *h,char *l,int n,int r) // generate Huffman look-up tables (`r` bits wide) from canonical length table; 0 OK, !0 ERROR (1: single code)
+{
+	int c[16],o[16],v[288],i,j,k,a; for (i=0;i<16;++i) c[i]=0; // reset intervals
+	for (i=0;i<n;++i) ++c[l[i]]; // calculate intervals
+	memset(h,0,sizeof(int)<<r); // unused codes stay invalid
+	if (c[0]==n) return 0; // empty table, nothing to do!
+	for (a=i=1;i<16;++i) if (UNLIKELY((a=(a<<1)-c[i])<0)) return a; // bad value!
+	if (a&&(a=n-c[0])!=1) return a; // incomplete tables are only valid when they hold a single code (RFC1951 allows it)
+	for (o[i=1]=0;i<15;++i) o[i+1]=o[i]+c[i]; // calculate base for each bit count
+	for (i=0;i<n;++i) if (l[i]) v[o[l[i]]++]=i; // sort symbols in canonical order: shorter codes first, then lower values first
+	for (o[i=1]=0;i<15;++i) o[i+1]=(o[i]+c[i])<<1; // calculate first code for each bit count
+	int m=(1<<r)-1,p=m+1,x=-1,y=0,z=0; // `p`: next free subtable; `x`, `y` and `z`: prefix, offset and bits of the current subtable
+	for (int q=0;q<n-c[0];++q)
 	{
-		for (int o;b;--b) // Huffman bits are stored backwards: "w" right-shifts, "code" left-shifts
-			if (code+=w&1,w>>=1,code<base+(o=h[l])) // does the code fit the interval?
-				return puff_word=w,puff_bits=(puff_bits-l)&7,h[16+i+(code-base)]; // yes!
-			else i+=o,base=(base+o)<<1,code<<=1,++l; // calculate next interval
-		if (UNLIKELY(!(b=16-l)||--puff_size<0)) return -1; // too many bits! source underrun!
-		if (w=*puff_data++,b>8) b=8; // read byte from source
+		i=v[q],j=l[i],k=rbit16(o[j]++)>>(16-j); // Huffman bits are stored backwards
+		if (j<=r) // short code: fill every main table entry that begins with it
+			for (;k<=m;k+=1<<j) h[k]=(i<<8)+j;
+		else // long code: it goes into the subtable of its first `r` bits
+		{
+			if ((k&m)!=x) // new subtable? make it big enough for all the codes that share the same first `r` bits
+			{
+				int b=1<<(z=j-r); while (z+r<15&&(b-=c[z+r])>0) ++z,b<<=1;
+				memset(h+(y=p),0,sizeof(int)<<z),h[x=k&m]=(p<<8)+16+z,p+=1<<z;
+			}
+			for (k>>=r;k<1<<z;k+=1<<(j-r)) h[y+k]=(i<<8)+j;
+		}
+		--c[j]; // the subtable sizes rely on the codes that are still pending
 	}
-}
-int puff_tables(int *h,char *l,int n) // generate Huffman input tables from canonical length table; 0 OK, !0 ERROR
-{
-	int o[16],i,a; for (i=0;i<16;++i) h[i]=0; // reset intervals
-	for (i=0;i<n;++i) ++h[l[i]]; // calculate intervals
-	if (h[0]==n) return 0; // empty table, nothing to do!
-	for (a=i=1;i<16;++i) if (UNLIKELY((a=(a<<1)-h[i])<0)) return a; // bad value!
-	for (o[i=1]=0;i<15;++i) o[i+1]=o[i]+h[i]; // calculate base for each bit count
-	for (i=0;i<n;++i) if (l[i]) h[16+o[l[i]]++]=i; // assign values to all symbols
-	return a; // 0 if complete, >0 requires checking whether valh[0]+1==n, i.e. all lengths but one are zero
+	return a;
 }
 int puff_main(BYTE *t,int o,BYTE *s,int i) // inflate source `s[i]` into target `t[o]`; >=0 output length, <0 ERROR!
 {
@@ -1166,20 +1428,20 @@ int puff_main(BYTE *t,int o,BYTE *s,int i) // inflate source `s[i]` into target
 	{
 		if (q=puff_recv(1),!(i=puff_recv(2))) // stored block?
 		{
-			if (UNLIKELY((puff_size-=4)<0)) return -1; // source underrun!
+			if (UNLIKELY(puff_flush()||(puff_size-=4)<0)) return -1; // source underrun!
 			i=*puff_data++,i+=*puff_data++<<8; j=*puff_data++,j+=*puff_data++<<8;
 			if (UNLIKELY(i+j!=0XFFFF||(puff_size-=i)<0||(o-=i)<0)) return -1; // bad value! source underrun! target overflow!
 			// length zero is allowed: `...This completes the current deflate block and follows it with an empty stored block that is
 			// three bits plus filler bits to the next byte, followed by four bytes (00 00 ff ff)...` http://www.zlib.net/manual.html
-			if (puff_word=puff_bits=0,i) memcpy(t,puff_data,i),puff_data+=i,t+=i; // drop any bits left, copy data and update cursors
+			if (i) memcpy(t,puff_data,i),puff_data+=i,t+=i; // copy data and update cursors
 		}
 		else if (i>0&&i<3) // packed block?
 		{
 			if (i==1) // default Huffman trees?
 			{
 				puff_default(); // default static Huffman tables
-				puff_tables(puff_len_c,puff_cnt_c,288); // THERE MUST BE EXACTLY 288 LENGTH CODES!!
-				puff_tables(puff_off_c,puff_cnt_c+288,32); // DITTO: THERE MUST BE 32 OFFSET CODES!
+				puff_tables(puff_len_c,puff_cnt_c,288,PUFF_LEN_BITS); // THERE MUST BE EXACTLY 288 LENGTH CODES!!
+				puff_tables(puff_off_c,puff_cnt_c+288,32,PUFF_OFF_BITS); // DITTO: THERE MUST BE 32 OFFSET CODES!
 			}
 			else // custom Huffman trees!
 			{
@@ -1187,9 +1449,9 @@ int puff_main(BYTE *t,int o,BYTE *s,int i) // inflate source `s[i]` into target
 					return -1; // bad match/range/huffman values!
 				for (a=0,i=0;i<j;) a|=puff_cnt_c[puff_cnt_k[i++]]=puff_recv(3); // read bit counts for the Huffman-encoded header
 				while (i<19) puff_cnt_c[puff_cnt_k[i++]]=0; // padding: clear the remainder of this header
-				if (UNLIKELY(a<0||puff_tables(puff_len_c,puff_cnt_c,19))) return -1; // bad values! invalid table!
+				if (UNLIKELY(a<0||puff_tables(puff_len_c,puff_cnt_c,19,PUFF_LEN_BITS))) return -1; // bad values! invalid table!
 				for (len+=off,i=0;i<len;)
-					if ((a=puff_decode(puff_len_c))<16) // literal?
+					if ((a=puff_decode(puff_len_c,PUFF_LEN_BITS))<16) // literal?
 						if (UNLIKELY(a<0)) return -1; else puff_cnt_c[i++]=a; // bad value!
 					else
 					{
@@ -1197,29 +1459,43 @@ int puff_main(BYTE *t,int o,BYTE *s,int i) // inflate source `s[i]` into target
 							if (UNLIKELY(!i)) return -1; else j=puff_cnt_c[i-1],a=3+puff_recv(2); // bad value!
 						else // 17 or 18: store zero 3..10 or 11..138 times
 							j=0,a=a==17?3+puff_recv(3):11+puff_recv(7);
-						if (UNLIKELY(puff_size<0||i+a>len)) return -1; // source underrun! bad value!
+						if (UNLIKELY(puff_underrun()||i+a>len)) return -1; // source underrun! bad value!
 						do puff_cnt_c[i++]=j; while (--a);
 					}
-				if (UNLIKELY((len-=off,puff_tables(puff_len_c,puff_cnt_c,len)&&len-puff_len_c[0]!=1)|| // bad length table!
-					(puff_tables(puff_off_c,puff_cnt_c+len,off)&&off-puff_off_c[0]!=1))) return -1; // bad offset table!
+				if (UNLIKELY((len-=off,(a=puff_tables(puff_len_c,puff_cnt_c,len,PUFF_LEN_BITS))&&a!=1)|| // bad length table!
+					((a=puff_tables(puff_off_c,puff_cnt_c+len,off,PUFF_OFF_BITS))&&a!=1))) return -1; // bad offset table!
 			}
+			// the cursor stays in local variables here: any byte written into the target could otherwise overwrite the globals!
+			BYTE *d=puff_data; unsigned long long w=puff_word; int b=puff_bits,z=puff_size,k;
 			for (;;) // beware: custom trees cannot generate length codes >=286 or offset codes >=30, but default trees can!
 			{
-				if ((i=puff_decode(puff_len_c))<256) // literal?
-					if (UNLIKELY(i<0||--o<0)) return -1; else *t++=i; // bad value! target overflow!
+				if (b<48) // the longest length:offset pair is 15+5+15+13 bits long; refill once per symbol at most
+				{
+					if (UNLIKELY(b+z*8<0)) return -1; // source underrun!
+					PUFF_FILL(d,z,w,b);
+				}
+				if ((i=puff_len_c[w&((1<<PUFF_LEN_BITS)-1)])&16) i=puff_len_c[(i>>8)+((w>>PUFF_LEN_BITS)&((1<<(i&15))-1))];
+				if (UNLIKELY(!(k=i&15))) return -1; else w>>=k,b-=k; // bad value!
+				if ((i>>=8)<256) // literal?
+					if (UNLIKELY(--o<0)) return -1; else *t++=i; // target overflow!
 				else if (i-=256) // length:offset pair?
 				{
-					if (UNLIKELY(!(i=puff_len_k[0][i]+puff_recv(puff_len_k[1][i]))||(o-=i)<0|| // null! target overflow!
-						(j=puff_decode(puff_off_c))<0|| // bad value!
-						!(j=puff_off_k[0][j]+puff_recv(puff_off_k[1][j]))||j>t-u)) return -1; // null! source underrun!
-					if (1==j) memset(t,t[-1],i),t+=i; else { s=t-j; do *t++=*s++; while (--i); } // detect RLE
+					k=puff_len_k[1][i],i=puff_len_k[0][i]+(int)(w&((1<<k)-1)),w>>=k,b-=k;
+					if ((j=puff_off_c[w&((1<<PUFF_OFF_BITS)-1)])&16) j=puff_off_c[(j>>8)+((w>>PUFF_OFF_BITS)&((1<<(j&15))-1))];
+					if (UNLIKELY(!(k=j&15))) return -1; else w>>=k,b-=k; // bad value!
+					k=puff_off_k[1][j>>=8],j=puff_off_k[0][j]+(int)(w&((1<<k)-1)),w>>=k,b-=k;
+					if (UNLIKELY(!i||(o-=i)<0||!j||j>t-u)) return -1; // null! target overflow! null! source underrun!
+					if (1==j) memset(t,t[-1],i),t+=i; // detect RLE
+					else if (j>=8&&o>=8) { s=t-j; do memcpy(t,s,8),t+=8,s+=8; while ((i-=8)>0); t+=i; } // 8 bytes at once, a few more bytes won't hurt
+					else { s=t-j; do *t++=*s++; while (--i); }
 				}
 				else break; // end of block!
 			}
+			if (puff_data=d,puff_word=w,puff_bits=b,puff_size=z,UNLIKELY(puff_underrun())) return -1; // source underrun!
 		}
 		else return -1; // unsupported block!
 	}
-	while (!q); return t-u; // OK, output length
+	while (!q); return puff_flush()?-1:t-u; // OK, output length
 }
 
 #ifdef PNG_OUTPUT_MODE
@@ -1227,8 +1503,18 @@ int puff_main(BYTE *t,int o,BYTE *s,int i) // inflate source `s[i]` into target
 #endif
 
 #if (defined(INFLATE_RFC1950)||defined(DEFLATE_RFC1950))
-unsigned int adler32(unsigned int k,const BYTE *s,int i) // incremental compact Adler-32 checksum
-	{ int j=k&65535; k>>=16; while (i-->0) { if ((k+=(j+=*s++))>=65521) k%=65521,j%=65521; } return (k<<16)+j; }
+unsigned int adler32(unsigned int k,const BYTE *s,int i) // incremental Adler-32 checksum
+{
+	unsigned int j=k&65535; k>>=16; while (i>0) // 5552 bytes are the most we can add before the sums can overflow 32 bits
+	{
+		int n=i<5552?i:5552; i-=n;
+		for (;n>=8;n-=8,s+=8) // unrolled: the modulo only happens once per run
+			k+=j+=s[0],k+=j+=s[1],k+=j+=s[2],k+=j+=s[3],k+=j+=s[4],k+=j+=s[5],k+=j+=s[6],k+=j+=s[7];
+		while (n-->0) k+=j+=*s++;
+		j%=65521,k%=65521;
+	}
+	return (k<<16)+j;
+}
 unsigned int puff_adler32(const BYTE *s,int i) { return adler32(1,s,i); } // default parameters for monolithic data
 #endif
 #ifdef INFLATE_RFC1950
@@ -1240,11 +1526,107 @@ int puff_zlib(BYTE *t,int o,BYTE *s,int i) // decodes a RFC1950 standard ZLIB ob
 	return (o=puff_main(t,o,s+=2,i))>=0&&puff_adler32(t,o)==mgetmmmm(puff_data)?puff_data+=4,o:-1; // OK! // ERROR!
 }
 #endif
-unsigned int ccitt32(unsigned int k,const BYTE *s,int i) // incremental compact CCITT CRC-32 algorithm by Karl Malbrain
+// the CCITT CRC-32 walks the data eight bytes at a time with the slicing-by-8 tables, built on first use; CPUs that
+// can multiply without carry (x86 PCLMULQDQ, checked at runtime) or that have CRC instructions (ARMv8 CRC32, when the
+// compiler targets them) do even better. `-DCRC32_SCALAR` leaves the hardware aside and only keeps the tables.
+#ifndef CRC32_SCALAR
+#if !defined(__TINYC__) && ((defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))) || defined(_M_X64))
+#define CCITT32_FAST "PCLMULQDQ"
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CCITT32_TARGET
+#define ccitt32_cpuid(r) (__cpuid(r,1),r[2]) // ECX
+#else
+#include <immintrin.h>
+#include <cpuid.h>
+#define CCITT32_TARGET __attribute__((target("pclmul,sse2")))
+#define ccitt32_cpuid(r) (__get_cpuid(1,(unsigned*)&r[0],(unsigned*)&r[1],(unsigned*)&r[2],(unsigned*)&r[3])?r[2]:0) // ECX
+#endif
+CCITT32_TARGET unsigned int ccitt32_clmul(unsigned int k,const BYTE *s,int i) // `i` must be a multiple of 16, 64 or more
+{
+	// folding constants (x^(4*128+32), x^(4*128-32), x^(128+32), x^(128-32), x^64 modulo P) and the Barrett reduction,
+	// all in the bit-reflected domain, after Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ".
+	__m128i x0,x1,x2,x3,x4,x5,x6,x7,x8;
+	x1=_mm_xor_si128(_mm_loadu_si128((__m128i const*)s),_mm_cvtsi32_si128(k));
+	x2=_mm_loadu_si128((__m128i const*)(s+16));
+	x3=_mm_loadu_si128((__m128i const*)(s+32));
+	x4=_mm_loadu_si128((__m128i const*)(s+48));
+	x0=_mm_set_epi64x(0X01C6E41596LL,0X0154442BD4LL);
+	for (s+=64,i-=64;i>=64;s+=64,i-=64) // fold four blocks of 128 bits in parallel
+	{
+		x5=_mm_clmulepi64_si128(x1,x0,0X00),x1=_mm_clmulepi64_si128(x1,x0,0X11);
+		x6=_mm_clmulepi64_si128(x2,x0,0X00),x2=_mm_clmulepi64_si128(x2,x0,0X11);
+		x7=_mm_clmulepi64_si128(x3,x0,0X00),x3=_mm_clmulepi64_si128(x3,x0,0X11);
+		x8=_mm_clmulepi64_si128(x4,x0,0X00),x4=_mm_clmulepi64_si128(x4,x0,0X11);
+		x1=_mm_xor_si128(_mm_xor_si128(x1,x5),_mm_loadu_si128((__m128i const*)s));
+		x2=_mm_xor_si128(_mm_xor_si128(x2,x6),_mm_loadu_si128((__m128i const*)(s+16)));
+		x3=_mm_xor_si128(_mm_xor_si128(x3,x7),_mm_loadu_si128((__m128i const*)(s+32)));
+		x4=_mm_xor_si128(_mm_xor_si128(x4,x8),_mm_loadu_si128((__m128i const*)(s+48)));
+	}
+	x0=_mm_set_epi64x(0X00CCAA009ELL,0X01751997D0LL); // fold the four blocks into one
+	x5=_mm_clmulepi64_si128(x1,x0,0X00),x1=_mm_clmulepi64_si128(x1,x0,0X11),x1=_mm_xor_si128(_mm_xor_si128(x1,x2),x5);
+	x5=_mm_clmulepi64_si128(x1,x0,0X00),x1=_mm_clmulepi64_si128(x1,x0,0X11),x1=_mm_xor_si128(_mm_xor_si128(x1,x3),x5);
+	x5=_mm_clmulepi64_si128(x1,x0,0X00),x1=_mm_clmulepi64_si128(x1,x0,0X11),x1=_mm_xor_si128(_mm_xor_si128(x1,x4),x5);
+	for (;i>=16;s+=16,i-=16) // fold the remaining blocks one by one
+		x5=_mm_clmulepi64_si128(x1,x0,0X00),x1=_mm_clmulepi64_si128(x1,x0,0X11),
+		x1=_mm_xor_si128(_mm_xor_si128(x1,_mm_loadu_si128((__m128i const*)s)),x5);
+	x2=_mm_clmulepi64_si128(x1,x0,0X10); // fold 128 bits into 64 bits
+	x3=_mm_setr_epi32(-1,0,-1,0);
+	x1=_mm_xor_si128(_mm_srli_si128(x1,8),x2);
+	x0=_mm_set_epi64x(0,0X0163CD6124LL);
+	x2=_mm_srli_si128(x1,4);
+	x1=_mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1,x3),x0,0X00),x2);
+	x0=_mm_set_epi64x(0X01F7011641LL,0X01DB710641LL); // Barrett reduction to 32 bits
+	x2=_mm_and_si128(_mm_clmulepi64_si128(_mm_and_si128(x1,x3),x0,0X10),x3);
+	x1=_mm_xor_si128(x1,_mm_clmulepi64_si128(x2,x0,0X00));
+	return _mm_cvtsi128_si32(_mm_srli_si128(x1,4));
+}
+#elif defined(__ARM_FEATURE_CRC32)
+#define CCITT32_FAST "ARMv8 CRC32"
+#include <arm_acle.h>
+unsigned int ccitt32_crc32(unsigned int k,const BYTE *s,int i) // `i` must be a multiple of 16, 64 or more
+{
+	for (unsigned long long h,l;i>=16;s+=16,i-=16)
+		memcpy(&h,s,8),memcpy(&l,s+8,8),k=__crc32d(__crc32d(k,h),l);
+	return k;
+}
+#endif
+#endif
+unsigned int ccitt32_table[8][256]; char ccitt32_fast=-1; // <0 unknown, 0 tables only, >0 hardware
+void ccitt32_setup(void) // build the tables and look for hardware support
 {
-	static const unsigned int z[16]={0,0X1DB71064,0X3B6E20C8,0X26D930AC,0X76DC4190,0X6B6B51F4,0X4DB26158,0X5005713C,
-		0XEDB88320,0XF00F9344,0XD6D6A3E8,0XCB61B38C,0X9B64C2B0,0X86D3D2D4,0XA00AE278,0XBDBDF21C}; // precalc'd!
-	{ while (i-->0) k^=*s++,k=(k>>4)^z[k&15],k=(k>>4)^z[k&15]; } return k; // walk bytes as pairs of nibbles
+	for (int i=0;i<256;++i)
+	{
+		unsigned int k=i; for (int j=0;j<8;++j) k=(k>>1)^(0XEDB88320&-(k&1));
+		ccitt32_table[0][i]=k;
+	}
+	for (int i=0;i<256;++i)
+		for (int j=1;j<8;++j)
+			ccitt32_table[j][i]=(ccitt32_table[j-1][i]>>8)^ccitt32_table[0][ccitt32_table[j-1][i]&255];
+	#ifdef CCITT32_TARGET
+	int r[4]; ccitt32_fast=(ccitt32_cpuid(r)>>1)&1; // ECX bit 1: PCLMULQDQ
+	#elif defined(CCITT32_FAST)
+	ccitt32_fast=1; // the compiler already requires the CRC32 instructions
+	#else
+	ccitt32_fast=0;
+	#endif
+}
+unsigned int ccitt32(unsigned int k,const BYTE *s,int i) // incremental CCITT CRC-32 checksum
+{
+	if (UNLIKELY(ccitt32_fast<0)) ccitt32_setup();
+	#ifdef CCITT32_TARGET
+	if (ccitt32_fast&&i>=64) k=ccitt32_clmul(k,s,i&-16),s+=i&-16,i&=15;
+	#elif defined(CCITT32_FAST)
+	if (ccitt32_fast&&i>=64) k=ccitt32_crc32(k,s,i&-16),s+=i&-16,i&=15;
+	#endif
+	for (;i>=8;s+=8,i-=8) // slicing-by-8
+	{
+		k^=mgetiiii(s); unsigned int h=mgetiiii(s+4);
+		k=ccitt32_table[7][k&255]^ccitt32_table[6][(k>>8)&255]^ccitt32_table[5][(k>>16)&255]^ccitt32_table[4][k>>24]
+			^ccitt32_table[3][h&255]^ccitt32_table[2][(h>>8)&255]^ccitt32_table[1][(h>>16)&255]^ccitt32_table[0][h>>24];
+	}
+	while (i-->0) k=(k>>8)^ccitt32_table[0][(k^*s++)&255];
+	return k;
 }
 // notice that the CCITT CRC-16 method (f.e. Amstrad CPC tapes) would simply do `k=(k>>4)^((k&15)*4225)` on each nibble.
 unsigned int puff_ccitt32(const BYTE *s,int i) { return ccitt32(0XFFFFFFFF,s,i)^0XFFFFFFFF; } // default parameters
@@ -1283,6 +1665,9 @@ int huff_stored(BYTE *t,int o,BYTE *s,int i) // the storage part of DEFLATE; >=0
 	return *t++=1,*t++=i,*t++=i>>8,*t++=~i,*t++=~i>>8,memcpy(t,s,i),t-u+i; // final block!
 }
 #if DEFLATE_LEVEL > 0 // if you must save DEFLATE data and perform compression on it!
+int huff_level=DEFLATE_LEVEL; // the compression level can change on runtime, see above
+const int huff_levels[10][4]={ // good, lazy, nice and chain lengths of every level, as in ZLIB's DEFLATE.C; a lazy length of 0 means greedy
+	{0,0,0,0},{4,0,8,4},{4,0,16,8},{4,0,32,32},{4,4,16,16},{8,16,32,32},{8,16,128,128},{8,32,128,256},{32,128,258,1024},{32,258,258,4096} };
 // Huffman-bitwise operations
 void huff_send(int n,int i) // sends the `n`-bit word `i` to target
 {
@@ -1292,51 +1677,160 @@ void huff_send(int n,int i) // sends the `n`-bit word `i` to target
 void huff_encode(int *h,int i) { i=h[i]; huff_send(i&255,i>>8); } // sends value to Huffman target
 void huff_append(const int h[2][32],int i,int z) { huff_send(h[1][i],z-h[0][i]); }
 #define huff_flush() huff_send(7,0) // flushes the last bits in the bitstream!
-// notice that these function ignore target overflows; the caller must know that the pathological case (longest possible code) is 48 bits long
+// notice that these function ignore target overflows; huff_block() must check the room before sending anything
 void huff_tables(int *h,char *l,int n) // generates Huffman output table from canonical length table
 {
 	for (int j=1,k=0;j<16;++j,k<<=1) for (int i=0;i<n;++i)
 		if (l[i]==j) // do the bit counts match?
 			h[i]=((rbit16(k++)>>(16-j))<<8)+j; // store Huffman bits backwards
 }
-#define DEFLATE_ALLOC 32768
-int huff_static(BYTE *t,int o,BYTE *s,int i) // the static compression of DEFLATE; >=0 output length, <0 ERROR!
+void huff_lengths(char *l,const int *f,int n,int m) // generates canonical length table `l[n]` from frequencies `f[n]`; codes can't be longer than `m` bits
+{
+	int a[288],w[288],c[16],i,j,k; // symbols sorted by frequency, their weights (and later their lengths) and the bit counts
+	for (k=i=0;i<n;++i) if (l[i]=0,f[i]) // the tables are small, insertion sort is enough
+		{ for (j=k++;j>0&&f[a[j-1]]>f[i];--j) a[j]=a[j-1]; a[j]=i; }
+	if (k<2) { if (k) l[*a]=1; return; } // a single code must still be 1 bit long
+	// Moffat and Katajainen's in-place calculation of minimum-redundancy codes: weights become parents, then depths, then lengths
+	for (i=0;i<k;++i) w[i]=f[a[i]];
+	int root=0,leaf=2,next,avbl,used,dpth; w[0]+=w[1];
+	for (next=1;next<k-1;++next)
+	{
+		if (leaf>=k||w[root]<w[leaf]) w[next]=w[root],w[root++]=next; else w[next]=w[leaf++];
+		if (leaf>=k||(root<next&&w[root]<w[leaf])) w[next]+=w[root],w[root++]=next; else w[next]+=w[leaf++];
+	}
+	for (w[k-2]=0,next=k-3;next>=0;--next) w[next]=w[w[next]]+1;
+	for (avbl=1,used=dpth=0,root=k-2,next=k-1;avbl>0;avbl=used*2,++dpth,used=0)
+	{
+		while (root>=0&&w[root]==dpth) ++used,--root;
+		while (avbl>used) w[next--]=dpth,--avbl;
+	}
+	// the longest codes are cut down to `m` bits, then shorter codes grow until the Kraft sum is exact again
+	for (i=0;i<16;++i) c[i]=0;
+	for (i=0;i<k;++i) ++c[w[i]<m?w[i]:m];
+	for (j=0,i=1;i<=m;++i) j+=c[i]<<(m-i);
+	for (;j>1<<m;--j) { --c[m]; for (i=m-1;i>0;--i) if (c[i]) { --c[i],c[i+1]+=2; break; } }
+	for (j=m,i=0;j>0;--j) for (k=c[j];k>0;--k) l[a[i++]]=j; // the rarest symbols receive the longest codes
+}
+int huff_lenindex(int len) { if (len<11) return len-2; if (len>=258) return 29; int n=log2u8(len-3)*4-3; return n+((len-puff_len_k[0][n])>>puff_len_k[1][n]); }
+int huff_offindex(int off) { if (off< 5) return off-1; int n=log2u16(off-1)*2; return n+((off-puff_off_k[0][n])>>puff_off_k[1][n]); }
+// the dynamic Huffman encoding must write down the items of the block and their frequencies before sending anything
+#define HUFF_ITEMS 16384 // items per block
+int *huff_item,huff_items,huff_bytes,huff_len_f[286],huff_off_f[30]; // items: literal 0..255, or offset*512+length (3..258)
+void huff_item1(int k) { ++huff_len_f[huff_item[huff_items++]=k],++huff_bytes; } // add one literal
+void huff_item2(int m,int r) // add one length:offset pair
+	{ ++huff_len_f[256+huff_lenindex(m)],++huff_off_f[huff_offindex(r)],huff_item[huff_items++]=(r<<9)+m,huff_bytes+=m; }
+int huff_header(int *t,char *l,int n) // turns the bit counts `l[n]` into RFC1951 header codes `t` (CODE+EXTRA*32); returns the amount of codes
+{
+	int k=0; for (int i=0,j,x,z;i<n;i=j)
+	{
+		for (x=l[i],j=i+1;j<n&&l[j]==x;) ++j;
+		if (z=j-i,!x) // zeros: 18 stores 11..138, 17 stores 3..10
+		{
+			while (z>=11) { int y=z>138?138:z; t[k++]=18+((y-11)<<5),z-=y; }
+			if (z>=3) t[k++]=17+((z-3)<<5),z=0;
+		}
+		else // other values: 16 repeats the last value 3..6 times
+			for (t[k++]=x,--z;z>=3;) { int y=z>6?6:z; t[k++]=16+((y-3)<<5),z-=y; }
+		while (z>0) t[k++]=x,--z;
+	}
+	return k;
+}
+int huff_block(const BYTE *s,int q) // sends the items of the source `s` as a stored, static or dynamic block, whatever is shorter; `q` is final; 0 OK, !0 ERROR
+{
+	int e=0,i,j,k,len,off,hdr[286+30],cnt_f[19],cnt_c[19]; char cnt_l[19],l[286+30];
+	++huff_len_f[256]; // the end marker
+	for (i=1;i<30;++i) e+=huff_len_f[256+i]*puff_len_k[1][i]+huff_off_f[i]*puff_off_k[1][i]; // extra bits
+	huff_lengths(puff_cnt_c,huff_len_f,286,15),huff_lengths(puff_cnt_c+288,huff_off_f,30,15);
+	for (len=286;len>257&&!puff_cnt_c[len-1];) --len; // HLIT
+	for (off=30;off>1&&!puff_cnt_c[288+off-1];) --off; // HDIST
+	memcpy(l,puff_cnt_c,len),memcpy(l+len,puff_cnt_c+288,off);
+	for (k=huff_header(hdr,l,len+off),i=0;i<19;++i) cnt_f[i]=0;
+	for (i=0;i<k;++i) ++cnt_f[hdr[i]&31];
+	huff_lengths(cnt_l,cnt_f,19,7);
+	for (j=19;j>4&&!cnt_l[puff_cnt_k[j-1]];) --j; // HCLEN
+	int zd=3+5+5+4+j*3+cnt_f[16]*2+cnt_f[17]*3+cnt_f[18]*7+e,zs=3+e,zz=huff_bytes*8+(huff_bytes/65535+1)*(3+7+32); // dynamic, static and stored sizes
+	for (i=0;i<19;++i) zd+=cnt_f[i]*cnt_l[i];
+	for (i=0;i<286;++i) zd+=huff_len_f[i]*puff_cnt_c[i],zs+=huff_len_f[i]*(i<144?8:i<256?9:i<280?7:8);
+	for (i=0;i<30;++i) zd+=huff_off_f[i]*puff_cnt_c[288+i],zs+=huff_off_f[i]*5;
+	if (zz<zd&&zz<zs) // stored block(s)
+	{
+		if (((zz+puff_bits)>>3)+1>puff_size) return -1; // target overflow!
+		for (i=huff_bytes;;)
+		{
+			k=i>65535?65535:i; huff_send(3,q&&k==i),huff_send((8-puff_bits)&7,0); // drop any bits left
+			*puff_data++=k,*puff_data++=k>>8,*puff_data++=~k,*puff_data++=~k>>8,memcpy(puff_data,s,k),puff_data+=k,s+=k,puff_size-=k+4;
+			if (!(i-=k)) break;
+		}
+	}
+	else
+	{
+		if (zs<=zd) // static block
+		{
+			if (((zs+puff_bits)>>3)+1>puff_size) return -1; // target overflow!
+			huff_send(3,q+2),puff_default(); // default static Huffman tables
+			huff_tables(puff_len_c,puff_cnt_c,288),huff_tables(puff_off_c,puff_cnt_c+288,32);
+		}
+		else // dynamic block
+		{
+			if (((zd+puff_bits)>>3)+1>puff_size) return -1; // target overflow!
+			huff_send(3,q+4),huff_send(5,len-257),huff_send(5,off-1),huff_send(4,j-4);
+			for (i=0;i<j;++i) huff_send(3,cnt_l[puff_cnt_k[i]]);
+			huff_tables(cnt_c,cnt_l,19);
+			for (i=0;i<k;++i) if (huff_encode(cnt_c,hdr[i]&31),(hdr[i]&31)>15)
+				huff_send((hdr[i]&31)==16?2:(hdr[i]&31)==17?3:7,hdr[i]>>5);
+			huff_tables(puff_len_c,puff_cnt_c,286),huff_tables(puff_off_c,puff_cnt_c+288,30);
+		}
+		for (i=0;i<huff_items;++i)
+			if ((k=huff_item[i])<256) huff_encode(puff_len_c,k); // literal
+			else // length:offset pair
+			{
+				j=huff_lenindex(k&511),huff_encode(puff_len_c,256+j),huff_append(puff_len_k,j,k&511);
+				j=huff_offindex(k>>9),huff_encode(puff_off_c,    j),huff_append(puff_off_k,j,k>>9);
+			}
+		huff_encode(puff_len_c,256); // store end marker
+	}
+	memset(huff_len_f,0,sizeof(huff_len_f)),memset(huff_off_f,0,sizeof(huff_off_f));
+	return huff_items=huff_bytes=0;
+}
+#define DEFLATE_ALLOC (32768+HUFF_ITEMS)
+int huff_dynamic(BYTE *t,int o,BYTE *s,int i) // the dynamic compression of DEFLATE, with lazy matching; >=0 output length, <0 ERROR!
 {
 	puff_data=t,puff_size=o,puff_word=puff_bits=0; // beware, a bitstream isn't a bytestream!
 	int *hh=(int*)session_h16lz; if (!hh) return -1; // no memory!
-	int p=0,h=p; int *pp=hh+H16MAX; // the table is too big to be local or static, but without it
+	int p=0,h=p,b=p; int *pp=hh+H16MAX; huff_item=pp+32768; // the tables are too big to be local or static, but without them
 	for (int q=0;q<H16MAX+32768;++q) hh[q]=~32768; // compression would be just too slow!
-	// in static compression, default sizes are assumed, and no Huffman analysis is performed
-	huff_send(3,3); // tag the single block as final static ("3,5" would be final dynamic)
-	puff_default(); // default static Huffman tables
-	huff_tables(puff_len_c,puff_cnt_c,288); // 288 codes, but the last two are reserved
-	huff_tables(puff_off_c,puff_cnt_c+288,32); // ditto, 32 codes but only 30 are valid
-	while (puff_size>5&&i>=p+3) // target overflow! // the minimum match length is 3 bytes, a match can't begin any later!
-	{
-		int len=0,off=p+258,n=p-32768; const BYTE *x=s+(off<i?off:i);
-		for (int e=32768>>3,q=hh[H16TRI(s,p)];q>=n&&e>0;e-=256>>DEFLATE_LEVEL,q=pp[q&32767]) // search for matches
-		{
-			//if (pp[q&32767]>=q) { cprintf("DEFLATE 32K hash bug!\n"); break; } // can this ever happen!?
-			const BYTE *cmp1=s+q,*cmp2=s+p; if (cmp1[len]==cmp2[len]) // can this match be an improvement?
-				{ { while (*cmp1==*cmp2&&++cmp2<x) ++cmp1; } int z=cmp2-s-p; if (len<z) if (len=z,off=p-q,cmp2>=x) break; }
-		}
-		if (len>=(off>32*64?4:3)) // was there a match? is it beneficial? (empirical 24*64<<<x<=32*64; one case favours 29, another 31, another one 32...)
+	memset(huff_len_f,0,sizeof(huff_len_f)),memset(huff_off_f,0,sizeof(huff_off_f)),huff_items=huff_bytes=0;
+	const int *v=huff_levels[huff_level<1?1:huff_level>9?9:huff_level];
+	int len,off,lzy=0,lzo=0,a=0; // the lazy match: length, offset and whether the byte before the cursor is still pending
+	while (p<i)
+	{
+		if (huff_items>=HUFF_ITEMS-1) // is the block full? (we need room for one more item at the end)
+			{ if (huff_block(s+b,0)) return -1; b=p-a; } // target overflow!
+		for (;h<p&&h+3<=i;++h) { int q=H16TRI(s,h); pp[h&32767]=hh[q],hh[q]=h; } // walk hash table; the last two bytes cannot be hashed!
+		len=2,off=0; if (p+3<=i&&(!v[1]||lzy<v[1])) // the minimum match length is 3 bytes; a long enough lazy match stops the search
 		{
-			p+=len; // greedy algorithm: grab the longest match and move on
-			if (len<11) n=len-2; else if (len>=258) n=29; else n=log2u8(len-3)*4-3,n+=(len-puff_len_k[0][n])>>puff_len_k[1][n];
-			huff_encode(puff_len_c,256+n),huff_append(puff_len_k,n,len);
-			if (off< 5) n=off-1; else n=log2u16(off-1)*2 ,n+=(off-puff_off_k[0][n])>>puff_off_k[1][n];
-			huff_encode(puff_off_c,    n),huff_append(puff_off_k,n,off);
+			int n=p-32768,e=v[3]; const BYTE *x=s+(p+258<i?p+258:i);
+			if (lzy>=v[0]) e>>=2; // the lazy match is already good, search less
+			for (int q=hh[H16TRI(s,p)];q>=n&&e>0;--e,q=pp[q&32767]) // search for matches
+			{
+				const BYTE *cmp1=s+q,*cmp2=s+p; if (cmp1[len]==cmp2[len]) // can this match be an improvement?
+					{ { while (*cmp1==*cmp2&&++cmp2<x) ++cmp1; } int z=cmp2-s-p; if (len<z) if (len=z,off=p-q,cmp2>=x||z>=v[2]) break; }
+			}
+			if (len==3&&off>4096) len=2; // a short match so far away isn't beneficial
 		}
-		else huff_encode(puff_len_c,s[p++]); // too short, store a literal
-		while (h<p) { int q=H16TRI(s,h); pp[h&32767]=hh[q],hh[q]=h,++h; } // walk hash table
+		if (!v[1]) // greedy algorithm: grab the longest match and move on
+			{ if (len>2) huff_item2(len,off),p+=len; else huff_item1(s[p++]); }
+		else if (lzy>2&&len<=lzy) // lazy algorithm: the match at the last byte is still the best one
+			huff_item2(lzy,lzo),p+=lzy-1,lzy=a=0;
+		else // the match at the current byte (if any) is better: the last byte becomes a literal, and this match waits
+			{ if (a) huff_item1(s[p-1]); a=1,lzy=len,lzo=off,++p; }
 	}
-	if ((i-p)*2+6>puff_size) return -1; // target overflow!
-	while (p<i) huff_encode(puff_len_c,s[p++]); // last bytes (if any) are always literals
-	huff_encode(puff_len_c,256); huff_flush(); return puff_data-t; // store end marker
+	if (a) huff_item1(s[p-1]); // the last byte, if still pending
+	if (huff_block(s+b,1)) return -1; // target overflow!
+	huff_flush(); return puff_size<0?-1:puff_data-t;
 }
 int huff_main(BYTE *t,int o,BYTE *s,int i) // deflates source into target; >=0 output length, <0 ERROR!
-	{ int z=huff_static(t,o,s,i); return z<0?huff_stored(t,o,s,i):z; } // fall back to storage!
+	{ int z=huff_dynamic(t,o,s,i); return z<0?huff_stored(t,o,s,i):z; } // fall back to storage!
 #else // if you must save DEFLATE data but don't want to perform any compression at all
 #define huff_main huff_stored
 #endif
@@ -1435,6 +1929,20 @@ int puff_head(void) // reads a ZIP file header, if any; 0 OK, !0 ERROR
 	#endif
 	return 0;
 }
+#ifdef HEADLESS
+int puff_bench(BYTE *t,int o,BYTE *s,int i) // `-bbb` also measures how fast every file from an archive gets inflated
+{
+	if ((o=puff_main(t,o,s,i))>=0&&session_benchmark>2)
+	{
+		int n=0,tt=session_ticks(),q;
+		do puff_main(t,o,s,i); while (++n,(q=session_ticks()-tt)<100); // repeat it as many times as we can in a tenth of second
+		fprintf(stderr,"#%d: inflate %s, %d:%d bytes, %d.%03d ms, %d MB/s\n",session_instance,puff_name,i,o,q/n,q*1000/n%1000,(int)((long long)o*n/q/1000));
+	}
+	return o;
+}
+#else
+#define puff_bench puff_main
+#endif
 int puff_body(int q) // loads (!0) or skips (0) a ZIP file body; 0 OK, !0 ERROR
 {
 	if (!puff_file) return -1;
@@ -1445,7 +1953,7 @@ int puff_body(int q) // loads (!0) or skips (0) a ZIP file body; 0 OK, !0 ERROR
 			return -1; // cannot get data from nothing! cannot write negative data!
 		if (puff_gz_q)
 			return fseek(puff_file,puff_diff+puff_skip,SEEK_SET),
-				puff_main(puff_tgt,puff_tgtl,puff_src,fread1(puff_src,puff_srcl,puff_file))!=puff_tgtl;
+				puff_bench(puff_tgt,puff_tgtl,puff_src,fread1(puff_src,puff_srcl,puff_file))!=puff_tgtl;
 		unsigned char h[30];
 		fseek(puff_file,puff_diff+puff_skip,SEEK_SET);
 		fread1(h,sizeof(h),puff_file);
@@ -1455,7 +1963,7 @@ int puff_body(int q) // loads (!0) or skips (0) a ZIP file body; 0 OK, !0 ERROR
 			if (!puff_type)
 				return fread1(puff_tgt,puff_srcl,puff_file)!=puff_tgtl;
 			if (puff_type==8)
-				return puff_main(puff_tgt,puff_tgtl,puff_src,fread1(puff_src,puff_srcl,puff_file))!=puff_tgtl;
+				return puff_bench(puff_tgt,puff_tgtl,puff_src,fread1(puff_src,puff_srcl,puff_file))!=puff_tgtl;
 		}
 	}
 	return q; // 0 skipped=OK, !0 unknown=ERROR
@@ -1463,6 +1971,9 @@ int puff_body(int q) // loads (!0) or skips (0) a ZIP file body; 0 OK, !0 ERROR
 // ZIP-aware fopen()
 const char puff_pattern[]="*.gz;*.zip",PUFF_STR[]={PATHCHAR,PATHCHAR,PATHCHAR,0}; char puff_path[STRMAX]; // i.e. "TREE/PATH///ARCHIVE/FILE"
 FILE *puff_ffile=NULL; int puff_fshut=0; // used to know whether to keep a file that gets repeatedly open
+#ifndef _WIN32 // POSIX can keep the inflated data in memory, without any temporary files; the buffer of `fmemopen(NULL...)`
+#define PUFF_FMEMOPEN // belongs to the file itself and fclose() frees it, so there's nothing to track and nothing can leak
+#endif
 FILE *puff_fopen(char *s,const char *m) // mimics fopen(), so NULL on error, *FILE otherwise
 {
 	if (!s||!m) return NULL; // wrong parameters!
@@ -1486,7 +1997,10 @@ FILE *puff_fopen(char *s,const char *m) // mimics fopen(), so NULL on error, *FI
 		if (!strcmp(puff_name,z))
 		#endif
 		{
-			#ifdef __MSVCRT__ // MSVCRT.DLL: tmpfile() ignores the TEMP variable and fails on read-only drives, but fopen() gives us the flags "TD"
+			#ifdef PUFF_FMEMOPEN
+			if (!puff_tgtl||!(puff_ffile=fmemopen(NULL,puff_tgtl,"wb+"))) // fmemopen() can't hold empty files, but tmpfile() can
+				if (!(puff_ffile=tmpfile()))
+			#elif defined(__MSVCRT__) // MSVCRT.DLL: tmpfile() ignores the TEMP variable and fails on read-only drives, but fopen() gives us the flags "TD"
 			static char f[STRMAX]="",g[STRMAX]; if (!*f) GetTempPath(STRMAX,f); // do it just once
 			if (!(puff_ffile=GetTempFileName(f,"zip",0,g)?fopen(g,"wb+TD"):NULL)) // "TD" = _O_SHORTLIVED | _O_TEMPORARY
 			#else
@@ -1494,10 +2008,10 @@ FILE *puff_fopen(char *s,const char *m) // mimics fopen(), so NULL on error, *FI
 			#endif
 				return puff_close(),NULL; // file failure!
 			puff_src=puff_tgt=NULL;
-			if (!(!puff_type||(puff_src=malloc(puff_srcl)))||!(puff_tgt=malloc(puff_tgtl))
+			if (!(!puff_type||(puff_src=malloc(puff_srcl)))||!(puff_tgt=malloc(puff_tgtl+1)) // `+1`: malloc(0) may return NULL
 				||puff_body(1)||(puff_ccitt32(puff_tgt,puff_tgtl)^puff_hash))
 				fclose(puff_ffile),puff_ffile=NULL; // memory or data failure!
-			if (puff_ffile)
+			else
 				fwrite1(puff_tgt,puff_tgtl,puff_ffile),fseek(puff_ffile,0,SEEK_SET); // fopen() expects ftell()=0!
 			if (puff_src) free(puff_src); // free if allocated
 			if (puff_tgt) free(puff_tgt); // free if allocated
@@ -1514,7 +2028,7 @@ FILE *puff_fopen(char *s,const char *m) // mimics fopen(), so NULL on error, *FI
 int puff_fclose(FILE *f)
 	{ return (f==puff_ffile)?(puff_fshut=1),0:fclose(f); } // delay closing to allow same-file recycling
 void puff_byebye(void)
-	{ if (puff_ffile) fclose(puff_ffile),puff_ffile=NULL; } // cleanup of tmpfile() is done by the runtime
+	{ if (puff_ffile) fclose(puff_ffile),puff_ffile=NULL; }
 
 // ZIP-aware user interfaces
 char *puff_session_subdialog(char *r,const char *s,const char *t,char *zz,int qq) // let the user pick a file within a ZIP archive ('r' ZIP path, 's' pattern, 't' title, 'zz' default file or NULL); NULL for cancel, 'r' (with full path) for OK
@@ -1636,7 +2150,7 @@ void onscreen_byte(int x,int y,int a,int q) // write two decimal digits
 void session_status(void) // print common onscreen status elements
 {
 	#ifdef DEBUG
-	if (session_audio) // Win32 audio cycle / SDL2 audio queue
+	if (session_audio) // Win32 audio cycle / SDL2 audio ring
 		onscreen_hgauge(+1,-5,1<<(AUDIO_L2BUFFER-10),1,(audio_session/AUDIO_BYTESTEP)>>10);
 	#endif
 	if (!audio_disabled)
@@ -2466,8 +2980,16 @@ AUDIO_UNIT *session_filmaudio=NULL; // beware! AUDIO_LENGTH_Z is variable if the
 BYTE *xrf_chunk=NULL; // this buffer contains one video frame and two audio frames AFTER encoding
 BYTE session_filmdirt,session_filmboth=0; // used to detect skipped frames and to downmix stereo to mono
 
+// the emulation merely copies each frame into a ring of slots; a background thread does the deltas, the encoding and the
+// writing. When the ring is full the emulation must wait for the encoder: the caption shows the busy slots and the waits.
+#define SESSION_FILMRINGS 4 // frames in the queue
+struct { VIDEO_UNIT *v; AUDIO_UNIT *a; int n,l; } session_filmring[SESSION_FILMRINGS]; // `n` pixels (0 = skipped frame, <0 = end of film) and `l` samples
+SESSION_THREADID session_filmthread; SESSION_SEMAPHORE session_filmfree,session_filmfull; // the encoder and its ring
+volatile int session_filmdone; int session_filmsent,session_filmnext,session_filmwaits; BYTE session_filmasync=0; // ring status
+
 #if 1 // experimental support for additional encodings!!
-#define SESSION_FILMCHUNKS (sizeof(SESSION_FILMVIDEOS)+sizeof(SESSION_FILMAUDIOS)+8*8)
+#define SESSION_FILMSTRIPES 8 // XRF3 cuts every colour plane into horizontal stripes that can be encoded and decoded apart
+#define SESSION_FILMCHUNKS (sizeof(SESSION_FILMVIDEOS)+sizeof(SESSION_FILMAUDIOS)+8*8+1+3*4*SESSION_FILMSTRIPES)
 void xrf_encodebool(BYTE **t,BYTE *a,BYTE **b,int n) // write "0" (zero) or "1" (nonzero)
 	{ { if (UNLIKELY(!(*a>>=1))) *(*b=(*t)++)=0,*a=128; } if (n) **b|=*a; }
 void xrf_encodegamma(BYTE **t,BYTE *a,BYTE **b,int n) // kind-of Elias Gamma code: [1a[1b[1c[..]]]]0 = 1[a[b[c[..]]]]
@@ -2490,6 +3012,7 @@ int xrf_encode(BYTE *t,BYTE *s,int l,int x) // the second terribly hacky encoder
 	{ for (k=3;k;--k) xrf_encodebool(&t,&a,&b,0); } return *t++=0,t-u; // end marker: long zero!
 }
 #else
+#define SESSION_FILMSTRIPES 0 // XRF1 is always a single stripe
 #define SESSION_FILMCHUNKS ((sizeof(SESSION_FILMVIDEOS)+sizeof(SESSION_FILMAUDIOS))*19/16+8*4)
 void xrf_encodebyte(BYTE **t,BYTE *a,BYTE **b,int n) // write "0" (zero) or "1nnnnnnnn" (nonzero)
 {
@@ -2524,6 +3047,42 @@ int xrf_encode(BYTE *t,BYTE *s,int l,int x) // terribly hacky encoder based on a
 }
 #endif
 
+#if SESSION_FILMSTRIPES
+// the chunks of a XRF3 film begin with the amount of stripes (0 if the frame didn't change), then the lengths of all the
+// streams (stripes of B, stripes of G, stripes of R) and then the streams themselves; the audio doesn't change at all.
+// The encoder shares the stripes with up to SESSION_FILMHELPERS threads: thread `h` encodes the streams `h`, `h+1+helpers`...
+#define SESSION_FILMHELPERS 7
+#define SESSION_FILMSTREAMS (VIDEO_PIXELS_X*(VIDEO_PIXELS_Y/SESSION_FILMSTRIPES+1)*2+16) // maximum length of one stream
+BYTE *xrf_stripe=NULL; int xrf_stripes[3*SESSION_FILMSTRIPES],xrf_stripen,xrf_stripew; // streams, their lengths, pixels per frame and per line
+SESSION_THREADID session_filmhelper[SESSION_FILMHELPERS]; SESSION_SEMAPHORE session_filmgo[SESSION_FILMHELPERS],session_filmend;
+int session_filmhelpers=0; volatile BYTE session_filmquit;
+void xrf_encodestripes(int h) // encode the streams of the thread `h`
+{
+	int r=(xrf_stripen/xrf_stripew+SESSION_FILMSTRIPES-1)/SESSION_FILMSTRIPES*xrf_stripew; // pixels per stripe
+	for (int j=h;j<3*SESSION_FILMSTRIPES;j+=session_filmhelpers+1)
+	{
+		int k=j%SESSION_FILMSTRIPES*r,l=xrf_stripen-k; if (l>r) l=r; else if (l<0) l=k=0;
+		#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		xrf_stripes[j]=xrf_encode(&xrf_stripe[j*SESSION_FILMSTREAMS],&((BYTE*)&session_filmvideo[k])[3-j/SESSION_FILMSTRIPES],l,4);
+		#else
+		xrf_stripes[j]=xrf_encode(&xrf_stripe[j*SESSION_FILMSTREAMS],&((BYTE*)&session_filmvideo[k])[j/SESSION_FILMSTRIPES],l,4);
+		#endif
+	}
+}
+SESSION_THREAD(session_filmhelp) // encode a share of the streams whenever the encoder asks for it
+{
+	for (int h=(int)(size_t)session_thread_data;;)
+	{
+		session_semaphorewait(session_filmgo[h-1]);
+		if (session_filmquit) break; // end of film!
+		xrf_encodestripes(h);
+		session_semaphorepost(session_filmend);
+	}
+	return 0;
+}
+#endif
+
+SESSION_THREAD(session_filmworker); // see below
 int session_createfilm(void) // start recording video and audio; 0 OK, !0 ERROR
 {
 	if (session_filmfile) return 1; // file already open!
@@ -2533,12 +3092,20 @@ int session_createfilm(void) // start recording video and audio; 0 OK, !0 ERROR
 		return 1; // cannot allocate buffer!
 	if (!xrf_chunk&&!(xrf_chunk=malloc(SESSION_FILMCHUNKS))) // maximum pathological length!
 		return 1; // cannot allocate memory!
+	#if SESSION_FILMSTRIPES
+	if (!xrf_stripe&&!(xrf_stripe=malloc(3*SESSION_FILMSTRIPES*SESSION_FILMSTREAMS)))
+		return 1; // cannot allocate memory!
+	#endif
+	for (int i=0;i<SESSION_FILMRINGS;++i)
+		if (!session_filmring[i].v&&!(session_filmring[i].v=malloc(sizeof(SESSION_FILMVIDEOS)+sizeof(SESSION_FILMAUDIOS))))
+			return 1; // cannot allocate buffer!
+		else session_filmring[i].a=(AUDIO_UNIT*)&session_filmring[i].v[VIDEO_PIXELS_X*VIDEO_PIXELS_Y];
 	if (!(session_nextfilm=session_savenext("%s%08u.xrf",session_nextfilm))) // "Xor-Rle Film"
 		return 1; // too many files!
 	if (!(session_filmfile=fopen(session_parmtr,"wb")))
 		return 1; // cannot create file!
-	#if 1 // experimental support for additional encodings!!
-	fwrite1("XRF2!\015\012\032",8,session_filmfile);
+	#if SESSION_FILMSTRIPES // experimental support for additional encodings!!
+	fwrite1("XRF3!\015\012\032",8,session_filmfile);
 	#else
 	fwrite1("XRF1!\015\012\032",8,session_filmfile);
 	#endif
@@ -2551,137 +3118,224 @@ int session_createfilm(void) // start recording video and audio; 0 OK, !0 ERROR
 	fputc(((AUDIO_BITDEPTH>>session_wavedepth)>8?1:0)+(session_filmboth?2:0)+(session_filmhalf?4:0),session_filmfile);
 	kputmmmm(0,session_filmfile); // frame count, will be filled later
 	session_filmalign=video_pos_y; // catch scanline mode, if any
+	session_filmdone=session_filmsent=session_filmnext=session_filmwaits=0;
+	if (session_semaphoremake(session_filmfree,SESSION_FILMRINGS))
+		session_filmasync=0; // no semaphores, no thread: encode the frames on the spot
+	else if (session_semaphoremake(session_filmfull,0))
+		session_semaphorefree(session_filmfree),session_filmasync=0;
+	else if (session_threadmake(session_filmthread,session_filmworker,NULL))
+		session_semaphorefree(session_filmfull),session_semaphorefree(session_filmfree),session_filmasync=0;
+	else
+		session_filmasync=1;
+	#if SESSION_FILMSTRIPES
+	int h=session_cores()-1; if (h>SESSION_FILMHELPERS) h=SESSION_FILMHELPERS;
+	session_filmquit=session_filmhelpers=0; if (h>0&&!session_semaphoremake(session_filmend,0))
+	{
+		while (session_filmhelpers<h&&!session_semaphoremake(session_filmgo[session_filmhelpers],0))
+			if (session_threadmake(session_filmhelper[session_filmhelpers],session_filmhelp,(void*)(size_t)(session_filmhelpers+1)))
+				{ session_semaphorefree(session_filmgo[session_filmhelpers]); break; }
+			else ++session_filmhelpers;
+		if (!session_filmhelpers) session_semaphorefree(session_filmend); // no helpers, no need to wait for them
+	}
+	#endif
 	return memset(session_filmvideo,0,sizeof(SESSION_FILMVIDEOS)),
 		memset(session_filmaudio,0,sizeof(SESSION_FILMAUDIOS)),
 		session_filmdirt=session_filmcount=0;
 }
+void session_encodefilm(int i) // turn the frame in the slot `i` into a chunk and store it
+{
+	BYTE *z=xrf_chunk; int q=0,n=session_filmring[i].n;
+	{
+		VIDEO_UNIT *s=session_filmring[i].v,*t=session_filmvideo;
+		for (int j=0;j<n;++j)
+			q|=t[j]^=s[j]; // bitwise delta against last frame
+	}
+	if (!q) // identical frame?
+	{
+		#if SESSION_FILMSTRIPES
+		*z++=0; // no stripes at all
+		#else
+		z+=xrf_encode(z,NULL,0,0); // B
+		z+=xrf_encode(z,NULL,0,0); // G
+		z+=xrf_encode(z,NULL,0,0); // R
+		//z+=xrf_encode(z,NULL,0,0); // A!
+		#endif
+	}
+	#if SESSION_FILMSTRIPES
+	else
+	{
+		xrf_stripen=n,xrf_stripew=VIDEO_PIXELS_X>>session_filmscale;
+		for (int h=0;h<session_filmhelpers;++h) session_semaphorepost(session_filmgo[h]);
+		xrf_encodestripes(0); // the encoder does its own share too
+		for (int h=0;h<session_filmhelpers;++h) session_semaphorewait(session_filmend);
+		*z++=SESSION_FILMSTRIPES;
+		for (int j=0;j<3*SESSION_FILMSTRIPES;++j) mputmmmm(z,xrf_stripes[j]),z+=4;
+		for (int j=0;j<3*SESSION_FILMSTRIPES;++j) memcpy(z,&xrf_stripe[j*SESSION_FILMSTREAMS],xrf_stripes[j]),z+=xrf_stripes[j];
+	}
+	#else
+	else
+	{
+		// the compression relies on perfectly standard arrays, i.e. the stride of an array of DWORDs is always 4 bytes wide;
+		// are there any exotic platforms where the byte length of WORD/Uint16 and DWORD/Uint32 isn't strictly enforced?
+		#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+		z+=xrf_encode(z,&((BYTE*)session_filmvideo)[3],n,4); // B
+		z+=xrf_encode(z,&((BYTE*)session_filmvideo)[2],n,4); // G
+		z+=xrf_encode(z,&((BYTE*)session_filmvideo)[1],n,4); // R
+		//z+=xrf_encode(z,&((BYTE*)session_filmvideo)[0],n,4); // A!
+		#else
+		z+=xrf_encode(z,&((BYTE*)session_filmvideo)[0],n,4); // B
+		z+=xrf_encode(z,&((BYTE*)session_filmvideo)[1],n,4); // G
+		z+=xrf_encode(z,&((BYTE*)session_filmvideo)[2],n,4); // R
+		//z+=xrf_encode(z,&((BYTE*)session_filmvideo)[3],n,4); // A!
+		#endif
+	}
+	#endif
+	if (n) // remember to reverse the bitmaps!
+		MEMNCPY(session_filmvideo,session_filmring[i].v,n); // keep this frame for later
+	if (session_filmfreq) // audio?
+	{
+		BYTE *u=(BYTE*)session_filmring[i].a; int l=session_filmring[i].l;
+		#if AUDIO_CHANNELS > 1
+		#if AUDIO_BITDEPTH > 8
+			#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			if (session_wavedepth)
+			{
+				z+=xrf_encode(z,&u[0],l,-4); // L
+				if (session_filmboth)
+					z+=xrf_encode(z,&u[2],l,-4); // R
+			}
+			else
+			{
+				z+=xrf_encode(z,&u[1],l,4), // l
+				z+=xrf_encode(z,&u[0],l,4); // L
+				if (session_filmboth)
+					z+=xrf_encode(z,&u[3],l,4), // r
+					z+=xrf_encode(z,&u[2],l,4); // R
+			}
+			#else
+			if (session_wavedepth)
+			{
+				z+=xrf_encode(z,&u[1],l,-4); // L
+				if (session_filmboth)
+					z+=xrf_encode(z,&u[3],l,-4); // R
+			}
+			else
+			{
+				z+=xrf_encode(z,&u[0],l,4), // l
+				z+=xrf_encode(z,&u[1],l,4); // L
+				if (session_filmboth)
+					z+=xrf_encode(z,&u[2],l,4), // r
+					z+=xrf_encode(z,&u[3],l,4); // R
+			}
+			#endif
+		#else
+		z+=xrf_encode(z,&u[0],l,2); // L
+		if (session_filmboth)
+			z+=xrf_encode(z,&u[1],l,2); // R
+		#endif
+		#else
+		#if AUDIO_BITDEPTH > 8
+			#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+			if (session_wavedepth)
+				z+=xrf_encode(z,&u[0],l,-2); // M
+			else
+				z+=xrf_encode(z,&u[1],l,2), // m
+				z+=xrf_encode(z,&u[0],l,2); // M
+			#else
+			if (session_wavedepth)
+				z+=xrf_encode(z,&u[1],l,-2); // M
+			else
+				z+=xrf_encode(z,&u[0],l,2), // m
+				z+=xrf_encode(z,&u[1],l,2); // M
+			#endif
+		#else
+		z+=xrf_encode(z,&u[0],l,1); // M
+		#endif
+		#endif
+	}
+	fputmmmm(z-xrf_chunk,session_filmfile); // chunk size!
+	fwrite1(xrf_chunk,z-xrf_chunk,session_filmfile);
+}
+SESSION_THREAD(session_filmworker) // encode the frames in the ring as they come
+{
+	for (int i=0;;i=(i+1)%SESSION_FILMRINGS)
+	{
+		session_semaphorewait(session_filmfull);
+		if (session_filmring[i].n<0) break; // end of film!
+		session_encodefilm(i),++session_filmdone;
+		session_semaphorepost(session_filmfree);
+	}
+	return 0;
+}
 void session_writefilm(void) // record one frame of video and audio
 {
 	if (!session_filmfile) return; // file not open!
 	// ignore first frame if the video is interleaved and we're on the wrong half frame
 	if (!session_filmcount&&video_interlaced&&video_interlaces) return;
-	BYTE *z=xrf_chunk; if (!video_framecount) session_filmdirt=1; // frameskipping?
+	if (!video_framecount) session_filmdirt=1; // frameskipping?
 	if (!(++session_filmcount&session_filmtimer))
 	{
-		VIDEO_UNIT *s,*t; // notice that this backup doesn't include secondary scanlines
-		int q=0,n=0; if (session_filmdirt) // not a skipped frame?
-		{
-			if (t=session_filmvideo,session_filmscale)
-				for (int i=VIDEO_OFFSET_Y+(session_filmalign&1);s=session_getscanline(i),i<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;i+=2)
-					for (int j=0;j<VIDEO_PIXELS_X/2;++j)
-						q|=*t++^=*s++,++s; // bitwise delta against last frame
-			else // no scaling, copy
-				for (int i=VIDEO_OFFSET_Y;s=session_getscanline(i),i<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;i+=session_filmhalf+1)
-					for (int j=0;j<VIDEO_PIXELS_X;++j)
-						q|=*t++^=*s++; // bitwise delta against last frame
-			n=t-session_filmvideo;
-		}
-		if (!q) // identical frame?
-		{
-			z+=xrf_encode(z,NULL,0,0); // B
-			z+=xrf_encode(z,NULL,0,0); // G
-			z+=xrf_encode(z,NULL,0,0); // R
-			//z+=xrf_encode(z,NULL,0,0); // A!
-		}
-		else
-		{
-			// the compression relies on perfectly standard arrays, i.e. the stride of an array of DWORDs is always 4 bytes wide;
-			// are there any exotic platforms where the byte length of WORD/Uint16 and DWORD/Uint32 isn't strictly enforced?
-			#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-			z+=xrf_encode(z,&((BYTE*)session_filmvideo)[3],n,4); // B
-			z+=xrf_encode(z,&((BYTE*)session_filmvideo)[2],n,4); // G
-			z+=xrf_encode(z,&((BYTE*)session_filmvideo)[1],n,4); // R
-			//z+=xrf_encode(z,&((BYTE*)session_filmvideo)[0],n,4); // A!
-			#else
-			z+=xrf_encode(z,&((BYTE*)session_filmvideo)[0],n,4); // B
-			z+=xrf_encode(z,&((BYTE*)session_filmvideo)[1],n,4); // G
-			z+=xrf_encode(z,&((BYTE*)session_filmvideo)[2],n,4); // R
-			//z+=xrf_encode(z,&((BYTE*)session_filmvideo)[3],n,4); // A!
-			#endif
-		}
-		if (session_filmdirt) // remember to reverse the bitmaps!
+		if (session_filmasync&&session_semaphoretest(session_filmfree)) // is the ring full?
+			++session_filmwaits,session_semaphorewait(session_filmfree); // wait for the encoder!
+		int k=session_filmnext; VIDEO_UNIT *s,*t=session_filmring[k].v;
+		if (session_filmdirt) // not a skipped frame?
 		{
 			session_filmdirt=0; // to avoid encoding multiple times a frameskipped image
-			if (t=session_filmvideo,session_filmscale)
+			if (session_filmscale) // notice that this copy doesn't include secondary scanlines
 				for (int i=VIDEO_OFFSET_Y+(session_filmalign&1);s=session_getscanline(i),i<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;i+=2)
 					for (int j=0;j<VIDEO_PIXELS_X/2;++j)
-						*t++=*s++,++s; // keep this frame for later
+						*t++=*s++,++s; // scale this frame down
 			else // no scaling, copy
 				for (int i=VIDEO_OFFSET_Y;i<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;i+=session_filmhalf+1)
 					MEMNCPY(t,session_getscanline(i),VIDEO_PIXELS_X),t+=VIDEO_PIXELS_X;
 		}
+		session_filmring[k].n=t-session_filmring[k].v;
 		if (session_filmfreq) // audio?
 		{
-			BYTE *u=(BYTE*)audio_frame; int l=AUDIO_LENGTH_Z;
-			if (session_filmtimer)
-				u=(BYTE*)session_filmaudio,l*=2,memcpy(&session_filmaudio[AUDIO_LENGTH_Z*AUDIO_CHANNELS],audio_frame,AUDIO_LENGTH_Z*AUDIO_BYTESTEP); // glue both blocks!
-			#if AUDIO_CHANNELS > 1
-			#if AUDIO_BITDEPTH > 8
-				#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-				if (session_wavedepth)
-				{
-					z+=xrf_encode(z,&u[0],l,-4); // L
-					if (session_filmboth)
-						z+=xrf_encode(z,&u[2],l,-4); // R
-				}
-				else
-				{
-					z+=xrf_encode(z,&u[1],l,4), // l
-					z+=xrf_encode(z,&u[0],l,4); // L
-					if (session_filmboth)
-						z+=xrf_encode(z,&u[3],l,4), // r
-						z+=xrf_encode(z,&u[2],l,4); // R
-				}
-				#else
-				if (session_wavedepth)
-				{
-					z+=xrf_encode(z,&u[1],l,-4); // L
-					if (session_filmboth)
-						z+=xrf_encode(z,&u[3],l,-4); // R
-				}
-				else
-				{
-					z+=xrf_encode(z,&u[0],l,4), // l
-					z+=xrf_encode(z,&u[1],l,4); // L
-					if (session_filmboth)
-						z+=xrf_encode(z,&u[2],l,4), // r
-						z+=xrf_encode(z,&u[3],l,4); // R
-				}
-				#endif
-			#else
-			z+=xrf_encode(z,&u[0],l,2); // L
-			if (session_filmboth)
-				z+=xrf_encode(z,&u[1],l,2); // R
-			#endif
-			#else
-			#if AUDIO_BITDEPTH > 8
-				#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-				if (session_wavedepth)
-					z+=xrf_encode(z,&u[0],l,-2); // M
-				else
-					z+=xrf_encode(z,&u[1],l,2), // m
-					z+=xrf_encode(z,&u[0],l,2); // M
-				#else
-				if (session_wavedepth)
-					z+=xrf_encode(z,&u[1],l,-2); // M
-				else
-					z+=xrf_encode(z,&u[0],l,2), // m
-					z+=xrf_encode(z,&u[1],l,2); // M
-				#endif
-			#else
-			z+=xrf_encode(z,&u[0],l,1); // M
-			#endif
-			#endif
+			if (session_filmring[k].l=AUDIO_LENGTH_Z,session_filmtimer) // glue both blocks!
+				memcpy(session_filmring[k].a,session_filmaudio,AUDIO_LENGTH_Z*AUDIO_BYTESTEP),
+				memcpy(&session_filmring[k].a[AUDIO_LENGTH_Z*AUDIO_CHANNELS],audio_frame,AUDIO_LENGTH_Z*AUDIO_BYTESTEP),
+				session_filmring[k].l*=2;
+			else
+				memcpy(session_filmring[k].a,audio_frame,AUDIO_LENGTH_Z*AUDIO_BYTESTEP);
 		}
-		fputmmmm(z-xrf_chunk,session_filmfile); // chunk size!
-		fwrite1(xrf_chunk,z-xrf_chunk,session_filmfile);
+		session_filmnext=(k+1)%SESSION_FILMRINGS,++session_filmsent;
+		if (session_filmasync)
+			session_semaphorepost(session_filmfull); // wake the encoder up
+		else
+			session_encodefilm(k),++session_filmdone;
 	}
 	else if (session_filmfreq) // audio?
 		memcpy(session_filmaudio,audio_frame,AUDIO_LENGTH_Z*AUDIO_BYTESTEP); // keep audio block for later!
 	session_filmalign=video_pos_y;
 }
+char *session_filminfo(void) // busy slots of the ring and waits since the last call; empty if we aren't recording
+{
+	static char s[32]; if (!session_filmfile) return "";
+	sprintf(s," | XRF %d/%d:%d",session_filmsent-session_filmdone,SESSION_FILMRINGS,session_filmwaits);
+	return session_filmwaits=0,s;
+}
 int session_closefilm(void) // stop recording video and audio; 0 OK, !0 ERROR
 {
+	if (session_filmasync) // flush the ring and stop the encoder
+	{
+		session_semaphorewait(session_filmfree);
+		session_filmring[session_filmnext].n=-1; session_semaphorepost(session_filmfull);
+		session_threadwait(session_filmthread);
+		session_semaphorefree(session_filmfull),session_semaphorefree(session_filmfree),session_filmasync=0;
+	}
+	#if SESSION_FILMSTRIPES
+	if (session_filmhelpers) // stop the helpers as well
+	{
+		session_filmquit=1;
+		for (int h=0;h<session_filmhelpers;++h) session_semaphorepost(session_filmgo[h]);
+		for (int h=0;h<session_filmhelpers;++h) session_threadwait(session_filmhelper[h]),session_semaphorefree(session_filmgo[h]);
+		session_semaphorefree(session_filmend),session_filmhelpers=0;
+	}
+	if (xrf_stripe) free(xrf_stripe),xrf_stripe=NULL;
+	#endif
+	for (int i=0;i<SESSION_FILMRINGS;++i)
+		if (session_filmring[i].v) free(session_filmring[i].v),session_filmring[i].v=NULL;
 	if (session_filmvideo) free(session_filmvideo),session_filmvideo=NULL;
 	if (session_filmaudio) free(session_filmaudio),session_filmaudio=NULL;
 	if (xrf_chunk) free(xrf_chunk),xrf_chunk=NULL;
@@ -2691,6 +3345,45 @@ int session_closefilm(void) // stop recording video and audio; 0 OK, !0 ERROR
 	return fclose(session_filmfile),session_filmfile=NULL,0;
 }
 
+// multimedia: raw video and audio streams -------------------------- //
+
+// headless sessions can stream their frames to external encoders that read them as they're made:
+// video is the visible part of `video_frame` as it is (32-bit pixels) and audio is `audio_frame` (PCM).
+// There are no headers at all; the encoder learns the format from the hints printed on the first frame.
+FILE *session_openstream(char *s,int *j) // open the file descriptor written in `s` from `*j` on; NULL ERROR
+{
+	int d=0; if (s[*j]<'0'||s[*j]>'9') return NULL;
+	while (s[*j]>='0'&&s[*j]<='9') d=d*10+s[(*j)++]-'0';
+	return fdopen(d,"wb");
+}
+void session_writestream(void)
+{
+	static BYTE q=0; if (!q) // first frame? set the buffers up and show the formats
+	{
+		q=1; if (session_streamv)
+		{
+			setvbuf(session_streamv,NULL,_IOFBF,VIDEO_PIXELS_X*VIDEO_PIXELS_Y*sizeof(VIDEO_UNIT)); // a frame at a time
+			fprintf(stderr,"video stream: -f rawvideo -pix_fmt %s -s %dx%d -r %d\n",SDL_BYTEORDER==SDL_BIG_ENDIAN?"0rgb":"bgr0",
+				VIDEO_PIXELS_X,VIDEO_PIXELS_Y,VIDEO_PLAYBACK);
+		}
+		if (session_streama)
+			fprintf(stderr,"audio stream: -f %s -ar %d -ac %d\n",AUDIO_BITDEPTH<=8?"u8":SDL_BYTEORDER==SDL_BIG_ENDIAN?"s16be":"s16le",
+				AUDIO_PLAYBACK,AUDIO_CHANNELS);
+	}
+	if (session_streamv) // no intermediate copies: the scanlines go straight from the frame to the stream
+		for (int i=VIDEO_OFFSET_Y;i<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;++i)
+			if (fwrite1(session_getscanline(i),VIDEO_PIXELS_X*sizeof(VIDEO_UNIT),session_streamv)!=VIDEO_PIXELS_X*sizeof(VIDEO_UNIT))
+				{ fclose(session_streamv),session_streamv=NULL; break; } // the encoder is gone!
+	if (session_streama)
+		if (fwrite1(audio_frame,AUDIO_LENGTH_Z*AUDIO_BYTESTEP,session_streama)!=AUDIO_LENGTH_Z*AUDIO_BYTESTEP)
+			fclose(session_streama),session_streama=NULL; // ditto!
+}
+void session_closestream(void)
+{
+	if (session_streamv) fclose(session_streamv),session_streamv=NULL;
+	if (session_streama) fclose(session_streama),session_streama=NULL;
+}
+
 // multimedia: screenshot output ------------------------------------ //
 // warning: the following code assumes that VIDEO_UNIT is DWORD 0X00RRGGBB!
 
@@ -2860,6 +3553,40 @@ int session_scrn_exit(void)
 
 #endif
 
+#ifdef HEADLESS
+void session_benchscrn(void) // `-bbb` also saves the last frame as a PNG screenshot in memory at every compression level
+{
+	#if defined(PNG_OUTPUT_MODE) && DEFLATE_LEVEL > 0
+	if (!video_pos_z||session_scrn_init(VIDEO_PIXELS_X,VIDEO_PIXELS_Y)<0) return;
+	for (int i=VIDEO_OFFSET_Y;i<VIDEO_OFFSET_Y+VIDEO_PIXELS_Y;++i)
+		session_scrn_line(session_getscanline(i),VIDEO_PIXELS_X,1);
+	int l=huff_level; for (huff_level=1;huff_level<=9;++huff_level)
+	{
+		int t,z,n=0,tt=session_ticks();
+		do z=huff_zlib(session_scrn_temp+41,session_png3_size,session_png3_mini,session_png3_hash); // repeat it as many times as we can in a tenth of second
+		while (++n,(t=session_ticks()-tt)<100);
+		fprintf(stderr,"#%d: deflate level %d, %d:%d bytes (%d.%d%%), %d.%03d ms, %d MB/s\n",session_instance,huff_level,session_png3_hash,z,
+			z*100/session_png3_hash,z*1000/session_png3_hash%10,t/n,t*1000/n%1000,(int)((long long)session_png3_hash*n/t/1000));
+	}
+	huff_level=l;
+	ccitt32(0,NULL,0); l=ccitt32_fast; for (int j=0;j<=l+1;++j) // checksums: the CRC-32 tables, the CRC-32 hardware if any, Adler-32
+	{
+		int t,n=0,tt=session_ticks(); ccitt32_fast=j&1; unsigned int z;
+		do z=j>l?puff_adler32(session_png3_mini,session_png3_hash):puff_ccitt32(session_png3_mini,session_png3_hash);
+		while (++n,(t=session_ticks()-tt)<100);
+		#ifdef CCITT32_FAST
+		char *s=j>l?"Adler-32":j?"CRC-32 " CCITT32_FAST:"CRC-32 slicing-by-8";
+		#else
+		char *s=j>l?"Adler-32":"CRC-32 slicing-by-8";
+		#endif
+		fprintf(stderr,"#%d: checksum %s, %d bytes, %d.%03d ms, %d MB/s (%08X)\n",session_instance,s,
+			session_png3_hash,t/n,t*1000/n%1000,(int)((long long)session_png3_hash*n/t/1000),z);
+	}
+	ccitt32_fast=l;
+	#endif
+}
+#endif
+
 char session_scrn_flag=0; // compressed image format flag
 INLINE int session_savebitmap(void) // save a RGB888 BMP/QOI/PNG file; 0 OK, !0 ERROR
 {
@@ -2934,6 +3661,9 @@ char *session_configread(void) // reads configuration file; session_parmtr holds
 		if (!strcasecmp(t,"zoomvideo")) return session_zoomblit=(*s>>1)&7,session_zoomblit=session_zoomblit>4?4:session_zoomblit,video_lineblend=*s&1,NULL;
 		if (!strcasecmp(t,"safevideo")) return session_softblit=*s&1,video_fineblend=(*s>>1)&1,video_finemicro=(*s>>2)&1,NULL;
 		if (!strcasecmp(t,"safeaudio")) return session_softplay=(~*s)&3,NULL; // stay compatible with old configs (ZERO was accelerated, NONZERO wasn't)
+		if (!strcasecmp(t,"syncvideo")) return session_vsync=*s&1,NULL;
+		if (!strcasecmp(t,"lagaudio")) return audio_latency=(audio_latency=strtol(s,NULL,10))<=0?0:audio_latency<10?10:audio_latency>250?250:audio_latency,NULL;
+		if (!strcasecmp(t,"rateaudio")) return audio_rate=(audio_rate=strtol(s,NULL,10))<=0?0:audio_rate<8000?8000:audio_rate>192000?192000:audio_rate,NULL;
 		if (!strcasecmp(t,"film")) return session_filmscale=*s&1,session_filmtimer=(*s>>1)&1,session_wavedepth=(*s>>2)&1,NULL;
 		if (!strcasecmp(t,"info")) return onscreen_flag=*s&1,session_scrn_flag=(*s>>1)&1,NULL;
 	}
@@ -2943,14 +3673,14 @@ void session_configwrite(FILE *f) // save common parameters
 {
 	fprintf(f,"film %d\ninfo %d\n"
 		"hardaudio %d\nsoftaudio %d\nhardvideo %d\nsoftvideo %X\n"
-		"zoomvideo %d\nsafevideo %d\nsafeaudio %d\n"
+		"zoomvideo %d\nsafevideo %d\nsyncvideo %d\nsafeaudio %d\nlagaudio %d\nrateaudio %d\n"
 		,session_filmscale+session_filmtimer*2+session_wavedepth*4,onscreen_flag+session_scrn_flag*2
 		,audio_mixmode,audio_filter
 			#if !AUDIO_ALWAYS_MONO
 				+audio_surround*4
 			#endif
 		,video_scanline*2+video_pageblend,video_filter,
-		video_lineblend+session_zoomblit*2,session_softblit+video_fineblend*2+video_finemicro*4,session_softplay^3);
+		video_lineblend+session_zoomblit*2,session_softblit+video_fineblend*2+video_finemicro*4,session_vsync,session_softplay^3,audio_latency,audio_rate);
 }
 
 void session_configreadmore(char*); // must be defined by the emulator!
@@ -2978,7 +3708,7 @@ int session_prae(char *s) // load configuration and set stuff up; `s` is argv[0]
 	return debug_setup(),0; // set debugger up as soon as possible
 }
 void session_configwritemore(FILE*); // ditto!
-int session_post(void) // save configuration and shut stuff down; always 0 OK
+int session_post(void) // save configuration and shut stuff down; returns the exit status
 {
 	#if (DEFLATE_ALLOC|LEMPELZIV_ALLOC)
 	if (session_h16lz) free(session_h16lz);
@@ -2986,16 +3716,45 @@ int session_post(void) // save configuration and shut stuff down; always 0 OK
 	puff_byebye();
 	session_closefilm();
 	session_closewave();
+	session_closestream();
+	#ifdef HEADLESS // many headless instances may run at once, don't let them fight over the configuration file
+	return debug_close(),session_exitcode;
+	#else
 	FILE *f; if ((f=session_configfile(0)))
 	{
 		session_configwritemore(f),session_configwrite(f);
 		fclose(f);
 	}
 	return debug_close(),0; // shut debugger down as late as possible
+	#endif
 }
 
 char txt_error[]="Error!";
-#if defined(DEBUG) || defined(SDL_MAIN_HANDLED)
+#ifdef HEADLESS
+#define SESSION_USAGE_HEADLESS "  -b\treport emulation speed (-bb: and video filter and audio speed, -bbb: and inflate/deflate speed)\n" \
+	"  -iN\trun N instances in parallel\n" \
+	"  -lN\tlimit instances to N processes at once\n" \
+	"  -nN\tquit after N frames\n" \
+	"  -vN\tstream raw video into file descriptor N\n" \
+	"  -aN\tstream raw audio into file descriptor N\n"
+#define SESSION_CASES_HEADLESS case 'b': case 'i': case 'l': case 'n': case 'v': case 'a': // the options above, common to all emulators
+int session_argheadless(char *s,int *j) // handle the option `s[*j-1]` and its value, if any, moving `*j` past it; 0 OK, !0 ERROR
+{
+	int c=s[*j-1],n=0; switch (c)
+	{
+		case 'b': return ++session_benchmark,0;
+		case 'v': return !(session_streamv=session_openstream(s,j));
+		case 'a': return !(session_streama=session_openstream(s,j));
+	}
+	while (s[*j]>='0'&&s[*j]<='9') n=n*10+s[(*j)++]-'0';
+	if (n<=0) return 1; // the numeric options must be positive!
+	if (c=='i') session_instances=n; else if (c=='l') session_workers=n; else session_headless=n;
+	return 0;
+}
+#else
+#define SESSION_USAGE_HEADLESS ""
+#endif
+#if defined(DEBUG) || defined(SDL_MAIN_HANDLED) || defined(HEADLESS)
 void printferror(char *s) { printf("error: %s\n",s); }
 #define printfusage(s) printf("%s " MY_LICENSE "\n\n" s,session_caption) // the console help shows the authorship
 #else
@@ -129,6 +129,19 @@ void z80_reset(void) // reset the Z80
 	#endif
 }
 
+// define Z80_GOTO to dispatch the opcodes through a table of labels rather
+// than a `switch`; it relies on the labels-as-values extension of GCC et al.
+#if defined(Z80_GOTO)&&(!defined(__GNUC__)||defined(__TINYC__))
+#undef Z80_GOTO // TCC and the others stick to the `switch`
+#endif
+#ifdef Z80_GOTO
+#define Z80_LABEL(x) z80_op_##x:
+#define Z80_GOTO16(x) &&z80_op_##x##0,&&z80_op_##x##1,&&z80_op_##x##2,&&z80_op_##x##3,&&z80_op_##x##4,&&z80_op_##x##5,&&z80_op_##x##6,&&z80_op_##x##7, \
+	&&z80_op_##x##8,&&z80_op_##x##9,&&z80_op_##x##A,&&z80_op_##x##B,&&z80_op_##x##C,&&z80_op_##x##D,&&z80_op_##x##E,&&z80_op_##x##F
+#else
+#define Z80_LABEL(x)
+#endif
+
 // macros are handier than typing the same snippets of code a million times
 #define Z80_GET_R8 ((z80_ir.b.l&0x80)+(r7&0x7F)) // rebuild R from R7
 #define Z80_OPCODE Z80_NEXT_M1(z80_pc.w)
@@ -188,6 +201,11 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 {
 	int z80_t=0; // clock tick counter
 	BYTE r7=z80_ir.b.l; // split R7+R8!
+	#ifdef Z80_GOTO
+	static const void *const z80_goto[256]={ Z80_GOTO16(0),Z80_GOTO16(1),Z80_GOTO16(2),Z80_GOTO16(3),
+		Z80_GOTO16(4),Z80_GOTO16(5),Z80_GOTO16(6),Z80_GOTO16(7),Z80_GOTO16(8),Z80_GOTO16(9),
+		Z80_GOTO16(A),Z80_GOTO16(B),Z80_GOTO16(C),Z80_GOTO16(D),Z80_GOTO16(E),Z80_GOTO16(F) };
+	#endif
 	Z80_LOCAL; do
 	{
 		++r7; // "Timing Tests 48k Spectrum" requires this!
@@ -232,49 +250,52 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 		{
 			Z80_QUIRK_M1; z80_int=z80_iff.b.l; // consume EI delay
 			BYTE o=Z80_OPCODE; ++z80_pc.w; Z80_STRIDE(o);
+			#ifdef Z80_GOTO
+			goto *z80_goto[o]; // straight into the right `case`, `break` still leaves the `switch`
+			#endif
 			switch (o)
 			{
 				// 0x00-0x3F
-				case 0x01: // LD BC,$NNNN
+				case 0x01: Z80_LABEL(01) // LD BC,$NNNN
 					Z80_LD2(z80_bc.b);
 					Z80_QUIRK(0); break;
-				case 0x11: // LD DE,$NNNN
+				case 0x11: Z80_LABEL(11) // LD DE,$NNNN
 					Z80_LD2(z80_de.b);
 					Z80_QUIRK(0); break;
-				case 0x21: // LD HL,$NNNN
+				case 0x21: Z80_LABEL(21) // LD HL,$NNNN
 					Z80_LD2(z80_hl.b);
 					Z80_QUIRK(0); break;
-				case 0x31: // LD SP,$NNNN
+				case 0x31: Z80_LABEL(31) // LD SP,$NNNN
 					Z80_LD2(z80_sp.b);
 					// no `break`!
-				case 0x00: // NOP
+				case 0x00: Z80_LABEL(00) // NOP
 					Z80_QUIRK(0); break;
-				case 0x02: // LD (BC),A
+				case 0x02: Z80_LABEL(02) // LD (BC),A
 					Z80_POKE(z80_bc.w,z80_af.b.h);
 					#ifdef Z80_DNTR_0X02
 					Z80_DNTR_0X02(z80_bc.w,z80_af.b.h);
 					#endif
 					z80_wz=((z80_bc.b.l+1)&255)+(z80_af.b.h<<8);
 					Z80_QUIRK(0); break;
-				case 0x12: // LD (DE),A
+				case 0x12: Z80_LABEL(12) // LD (DE),A
 					Z80_POKE(z80_de.w,z80_af.b.h);
 					#ifdef Z80_DNTR_0X12
 					Z80_DNTR_0X12(z80_de.w,z80_af.b.h);
 					#endif
 					z80_wz=((z80_de.b.l+1)&255)+(z80_af.b.h<<8);
 					Z80_QUIRK(0); break;
-				case 0x0A: // LD A,(BC)
+				case 0x0A: Z80_LABEL(0A) // LD A,(BC)
 					z80_af.b.h=Z80_PEEK(z80_bc.w);
 					z80_wz=z80_bc.w+1;
 					Z80_QUIRK(0); break;
-				case 0x1A: // LD A,(DE)
+				case 0x1A: Z80_LABEL(1A) // LD A,(DE)
 					z80_af.b.h=Z80_PEEK(z80_de.w);
 					z80_wz=z80_de.w+1;
 					Z80_QUIRK(0); break;
-				case 0x22: // LD ($NNNN),HL
+				case 0x22: Z80_LABEL(22) // LD ($NNNN),HL
 					Z80_WR2(z80_hl.b,0X122);
 					Z80_QUIRK(0); break;
-				case 0x32: // LD ($NNNN),A
+				case 0x32: Z80_LABEL(32) // LD ($NNNN),A
 					Z80_WZ_PC; ++z80_pc.w;
 					Z80_POKE(z80_wz,z80_af.b.h);
 					#ifdef Z80_DNTR_0X32
@@ -282,10 +303,10 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					#endif
 					z80_wz=((z80_wz+1)&255)+(z80_af.b.h<<8);
 					Z80_QUIRK(0); break;
-				case 0x2A: // LD HL,($NNNN)
+				case 0x2A: Z80_LABEL(2A) // LD HL,($NNNN)
 					Z80_RD2(z80_hl.b);
 					Z80_QUIRK(0); break;
-				case 0x3A: // LD A,($NNNN)
+				case 0x3A: Z80_LABEL(3A) // LD A,($NNNN)
 					Z80_WZ_PC; ++z80_pc.w;
 					z80_af.b.h=Z80_PEEK(z80_wz);
 					#ifdef Z80_DNTR_0X3A
@@ -293,138 +314,138 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					#endif
 					++z80_wz;
 					Z80_QUIRK(0); break;
-				case 0x03: // INC BC
+				case 0x03: Z80_LABEL(03) // INC BC
 					++z80_bc.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x0B: // DEC BC
+				case 0x0B: Z80_LABEL(0B) // DEC BC
 					--z80_bc.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x13: // INC DE
+				case 0x13: Z80_LABEL(13) // INC DE
 					++z80_de.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x1B: // DEC DE
+				case 0x1B: Z80_LABEL(1B) // DEC DE
 					--z80_de.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x23: // INC HL
+				case 0x23: Z80_LABEL(23) // INC HL
 					++z80_hl.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x2B: // DEC HL
+				case 0x2B: Z80_LABEL(2B) // DEC HL
 					--z80_hl.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x33: // INC SP
+				case 0x33: Z80_LABEL(33) // INC SP
 					++z80_sp.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x3B: // DEC SP
+				case 0x3B: Z80_LABEL(3B) // DEC SP
 					--z80_sp.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0x04: // INC B
+				case 0x04: Z80_LABEL(04) // INC B
 					Z80_INC1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0x05: // DEC B
+				case 0x05: Z80_LABEL(05) // DEC B
 					Z80_DEC1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0x0C: // INC C
+				case 0x0C: Z80_LABEL(0C) // INC C
 					Z80_INC1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0x0D: // DEC C
+				case 0x0D: Z80_LABEL(0D) // DEC C
 					Z80_DEC1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0x14: // INC D
+				case 0x14: Z80_LABEL(14) // INC D
 					Z80_INC1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0x15: // DEC D
+				case 0x15: Z80_LABEL(15) // DEC D
 					Z80_DEC1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0x1C: // INC E
+				case 0x1C: Z80_LABEL(1C) // INC E
 					Z80_INC1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0x1D: // DEC E
+				case 0x1D: Z80_LABEL(1D) // DEC E
 					Z80_DEC1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0x24: // INC H
+				case 0x24: Z80_LABEL(24) // INC H
 					Z80_INC1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0x25: // DEC H
+				case 0x25: Z80_LABEL(25) // DEC H
 					Z80_DEC1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0x2C: // INC L
+				case 0x2C: Z80_LABEL(2C) // INC L
 					Z80_INC1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0x2D: // DEC L
+				case 0x2D: Z80_LABEL(2D) // DEC L
 					Z80_DEC1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0x34: // INC (HL)
+				case 0x34: Z80_LABEL(34) // INC (HL)
 					{ Z80_RD_HL; Z80_INC1(b); Z80_MREQ_NEXT(1); Z80_WR_HL; }
 					Z80_QUIRK(1); break;
-				case 0x35: // DEC (HL)
+				case 0x35: Z80_LABEL(35) // DEC (HL)
 					{ Z80_RD_HL; Z80_DEC1(b); Z80_MREQ_NEXT(1); Z80_WR_HL; }
 					Z80_QUIRK(1); break;
-				case 0x3C: // INC A
+				case 0x3C: Z80_LABEL(3C) // INC A
 					Z80_INC1(z80_af.b.h);
 					Z80_QUIRK(1); break;
-				case 0x3D: // DEC A
+				case 0x3D: Z80_LABEL(3D) // DEC A
 					Z80_DEC1(z80_af.b.h);
 					Z80_QUIRK(1); break;
-				case 0x06: // LD B,$NN
+				case 0x06: Z80_LABEL(06) // LD B,$NN
 					z80_bc.b.h=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x0E: // LD C,$NN
+				case 0x0E: Z80_LABEL(0E) // LD C,$NN
 					z80_bc.b.l=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x16: // LD D,$NN
+				case 0x16: Z80_LABEL(16) // LD D,$NN
 					z80_de.b.h=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x1E: // LD E,$NN
+				case 0x1E: Z80_LABEL(1E) // LD E,$NN
 					z80_de.b.l=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x26: // LD H,$NN
+				case 0x26: Z80_LABEL(26) // LD H,$NN
 					z80_hl.b.h=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x2E: // LD L,$NN
+				case 0x2E: Z80_LABEL(2E) // LD L,$NN
 					z80_hl.b.l=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x36: // LD (HL),$NN
+				case 0x36: Z80_LABEL(36) // LD (HL),$NN
 					o=Z80_PARMTR; Z80_POKE(z80_hl.w,o); ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x3E: // LD A,$NN
+				case 0x3E: Z80_LABEL(3E) // LD A,$NN
 					z80_af.b.h=Z80_PARMTR; ++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0x07: // RLCA
+				case 0x07: Z80_LABEL(07) // RLCA
 					z80_af.b.h=(z80_af.b.h<<1)+(z80_af.b.h>>7); z80_af.b.l=(z80_af.b.h&1)+(z80_af.b.h&0x28)+(z80_af.b.l&0xC4); // flags --503-0C
 					Z80_QUIRK(1); break;
-				case 0x0F: // RRCA
+				case 0x0F: Z80_LABEL(0F) // RRCA
 					z80_af.b.h=(z80_af.b.h>>1)+(z80_af.b.h<<7); z80_af.b.l=(z80_af.b.h>>7)+(z80_af.b.h&0x28)+(z80_af.b.l&0xC4); // flags --503-0C
 					Z80_QUIRK(1); break;
-				case 0x17: // RLA
+				case 0x17: Z80_LABEL(17) // RLA
 					o=z80_af.b.h>>7; z80_af.b.h=(z80_af.b.h<<1)+(z80_af.b.l&1); z80_af.b.l=(z80_af.b.h&0x28)+(z80_af.b.l&0xC4)+o; // flags --503-0C
 					Z80_QUIRK(1); break;
-				case 0x1F: // RRA
+				case 0x1F: Z80_LABEL(1F) // RRA
 					o=z80_af.b.h&1; z80_af.b.h=(z80_af.b.h>>1)+(z80_af.b.l<<7); z80_af.b.l=(z80_af.b.h&0x28)+(z80_af.b.l&0xC4)+o; // flags --503-0C
 					Z80_QUIRK(1); break;
-				case 0x08: // EX AF,AF'
+				case 0x08: Z80_LABEL(08) // EX AF,AF'
 					Z80_EXX2(z80_af.w,z80_af2.w);
 					Z80_QUIRK(0); break;
-				case 0x09: // ADD HL,BC
+				case 0x09: Z80_LABEL(09) // ADD HL,BC
 					Z80_ADD2(z80_hl.w,z80_bc.w);
 					Z80_QUIRK(1); break;
-				case 0x19: // ADD HL,DE
+				case 0x19: Z80_LABEL(19) // ADD HL,DE
 					Z80_ADD2(z80_hl.w,z80_de.w);
 					Z80_QUIRK(1); break;
-				case 0x29: // ADD HL,HL
+				case 0x29: Z80_LABEL(29) // ADD HL,HL
 					Z80_ADD2(z80_hl.w,z80_hl.w);
 					Z80_QUIRK(1); break;
-				case 0x39: // ADD HL,SP
+				case 0x39: Z80_LABEL(39) // ADD HL,SP
 					Z80_ADD2(z80_hl.w,z80_sp.w);
 					Z80_QUIRK(1); break;
-				case 0x10: // DJNZ $RRRR
+				case 0x10: Z80_LABEL(10) // DJNZ $RRRR
 					Z80_WAIT_IR1X(1); if (--z80_bc.b.h)
 					{
 						Z80_STRIDE(0x110);
@@ -438,12 +459,12 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					Z80_DNTR_0X10(z80_pc.w);
 					#endif
 					Z80_QUIRK(0); break;
-				case 0x18: // JR $RRRR
+				case 0x18: Z80_LABEL(18) // JR $RRRR
 					z80_wz=(INT8)Z80_PARMTR;
 					Z80_MREQ_1X_NEXT(5);
 					z80_pc.w=z80_wz+=z80_pc.w+1;
 					Z80_QUIRK(0); break;
-				case 0x20: // JR NZ,$RRRR
+				case 0x20: Z80_LABEL(20) // JR NZ,$RRRR
 					if (!(z80_af.b.l&0x40)) // don't use GOTOs here: unlike RET cc and CALL cc,$NNNN, the performance penalty is important!
 					{
 						Z80_STRIDE(0x120);
@@ -454,7 +475,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					Z80_ZZ_PC; ++z80_pc.w; // dummy!
 					Z80_QUIRK(0); break;
-				case 0x28: // JR Z,$RRRR
+				case 0x28: Z80_LABEL(28) // JR Z,$RRRR
 					if (z80_af.b.l&0x40)
 					{
 						Z80_STRIDE(0x128);
@@ -465,7 +486,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					Z80_ZZ_PC; ++z80_pc.w; // dummy!
 					Z80_QUIRK(0); break;
-				case 0x30: // JR NC,$RRRR
+				case 0x30: Z80_LABEL(30) // JR NC,$RRRR
 					if (!(z80_af.b.l&0x01))
 					{
 						Z80_STRIDE(0x130);
@@ -476,7 +497,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					Z80_ZZ_PC; ++z80_pc.w; // dummy!
 					Z80_QUIRK(0); break;
-				case 0x38: // JR C,$RRRR
+				case 0x38: Z80_LABEL(38) // JR C,$RRRR
 					if (z80_af.b.l&0x01)
 					{
 						Z80_STRIDE(0x138);
@@ -487,7 +508,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					Z80_ZZ_PC; ++z80_pc.w; // dummy!
 					Z80_QUIRK(0); break;
-				case 0x27: // DAA
+				case 0x27: Z80_LABEL(27) // DAA
 					{
 						BYTE x=z80_af.b.h,z=0,b=(((x&0x0F)>9)||(z80_af.b.l&0x10))?0x06:0;
 						if ((x>0x99)||(z80_af.b.l&0x01))
@@ -499,202 +520,202 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 						z80_af.b.l=z80_flags_xor[z80_af.b.h]+((z80_af.b.h^x)&0x10)+(z80_af.b.l&2)+z;
 					}
 					Z80_QUIRK(1); break;
-				case 0x2F: // CPL
+				case 0x2F: Z80_LABEL(2F) // CPL
 					z80_af.b.l=(z80_af.b.l&0xC5)+((z80_af.b.h=~z80_af.b.h)&0x28)+0x12; // --513-1-
 					Z80_QUIRK(1); break;
-				case 0x37: // SCF
+				case 0x37: Z80_LABEL(37) // SCF
 					z80_af.b.l=(z80_af.b.l&0xC4)+(((Z80_XCF_BUG)|z80_af.b.h)&0x28)+1; // --503--1
 					Z80_QUIRK(1); break;
-				case 0x3F: // CCF
+				case 0x3F: Z80_LABEL(3F) // CCF
 					z80_af.b.l=(z80_af.b.l&0xC4)+(((Z80_XCF_BUG)|z80_af.b.h)&0x28)+((z80_af.b.l&1)?16:1); // --5H3--C
 					Z80_QUIRK(1); break;
 				// 0x40-0x7F
-				case 0x41: // LD B,C
+				case 0x41: Z80_LABEL(41) // LD B,C
 					z80_bc.b.h=z80_bc.b.l;
 					// no `break`!
-				case 0x40: // LD B,B
+				case 0x40: Z80_LABEL(40) // LD B,B
 					Z80_QUIRK(0); break;
-				case 0x42: // LD B,D
+				case 0x42: Z80_LABEL(42) // LD B,D
 					z80_bc.b.h=z80_de.b.h;
 					Z80_QUIRK(0); break;
-				case 0x43: // LD B,E
+				case 0x43: Z80_LABEL(43) // LD B,E
 					z80_bc.b.h=z80_de.b.l;
 					Z80_QUIRK(0); break;
-				case 0x44: // LD B,H
+				case 0x44: Z80_LABEL(44) // LD B,H
 					z80_bc.b.h=z80_hl.b.h;
 					Z80_QUIRK(0); break;
-				case 0x45: // LD B,L
+				case 0x45: Z80_LABEL(45) // LD B,L
 					z80_bc.b.h=z80_hl.b.l;
 					Z80_QUIRK(0); break;
-				case 0x46: // LD B,(HL)
+				case 0x46: Z80_LABEL(46) // LD B,(HL)
 					z80_bc.b.h=Z80_PEEK(z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0x47: // LD B,A
+				case 0x47: Z80_LABEL(47) // LD B,A
 					z80_bc.b.h=z80_af.b.h;
 					Z80_QUIRK(0); break;
-				case 0x48: // LD C,B
+				case 0x48: Z80_LABEL(48) // LD C,B
 					z80_bc.b.l=z80_bc.b.h;
 					// no `break`!
-				case 0x49: // LD C,C
+				case 0x49: Z80_LABEL(49) // LD C,C
 					Z80_QUIRK(0); break;
-				case 0x4A: // LD C,D
+				case 0x4A: Z80_LABEL(4A) // LD C,D
 					z80_bc.b.l=z80_de.b.h;
 					Z80_QUIRK(0); break;
-				case 0x4B: // LD C,E
+				case 0x4B: Z80_LABEL(4B) // LD C,E
 					z80_bc.b.l=z80_de.b.l;
 					Z80_QUIRK(0); break;
-				case 0x4C: // LD C,H
+				case 0x4C: Z80_LABEL(4C) // LD C,H
 					z80_bc.b.l=z80_hl.b.h;
 					Z80_QUIRK(0); break;
-				case 0x4D: // LD C,L
+				case 0x4D: Z80_LABEL(4D) // LD C,L
 					z80_bc.b.l=z80_hl.b.l;
 					Z80_QUIRK(0); break;
-				case 0x4E: // LD C,(HL)
+				case 0x4E: Z80_LABEL(4E) // LD C,(HL)
 					z80_bc.b.l=Z80_PEEK(z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0x4F: // LD C,A
+				case 0x4F: Z80_LABEL(4F) // LD C,A
 					z80_bc.b.l=z80_af.b.h;
 					Z80_QUIRK(0); break;
-				case 0x50: // LD D,B
+				case 0x50: Z80_LABEL(50) // LD D,B
 					z80_de.b.h=z80_bc.b.h;
 					Z80_QUIRK(0); break;
-				case 0x51: // LD D,C
+				case 0x51: Z80_LABEL(51) // LD D,C
 					z80_de.b.h=z80_bc.b.l;
 					Z80_QUIRK(0); break;
-				case 0x53: // LD D,E
+				case 0x53: Z80_LABEL(53) // LD D,E
 					z80_de.b.h=z80_de.b.l;
 					// no `break`!
-				case 0x52: // LD D,D
+				case 0x52: Z80_LABEL(52) // LD D,D
 					Z80_QUIRK(0); break;
-				case 0x54: // LD D,H
+				case 0x54: Z80_LABEL(54) // LD D,H
 					z80_de.b.h=z80_hl.b.h;
 					Z80_QUIRK(0); break;
-				case 0x55: // LD D,L
+				case 0x55: Z80_LABEL(55) // LD D,L
 					z80_de.b.h=z80_hl.b.l;
 					Z80_QUIRK(0); break;
-				case 0x56: // LD D,(HL)
+				case 0x56: Z80_LABEL(56) // LD D,(HL)
 					z80_de.b.h=Z80_PEEK(z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0x57: // LD D,A
+				case 0x57: Z80_LABEL(57) // LD D,A
 					z80_de.b.h=z80_af.b.h;
 					Z80_QUIRK(0); break;
-				case 0x58: // LD E,B
+				case 0x58: Z80_LABEL(58) // LD E,B
 					z80_de.b.l=z80_bc.b.h;
 					Z80_QUIRK(0); break;
-				case 0x59: // LD E,C
+				case 0x59: Z80_LABEL(59) // LD E,C
 					z80_de.b.l=z80_bc.b.l;
 					Z80_QUIRK(0); break;
-				case 0x5A: // LD E,D
+				case 0x5A: Z80_LABEL(5A) // LD E,D
 					z80_de.b.l=z80_de.b.h;
 					// no `break`!
-				case 0x5B: // LD E,E
+				case 0x5B: Z80_LABEL(5B) // LD E,E
 					Z80_QUIRK(0); break;
-				case 0x5C: // LD E,H
+				case 0x5C: Z80_LABEL(5C) // LD E,H
 					z80_de.b.l=z80_hl.b.h;
 					Z80_QUIRK(0); break;
-				case 0x5D: // LD E,L
+				case 0x5D: Z80_LABEL(5D) // LD E,L
 					z80_de.b.l=z80_hl.b.l;
 					Z80_QUIRK(0); break;
-				case 0x5E: // LD E,(HL)
+				case 0x5E: Z80_LABEL(5E) // LD E,(HL)
 					z80_de.b.l=Z80_PEEK(z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0x5F: // LD E,A
+				case 0x5F: Z80_LABEL(5F) // LD E,A
 					z80_de.b.l=z80_af.b.h;
 					Z80_QUIRK(0); break;
-				case 0x60: // LD H,B
+				case 0x60: Z80_LABEL(60) // LD H,B
 					z80_hl.b.h=z80_bc.b.h;
 					Z80_QUIRK(0); break;
-				case 0x61: // LD H,C
+				case 0x61: Z80_LABEL(61) // LD H,C
 					z80_hl.b.h=z80_bc.b.l;
 					Z80_QUIRK(0); break;
-				case 0x62: // LD H,D
+				case 0x62: Z80_LABEL(62) // LD H,D
 					z80_hl.b.h=z80_de.b.h;
 					Z80_QUIRK(0); break;
-				case 0x63: // LD H,E
+				case 0x63: Z80_LABEL(63) // LD H,E
 					z80_hl.b.h=z80_de.b.l;
 					Z80_QUIRK(0); break;
-				case 0x65: // LD H,L
+				case 0x65: Z80_LABEL(65) // LD H,L
 					z80_hl.b.h=z80_hl.b.l;
 					// no `break`!
-				case 0x64: // LD H,H
+				case 0x64: Z80_LABEL(64) // LD H,H
 					Z80_QUIRK(0); break;
-				case 0x66: // LD H,(HL)
+				case 0x66: Z80_LABEL(66) // LD H,(HL)
 					z80_hl.b.h=Z80_PEEK(z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0x67: // LD H,A
+				case 0x67: Z80_LABEL(67) // LD H,A
 					z80_hl.b.h=z80_af.b.h;
 					Z80_QUIRK(0); break;
-				case 0x68: // LD L,B
+				case 0x68: Z80_LABEL(68) // LD L,B
 					z80_hl.b.l=z80_bc.b.h;
 					Z80_QUIRK(0); break;
-				case 0x69: // LD L,C
+				case 0x69: Z80_LABEL(69) // LD L,C
 					z80_hl.b.l=z80_bc.b.l;
 					Z80_QUIRK(0); break;
-				case 0x6A: // LD L,D
+				case 0x6A: Z80_LABEL(6A) // LD L,D
 					z80_hl.b.l=z80_de.b.h;
 					Z80_QUIRK(0); break;
-				case 0x6B: // LD L,E
+				case 0x6B: Z80_LABEL(6B) // LD L,E
 					z80_hl.b.l=z80_de.b.l;
 					Z80_QUIRK(0); break;
-				case 0x6C: // LD L,H
+				case 0x6C: Z80_LABEL(6C) // LD L,H
 					z80_hl.b.l=z80_hl.b.h;
 					// no `break`!
-				case 0x6D: // LD L,L
+				case 0x6D: Z80_LABEL(6D) // LD L,L
 					Z80_QUIRK(0); break;
-				case 0x6E: // LD L,(HL)
+				case 0x6E: Z80_LABEL(6E) // LD L,(HL)
 					z80_hl.b.l=Z80_PEEK(z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0x6F: // LD L,A
+				case 0x6F: Z80_LABEL(6F) // LD L,A
 					z80_hl.b.l=z80_af.b.h;
 					Z80_QUIRK(0); break;
-				case 0x70: // LD (HL),B
+				case 0x70: Z80_LABEL(70) // LD (HL),B
 					Z80_POKE(z80_hl.w,z80_bc.b.h);
 					Z80_QUIRK(0); break;
-				case 0x71: // LD (HL),C
+				case 0x71: Z80_LABEL(71) // LD (HL),C
 					Z80_POKE(z80_hl.w,z80_bc.b.l);
 					Z80_QUIRK(0); break;
-				case 0x72: // LD (HL),D
+				case 0x72: Z80_LABEL(72) // LD (HL),D
 					Z80_POKE(z80_hl.w,z80_de.b.h);
 					Z80_QUIRK(0); break;
-				case 0x73: // LD (HL),E
+				case 0x73: Z80_LABEL(73) // LD (HL),E
 					Z80_POKE(z80_hl.w,z80_de.b.l);
 					Z80_QUIRK(0); break;
-				case 0x74: // LD (HL),H
+				case 0x74: Z80_LABEL(74) // LD (HL),H
 					Z80_POKE(z80_hl.w,z80_hl.b.h);
 					Z80_QUIRK(0); break;
-				case 0x75: // LD (HL),L
+				case 0x75: Z80_LABEL(75) // LD (HL),L
 					Z80_POKE(z80_hl.w,z80_hl.b.l);
 					Z80_QUIRK(0); break;
-				case 0x77: // LD (HL),A
+				case 0x77: Z80_LABEL(77) // LD (HL),A
 					Z80_POKE(z80_hl.w,z80_af.b.h);
 					#ifdef Z80_DNTR_0X77
 					Z80_DNTR_0X77(z80_hl.w,z80_af.b.h);
 					#endif
 					Z80_QUIRK(0); break;
-				case 0x78: // LD A,B
+				case 0x78: Z80_LABEL(78) // LD A,B
 					z80_af.b.h=z80_bc.b.h;
 					Z80_QUIRK(0); break;
-				case 0x79: // LD A,C
+				case 0x79: Z80_LABEL(79) // LD A,C
 					z80_af.b.h=z80_bc.b.l;
 					Z80_QUIRK(0); break;
-				case 0x7A: // LD A,D
+				case 0x7A: Z80_LABEL(7A) // LD A,D
 					z80_af.b.h=z80_de.b.h;
 					Z80_QUIRK(0); break;
-				case 0x7B: // LD A,E
+				case 0x7B: Z80_LABEL(7B) // LD A,E
 					z80_af.b.h=z80_de.b.l;
 					Z80_QUIRK(0); break;
-				case 0x7C: // LD A,H
+				case 0x7C: Z80_LABEL(7C) // LD A,H
 					z80_af.b.h=z80_hl.b.h;
 					Z80_QUIRK(0); break;
-				case 0x7D: // LD A,L
+				case 0x7D: Z80_LABEL(7D) // LD A,L
 					z80_af.b.h=z80_hl.b.l;
 					Z80_QUIRK(0); break;
-				case 0x7E: // LD A,(HL)
+				case 0x7E: Z80_LABEL(7E) // LD A,(HL)
 					z80_af.b.h=Z80_PEEK(z80_hl.w);
 					// no `break`!
-				case 0x7F: // LD A,A
+				case 0x7F: Z80_LABEL(7F) // LD A,A
 					Z80_QUIRK(0); break;
-				case 0x76: // HALT
+				case 0x76: Z80_LABEL(76) // HALT
 					--z80_pc.w; //if (z80_iff.b.l) // is the Z80 active or stuck?
 						z80_int<<=1; // HALT tag: -1=>-2, +0=>+0, +1=>+2
 					#if Z80_HALT_STRIDE // optimal HALT
@@ -708,200 +729,200 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					#endif
 					Z80_QUIRK(0); break;
 				// 0x80-0xBF
-				case 0x80: // ADD B
+				case 0x80: Z80_LABEL(80) // ADD B
 					Z80_ADD1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0x81: // ADD C
+				case 0x81: Z80_LABEL(81) // ADD C
 					Z80_ADD1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0x82: // ADD D
+				case 0x82: Z80_LABEL(82) // ADD D
 					Z80_ADD1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0x83: // ADD E
+				case 0x83: Z80_LABEL(83) // ADD E
 					Z80_ADD1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0x84: // ADD H
+				case 0x84: Z80_LABEL(84) // ADD H
 					Z80_ADD1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0x85: // ADD L
+				case 0x85: Z80_LABEL(85) // ADD L
 					Z80_ADD1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0x86: // ADD (HL)
+				case 0x86: Z80_LABEL(86) // ADD (HL)
 					{ Z80_RD_HL; Z80_ADD1(b); }
 					Z80_QUIRK(1); break;
-				case 0x87: // ADD A
+				case 0x87: Z80_LABEL(87) // ADD A
 					Z80_ADD1(z80_af.b.h);
 					Z80_QUIRK(1); break;
-				case 0x88: // ADC B
+				case 0x88: Z80_LABEL(88) // ADC B
 					Z80_ADC1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0x89: // ADC C
+				case 0x89: Z80_LABEL(89) // ADC C
 					Z80_ADC1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0x8A: // ADC D
+				case 0x8A: Z80_LABEL(8A) // ADC D
 					Z80_ADC1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0x8B: // ADC E
+				case 0x8B: Z80_LABEL(8B) // ADC E
 					Z80_ADC1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0x8C: // ADC H
+				case 0x8C: Z80_LABEL(8C) // ADC H
 					Z80_ADC1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0x8D: // ADC L
+				case 0x8D: Z80_LABEL(8D) // ADC L
 					Z80_ADC1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0x8E: // ADC (HL)
+				case 0x8E: Z80_LABEL(8E) // ADC (HL)
 					{ Z80_RD_HL; Z80_ADC1(b); }
 					Z80_QUIRK(1); break;
-				case 0x8F: // ADC A
+				case 0x8F: Z80_LABEL(8F) // ADC A
 					Z80_ADC1(z80_af.b.h);
 					Z80_QUIRK(1); break;
-				case 0x90: // SUB B
+				case 0x90: Z80_LABEL(90) // SUB B
 					Z80_SUB1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0x91: // SUB C
+				case 0x91: Z80_LABEL(91) // SUB C
 					Z80_SUB1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0x92: // SUB D
+				case 0x92: Z80_LABEL(92) // SUB D
 					Z80_SUB1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0x93: // SUB E
+				case 0x93: Z80_LABEL(93) // SUB E
 					Z80_SUB1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0x94: // SUB H
+				case 0x94: Z80_LABEL(94) // SUB H
 					Z80_SUB1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0x95: // SUB L
+				case 0x95: Z80_LABEL(95) // SUB L
 					Z80_SUB1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0x96: // SUB (HL)
+				case 0x96: Z80_LABEL(96) // SUB (HL)
 					{ Z80_RD_HL; Z80_SUB1(b); }
 					Z80_QUIRK(1); break;
-				case 0x97: // SUB A
+				case 0x97: Z80_LABEL(97) // SUB A
 					z80_af.w=0x0042;//Z80_SUB1(z80_af.b.h);//
 					Z80_QUIRK(1); break;
-				case 0x98: // SBC B
+				case 0x98: Z80_LABEL(98) // SBC B
 					Z80_SBC1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0x99: // SBC C
+				case 0x99: Z80_LABEL(99) // SBC C
 					Z80_SBC1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0x9A: // SBC D
+				case 0x9A: Z80_LABEL(9A) // SBC D
 					Z80_SBC1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0x9B: // SBC E
+				case 0x9B: Z80_LABEL(9B) // SBC E
 					Z80_SBC1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0x9C: // SBC H
+				case 0x9C: Z80_LABEL(9C) // SBC H
 					Z80_SBC1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0x9D: // SBC L
+				case 0x9D: Z80_LABEL(9D) // SBC L
 					Z80_SBC1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0x9E: // SBC (HL)
+				case 0x9E: Z80_LABEL(9E) // SBC (HL)
 					{ Z80_RD_HL; Z80_SBC1(b); }
 					Z80_QUIRK(1); break;
-				case 0x9F: // SBC A
+				case 0x9F: Z80_LABEL(9F) // SBC A
 					Z80_SBC1(z80_af.b.h);
 					Z80_QUIRK(1); break;
-				case 0xA0: // AND B
+				case 0xA0: Z80_LABEL(A0) // AND B
 					Z80_AND1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0xA1: // AND C
+				case 0xA1: Z80_LABEL(A1) // AND C
 					Z80_AND1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0xA2: // AND D
+				case 0xA2: Z80_LABEL(A2) // AND D
 					Z80_AND1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0xA3: // AND E
+				case 0xA3: Z80_LABEL(A3) // AND E
 					Z80_AND1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0xA4: // AND H
+				case 0xA4: Z80_LABEL(A4) // AND H
 					Z80_AND1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0xA5: // AND L
+				case 0xA5: Z80_LABEL(A5) // AND L
 					Z80_AND1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0xA6: // AND (HL)
+				case 0xA6: Z80_LABEL(A6) // AND (HL)
 					{ Z80_RD_HL; Z80_AND1(b); }
 					Z80_QUIRK(1); break;
-				case 0xA7: // AND A
+				case 0xA7: Z80_LABEL(A7) // AND A
 					z80_af.b.l=z80_flags_and[z80_af.b.h];//Z80_AND1(z80_af.b.h);//
 					Z80_QUIRK(1); break;
-				case 0xA8: // XOR B
+				case 0xA8: Z80_LABEL(A8) // XOR B
 					Z80_XOR1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0xA9: // XOR C
+				case 0xA9: Z80_LABEL(A9) // XOR C
 					Z80_XOR1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0xAA: // XOR D
+				case 0xAA: Z80_LABEL(AA) // XOR D
 					Z80_XOR1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0xAB: // XOR E
+				case 0xAB: Z80_LABEL(AB) // XOR E
 					Z80_XOR1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0xAC: // XOR H
+				case 0xAC: Z80_LABEL(AC) // XOR H
 					Z80_XOR1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0xAD: // XOR L
+				case 0xAD: Z80_LABEL(AD) // XOR L
 					Z80_XOR1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0xAE: // XOR (HL)
+				case 0xAE: Z80_LABEL(AE) // XOR (HL)
 					{ Z80_RD_HL; Z80_XOR1(b); }
 					Z80_QUIRK(1); break;
-				case 0xAF: // XOR A
+				case 0xAF: Z80_LABEL(AF) // XOR A
 					z80_af.w=0x0044;//Z80_XOR1(z80_af.b.h);
 					Z80_QUIRK(1); break;
-				case 0xB0: // OR B
+				case 0xB0: Z80_LABEL(B0) // OR B
 					Z80_OR1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0xB1: // OR C
+				case 0xB1: Z80_LABEL(B1) // OR C
 					Z80_OR1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0xB2: // OR D
+				case 0xB2: Z80_LABEL(B2) // OR D
 					Z80_OR1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0xB3: // OR E
+				case 0xB3: Z80_LABEL(B3) // OR E
 					Z80_OR1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0xB4: // OR H
+				case 0xB4: Z80_LABEL(B4) // OR H
 					Z80_OR1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0xB5: // OR L
+				case 0xB5: Z80_LABEL(B5) // OR L
 					Z80_OR1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0xB6: // OR (HL)
+				case 0xB6: Z80_LABEL(B6) // OR (HL)
 					{ Z80_RD_HL; Z80_OR1(b); }
 					Z80_QUIRK(1); break;
-				case 0xB7: // OR A
+				case 0xB7: Z80_LABEL(B7) // OR A
 					z80_af.b.l=z80_flags_xor[z80_af.b.h];//Z80_OR1(z80_af.b.h);//
 					Z80_QUIRK(1); break;
-				case 0xB8: // CP B
+				case 0xB8: Z80_LABEL(B8) // CP B
 					Z80_CP1(z80_bc.b.h);
 					Z80_QUIRK(1); break;
-				case 0xB9: // CP C
+				case 0xB9: Z80_LABEL(B9) // CP C
 					Z80_CP1(z80_bc.b.l);
 					Z80_QUIRK(1); break;
-				case 0xBA: // CP D
+				case 0xBA: Z80_LABEL(BA) // CP D
 					Z80_CP1(z80_de.b.h);
 					Z80_QUIRK(1); break;
-				case 0xBB: // CP E
+				case 0xBB: Z80_LABEL(BB) // CP E
 					Z80_CP1(z80_de.b.l);
 					Z80_QUIRK(1); break;
-				case 0xBC: // CP H
+				case 0xBC: Z80_LABEL(BC) // CP H
 					Z80_CP1(z80_hl.b.h);
 					Z80_QUIRK(1); break;
-				case 0xBD: // CP L
+				case 0xBD: Z80_LABEL(BD) // CP L
 					Z80_CP1(z80_hl.b.l);
 					Z80_QUIRK(1); break;
-				case 0xBE: // CP (HL)
+				case 0xBE: Z80_LABEL(BE) // CP (HL)
 					{ Z80_RD_HL; Z80_CP1(b); }
 					Z80_QUIRK(1); break;
-				case 0xBF: // CP A
+				case 0xBF: Z80_LABEL(BF) // CP A
 					z80_af.b.l=(z80_af.b.h&0X28)+0X42;//Z80_CP1(z80_af.b.h);//
 					Z80_QUIRK(1); break;
 				// 0xC0-0xFF
-				case 0xC0: // RET NZ
+				case 0xC0: Z80_LABEL(C0) // RET NZ
 					Z80_WAIT_IR1X(1); if (!(z80_af.b.l&0x40)) // CATCH required by TR-DOS!
 					#ifdef Z80_TRDOS_GOTOS
 					goto go_to_ret_catch;
@@ -914,7 +935,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					#endif
 					Z80_QUIRK(2); break;
-				case 0xC8: // RET Z
+				case 0xC8: Z80_LABEL(C8) // RET Z
 					Z80_WAIT_IR1X(1); if (z80_af.b.l&0x40) // CATCH required by TR-DOS!
 					{
 						#ifdef Z80_TRDOS_GOTOS
@@ -926,7 +947,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 						Z80_QUIRK(0); break;
 					}
 					Z80_QUIRK(2); break;
-				case 0xD0: // RET NC
+				case 0xD0: Z80_LABEL(D0) // RET NC
 					Z80_WAIT_IR1X(1); if (!(z80_af.b.l&0x01)) // used by TR-DOS
 					#ifdef Z80_TRDOS_GOTOS
 					goto go_to_ret_enter;
@@ -939,7 +960,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					#endif
 					Z80_QUIRK(2); break;
-				case 0xD8: // RET C
+				case 0xD8: Z80_LABEL(D8) // RET C
 					Z80_WAIT_IR1X(1); if (z80_af.b.l&0x01) // used by TR-DOS
 					{
 						#ifdef Z80_TRDOS_GOTOS
@@ -951,7 +972,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 						Z80_QUIRK(0); break;
 					}
 					Z80_QUIRK(2); break;
-				case 0xE0: // RET NV
+				case 0xE0: Z80_LABEL(E0) // RET NV
 					Z80_WAIT_IR1X(1); if (!(z80_af.b.l&0x04)) // unused by TR-DOS?
 					#ifdef Z80_TRDOS_GOTOS
 					goto go_to_ret_enter;
@@ -964,7 +985,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					#endif
 					Z80_QUIRK(2); break;
-				case 0xE8: // RET V
+				case 0xE8: Z80_LABEL(E8) // RET V
 					Z80_WAIT_IR1X(1); if (z80_af.b.l&0x04) // unused by TR-DOS?
 					#ifdef Z80_TRDOS_GOTOS
 					goto go_to_ret_enter;
@@ -977,7 +998,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					#endif
 					Z80_QUIRK(2); break;
-				case 0xF0: // RET NS
+				case 0xF0: Z80_LABEL(F0) // RET NS
 					Z80_WAIT_IR1X(1); if (!(z80_af.b.l&0x80)) // unused by TR-DOS?
 					#ifdef Z80_TRDOS_GOTOS
 					goto go_to_ret_enter;
@@ -990,7 +1011,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					#endif
 					Z80_QUIRK(2); break;
-				case 0xF8: // RET S
+				case 0xF8: Z80_LABEL(F8) // RET S
 					Z80_WAIT_IR1X(1); if (z80_af.b.l&0x80) // unused by TR-DOS?
 					#ifdef Z80_TRDOS_GOTOS
 					goto go_to_ret_enter;
@@ -1003,42 +1024,42 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					}
 					#endif
 					Z80_QUIRK(2); break;
-				case 0xC9: // RET
+				case 0xC9: Z80_LABEL(C9) // RET
 					Z80_RET2;
 					#ifdef Z80_DNTR_0XC9
 					Z80_DNTR_0XC9();
 					#endif
 					Z80_TRDOS_CATCH(z80_pc); // CATCH required by TR-DOS!
 					Z80_QUIRK(0); break;
-				case 0xC1: // POP BC
+				case 0xC1: Z80_LABEL(C1) // POP BC
 					Z80_POP2(z80_bc.b);
 					Z80_QUIRK(0); break;
-				case 0xD1: // POP DE
+				case 0xD1: Z80_LABEL(D1) // POP DE
 					Z80_POP2(z80_de.b);
 					Z80_QUIRK(0); break;
-				case 0xE1: // POP HL
+				case 0xE1: Z80_LABEL(E1) // POP HL
 					Z80_POP2(z80_hl.b);
 					Z80_QUIRK(0); break;
-				case 0xF1: // POP AF
+				case 0xF1: Z80_LABEL(F1) // POP AF
 					Z80_POP2(z80_af.b);
 					Z80_QUIRK(0); break;
-				case 0xC5: // PUSH BC
+				case 0xC5: Z80_LABEL(C5) // PUSH BC
 					Z80_WAIT_IR1X(1);
 					Z80_PUSH2(z80_bc.b,0x1C5);
 					Z80_QUIRK(0); break;
-				case 0xD5: // PUSH DE
+				case 0xD5: Z80_LABEL(D5) // PUSH DE
 					Z80_WAIT_IR1X(1);
 					Z80_PUSH2(z80_de.b,0x1D5);
 					Z80_QUIRK(0); break;
-				case 0xE5: // PUSH HL
+				case 0xE5: Z80_LABEL(E5) // PUSH HL
 					Z80_WAIT_IR1X(1);
 					Z80_PUSH2(z80_hl.b,0x1E5);
 					Z80_QUIRK(0); break;
-				case 0xF5: // PUSH AF
+				case 0xF5: Z80_LABEL(F5) // PUSH AF
 					Z80_WAIT_IR1X(1);
 					Z80_PUSH2(z80_af.b,0x1F5);
 					Z80_QUIRK(0); break;
-				case 0xC2: // JP NZ,$NNNN
+				case 0xC2: Z80_LABEL(C2) // JP NZ,$NNNN
 					Z80_WZ_PC; if (!(z80_af.b.l&0x40))
 					{
 						z80_pc.w=z80_wz;
@@ -1047,7 +1068,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xCA: // JP Z,$NNNN
+				case 0xCA: Z80_LABEL(CA) // JP Z,$NNNN
 					Z80_WZ_PC; if (z80_af.b.l&0x40)
 					{
 						z80_pc.w=z80_wz;
@@ -1056,7 +1077,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xD2: // JP NC,$NNNN
+				case 0xD2: Z80_LABEL(D2) // JP NC,$NNNN
 					Z80_WZ_PC; if (!(z80_af.b.l&0x01))
 					{
 						z80_pc.w=z80_wz;
@@ -1065,7 +1086,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xDA: // JP C,$NNNN
+				case 0xDA: Z80_LABEL(DA) // JP C,$NNNN
 					Z80_WZ_PC; if (z80_af.b.l&0x01)
 					{
 						z80_pc.w=z80_wz;
@@ -1074,7 +1095,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xE2: // JP NV,$NNNN
+				case 0xE2: Z80_LABEL(E2) // JP NV,$NNNN
 					Z80_WZ_PC; if (!(z80_af.b.l&0x04))
 					{
 						z80_pc.w=z80_wz;
@@ -1083,7 +1104,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xEA: // JP V,$NNNN
+				case 0xEA: Z80_LABEL(EA) // JP V,$NNNN
 					Z80_WZ_PC; if (z80_af.b.l&0x04)
 					{
 						z80_pc.w=z80_wz;
@@ -1092,7 +1113,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xF2: // JP NS,$NNNN
+				case 0xF2: Z80_LABEL(F2) // JP NS,$NNNN
 					Z80_WZ_PC; if (!(z80_af.b.l&0x80))
 					{
 						z80_pc.w=z80_wz;
@@ -1101,7 +1122,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xFA: // JP S,$NNNN
+				case 0xFA: Z80_LABEL(FA) // JP S,$NNNN
 					Z80_WZ_PC; if (z80_af.b.l&0x80)
 					{
 						z80_pc.w=z80_wz;
@@ -1110,7 +1131,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					else
 						++z80_pc.w;
 					Z80_QUIRK(0); break;
-				case 0xC3: // JP $NNNN
+				case 0xC3: Z80_LABEL(C3) // JP $NNNN
 					Z80_WZ_PC;
 					#ifdef Z80_TRAP_0XC3
 					Z80_TRAP_0XC3;
@@ -1118,16 +1139,16 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					z80_pc.w=z80_wz;
 					Z80_TRDOS_ENTER(z80_pc); // used with TR-DOS (robin_wc.zip)
 					Z80_QUIRK(0); break;
-				case 0xC4: // CALL NZ,$NNNN
+				case 0xC4: Z80_LABEL(C4) // CALL NZ,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (!(z80_af.b.l&0x40)) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xCC: // CALL Z,$NNNN
+				case 0xCC: Z80_LABEL(CC) // CALL Z,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (z80_af.b.l&0x40) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xD4: // CALL NC,$NNNN
+				case 0xD4: Z80_LABEL(D4) // CALL NC,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (!(z80_af.b.l&0x01)) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xDC: // CALL C,$NNNN
+				case 0xDC: Z80_LABEL(DC) // CALL C,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (z80_af.b.l&0x01) //goto go_to_call;
 					{
 						go_to_call: // *!* GOTO!
@@ -1137,19 +1158,19 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 						Z80_QUIRK(0); break; // not redundant! (f.e. MSXEC's performance drops)
 					}
 					Z80_QUIRK(0); break;
-				case 0xE4: // CALL NV,$NNNN
+				case 0xE4: Z80_LABEL(E4) // CALL NV,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (!(z80_af.b.l&0x04)) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xEC: // CALL V,$NNNN
+				case 0xEC: Z80_LABEL(EC) // CALL V,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (z80_af.b.l&0x04) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xF4: // CALL NS,$NNNN
+				case 0xF4: Z80_LABEL(F4) // CALL NS,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (!(z80_af.b.l&0x80)) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xFC: // CALL S,$NNNN
+				case 0xFC: Z80_LABEL(FC) // CALL S,$NNNN
 					Z80_WZ_PC; ++z80_pc.w; if (z80_af.b.l&0x80) goto go_to_call;
 					Z80_QUIRK(0); break;
-				case 0xCD: // CALL $NNNN
+				case 0xCD: Z80_LABEL(CD) // CALL $NNNN
 					Z80_WZ_PC; ++z80_pc.w;
 					#ifdef Z80_TRAP_0XCD
 					Z80_TRAP_0XCD;
@@ -1157,31 +1178,31 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					Z80_MREQ_NEXT(1); Z80_CALL2;
 					Z80_TRDOS_ENTER(z80_pc); // used with TR-DOS (rocman_.scl)
 					Z80_QUIRK(0); break;
-				case 0xC6: // ADD $NN
+				case 0xC6: Z80_LABEL(C6) // ADD $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_ADD1(o);
 					Z80_QUIRK(1); break;
-				case 0xCE: // ADC $NN
+				case 0xCE: Z80_LABEL(CE) // ADC $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_ADC1(o);
 					Z80_QUIRK(1); break;
-				case 0xD6: // SUB $NN
+				case 0xD6: Z80_LABEL(D6) // SUB $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_SUB1(o);
 					Z80_QUIRK(1); break;
-				case 0xDE: // SBC $NN
+				case 0xDE: Z80_LABEL(DE) // SBC $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_SBC1(o);
 					Z80_QUIRK(1); break;
-				case 0xE6: // AND $NN
+				case 0xE6: Z80_LABEL(E6) // AND $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_AND1(o);
 					Z80_QUIRK(1); break;
-				case 0xEE: // XOR $NN
+				case 0xEE: Z80_LABEL(EE) // XOR $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_XOR1(o);
 					Z80_QUIRK(1); break;
-				case 0xF6: // OR $NN
+				case 0xF6: Z80_LABEL(F6) // OR $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_OR1(o);
 					Z80_QUIRK(1); break;
-				case 0xFE: // CP $NN
+				case 0xFE: Z80_LABEL(FE) // CP $NN
 					o=Z80_PARMTR; ++z80_pc.w; Z80_CP1(o);
 					Z80_QUIRK(1); break;
-				case 0xDB: // IN A,($NN)
+				case 0xDB: Z80_LABEL(DB) // IN A,($NN)
 					z80_wz=(z80_af.b.h<<8)+Z80_PARMTR; ++z80_pc.w;
 					Z80_PRAE_RECV(z80_wz);
 					z80_af.b.h=Z80_RECV(z80_wz);
@@ -1189,7 +1210,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					Z80_STRIDE_IO(0x1DB);
 					++z80_wz;
 					Z80_QUIRK(0); break;
-				case 0xD3: // OUT ($NN),A
+				case 0xD3: Z80_LABEL(D3) // OUT ($NN),A
 					z80_wz=(z80_af.b.h<<8)+Z80_PARMTR; ++z80_pc.w;
 					Z80_PRAE_SEND(z80_wz);
 					Z80_SEND(z80_wz,z80_af.b.h);
@@ -1197,15 +1218,15 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					Z80_STRIDE_IO(0x1D3);
 					z80_wz=((z80_wz+1)&255)+(z80_af.b.h<<8);
 					Z80_QUIRK(0); break;
-				case 0xD9: // EXX
+				case 0xD9: Z80_LABEL(D9) // EXX
 					Z80_EXX2(z80_bc.w,z80_bc2.w);
 					Z80_EXX2(z80_de.w,z80_de2.w);
 					Z80_EXX2(z80_hl.w,z80_hl2.w);
 					Z80_QUIRK(0); break;
-				case 0xEB: // EX DE,HL
+				case 0xEB: Z80_LABEL(EB) // EX DE,HL
 					Z80_EXX2(z80_de.w,z80_hl.w);
 					Z80_QUIRK(0); break;
-				case 0xE3: // EX HL,(SP)
+				case 0xE3: Z80_LABEL(E3) // EX HL,(SP)
 					z80_wz=Z80_PEEK1EX(z80_sp.w);
 					++z80_sp.w;
 					z80_wz+=Z80_PEEK2EX(z80_sp.w)<<8; // Z80 TEST KIO needs 3T here and 1T later, not 4T or 4x 1T
@@ -1217,47 +1238,47 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					z80_hl.w=z80_wz;
 					Z80_MREQ_1X_NEXT(2);
 					Z80_QUIRK(2); break;
-				case 0xE9: // JP HL
+				case 0xE9: Z80_LABEL(E9) // JP HL
 					z80_pc.w=z80_hl.w;
 					Z80_TRDOS_ENTER(z80_pc); // used with TR-DOS (robin_.scl)
 					Z80_QUIRK(0); break;
-				case 0xF9: // LD SP,HL
+				case 0xF9: Z80_LABEL(F9) // LD SP,HL
 					z80_sp.w=z80_hl.w;
 					Z80_WAIT_IR1X(2);
 					Z80_QUIRK(2); break;
-				case 0xF3: // DI
+				case 0xF3: Z80_LABEL(F3) // DI
 					z80_iff.w=z80_int=0; // disable interruptions at once
 					Z80_QUIRK(0); break;
-				case 0xFB: // EI
+				case 0xFB: Z80_LABEL(FB) // EI
 					#ifdef Z80_DNTR_0XFB
 					Z80_DNTR_0XFB();
 					#endif
 					z80_iff.w=257; z80_int=0; // enable interruptions one instruction later: CPC demo "KKB FIRST" does DI...EI:EI:HALT...DI; Spectrum 48K test "EI48K"
 					Z80_QUIRK(0); break;
 					#ifdef Z80_TRAP_0XCF // useful on Amstrad CPC... if I ever jam the tape file I/O on the firmware level
-				case 0xCF: // RST 1
+				case 0xCF: Z80_LABEL(CF) // RST 1
 					Z80_TRAP_0XCF;
-				case 0xD7: // RST 2
+				case 0xD7: Z80_LABEL(D7) // RST 2
 					#else
 					#ifdef Z80_TRAP_0XD7 // useful on ZX Spectrum to catch 48K printer activity
-				case 0xD7: // RST 2
+				case 0xD7: Z80_LABEL(D7) // RST 2
 					Z80_TRAP_0XD7;
-				case 0xCF: // RST 1
+				case 0xCF: Z80_LABEL(CF) // RST 1
 					#else
-				case 0xCF: // RST 1
-				case 0xD7: // RST 2
+				case 0xCF: Z80_LABEL(CF) // RST 1
+				case 0xD7: Z80_LABEL(D7) // RST 2
 					#endif
 					#endif
-				case 0xC7: // RST 0
-				case 0xDF: // RST 3
-				case 0xE7: // RST 4
-				case 0xEF: // RST 5
-				case 0xF7: // RST 6
-				case 0xFF: // RST 7
+				case 0xC7: Z80_LABEL(C7) // RST 0
+				case 0xDF: Z80_LABEL(DF) // RST 3
+				case 0xE7: Z80_LABEL(E7) // RST 4
+				case 0xEF: Z80_LABEL(EF) // RST 5
+				case 0xF7: Z80_LABEL(F7) // RST 6
+				case 0xFF: Z80_LABEL(FF) // RST 7
 					z80_wz=o&0x38;
 					Z80_WAIT_IR1X(1); Z80_CALL2;
 					Z80_QUIRK(0); break;
-				case 0xCB: // PREFIX: CB SUBSET
+				case 0xCB: Z80_LABEL(CB) // PREFIX: CB SUBSET
 					o=Z80_OPCODE;
 					Z80_STRIDE(o+0x400);
 					++r7; ++z80_pc.w;
@@ -1320,8 +1341,8 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 					#undef CASE_Z80_CB_BIT
 					#undef CASE_Z80_CB_OP2
 					break;
-				case 0xDD: // PREFIX: XY SUBSET (IX)
-				case 0xFD: // PREFIX: XY SUBSET (IY)
+				case 0xDD: Z80_LABEL(DD) // PREFIX: XY SUBSET (IX)
+				case 0xFD: Z80_LABEL(FD) // PREFIX: XY SUBSET (IY)
 					{
 						// detect whether the following DD/FD opcode is defined
 						HLII *xy=(o&0x20)?&z80_iy:&z80_ix;
@@ -1765,7 +1786,7 @@ INLINE void z80_main(int _t_) // emulate the Z80 for `_t_` clock ticks
 						}
 					}
 					break;
-				case 0xED: // PREFIX: ED SUBSET
+				case 0xED: Z80_LABEL(ED) // PREFIX: ED SUBSET
 					o=Z80_OPCODE;
 					Z80_STRIDE(o+0x200);
 					++r7; ++z80_pc.w;
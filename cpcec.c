@@ -34,6 +34,9 @@ Contact information: <mailto:cngsoft@gmail.com> */
 // This file provides CPC-specific features for configuration, Gate
 // Array and CRTC, Z80 timings and support, snapshots, options...
 
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // POSIX functions (clock_gettime, fmemopen, realpath...) must be visible even with `-std=c99`
+#endif
 #include <stdio.h> // printf()...
 #include <stdlib.h> // strtol()...
 #include <string.h> // strcpy()...
@@ -103,6 +106,7 @@ unsigned char audio_surround=0; // ditto
 #include "cpcec-rt.h" // emulation framework!
 
 int litegun=0; // 0 = standard joystick, 1 = Trojan Light Phaser, 2 = Gunstick (MHT), 3 = Westphaser (Loriciel)
+BYTE litegun_count=0; // the Gunstick must miss one read out of 256, see autorun_kbd_bit()
 const unsigned char kbd_map_xlt[]=
 {
 	// control keys (range 0X81..0XBF)
@@ -172,7 +176,7 @@ VIDEO_UNIT video_xlat[32]; // static colours only (dynamic ASIC PLUS colours go
 // mainly defined by the simultaneous operation of the video output
 // (32 horizontal thin pixels) and the Z80 behavior (4 cycles)
 // (the clock is technically 16 MHz but we mean atomic steps here)
-int multi_t=0,multi_u=0; // overclocking shift+bitmask
+int multi_t=0,multi_u=0,multi_r=0; // overclocking shift+bitmask+remainder
 
 // HARDWARE DEFINITIONS ============================================= //
 
@@ -267,6 +271,7 @@ BYTE crtc_count_r3y; // VSYNC LINE COUNT / Winape `VSC`
 BYTE crtc_limit_r3x,crtc_limit_r3y; // limits of `r3x` and `r3y`
 int video_vsync_min,video_vsync_max,crtc_hold=0; // VHOLD modifiers
 
+int crtc_v_off_count; // lines left before the vertical display ends
 int crtc_line; // virtual PLUS variable, a shortcut of CRTC registers 4 and 9 used to test PLUS_PRI, PLUS_SSSL and others
 #define crtc_line_set() (crtc_line=(crtc_count_r9&7)+(crtc_count_r4&63)*8) // Plus scanline counter
 
@@ -1026,7 +1031,6 @@ void video_main(int t) // render video output for `t` clock ticks; t is always n
 					crtc_count_r5=(crtc_count_r5+1)&31;
 			}
 
-			static int crtc_v_off_count;
 			if (!crtc_count_r4)
 				if (!crtc_count_r9||(crtc_type==1&&(!crtc_table[5]||crtc_table[4]))) // the R5 test fixes "CAMEMBERT MEETING 4" without breaking the title of "FROM SCRATCH"
 				{
@@ -1203,7 +1207,7 @@ int autorun_kbd_bit(int k) // combined autorun+keyboard+joystick bits
 				if (session_maus_z)
 				{
 					k|=16; // BIT4 = trigger
-					static BYTE g; if (++g) // work around the buggy "TARGET PLUS", that always does 256 reads and must miss at least one
+					if (++litegun_count) // work around the buggy "TARGET PLUS", that always does 256 reads and must miss at least one
 						k|=(video_litegun&0x00C000)?2:0;
 				}
 				break;
@@ -1290,18 +1294,67 @@ void z80_irq_ack(void)
 }
 int z80_loss; // at least one device (the PLUS ASIC when DMA and PIO clash) can hog the bus!
 
+// the device queue: the FDC and the tape can only be seen thru their ports (and the tape thru the sound too), so they
+// keep the ticks they owe and only catch up when their next deadline comes (an FDC overrun, a tape edge) or before
+// anything looks at them; the CRTC and the Gate Array must follow the Z80 step by step, and so must their IRQs and DMA.
+int disc_owed=0,disc_until=0,tape_owed=0,tape_until=0; // ticks owed to each device, and ticks left until its deadline
+int disc_deadline(void) // ticks until the FDC overrun timer runs out; it can be early, but never late
+{
+	int i=disc_timer; if (i<1) return 1; if (i>(1<<30)/TICKS_PER_FRAME) i=(1<<30)/TICKS_PER_FRAME; // avoid overflows
+	return (i*TICKS_PER_FRAME-disc_timer_r+DISC_PER_FRAME-1)/DISC_PER_FRAME;
+}
+int tape_deadline(void) // ticks until the tape signal can change; it can be early, but never late
+{
+	int p; switch (tape_type)
+	{
+		case -1: return TICKS_PER_FRAME; // RECORD: nothing happens until the output changes
+		case 0: p=1; break; // WAV: every sample
+		case 1: p=tape_n; break; // CSW: the samples left in the current pulse
+		default: p=(tape_n+(1<<TAPE_MAIN_TZX_EXP)-1)>>TAPE_MAIN_TZX_EXP; // TZX, PZX...: the "bucket"
+	}
+	if (p<1) p=1; else if (p>(1<<30)/TICKS_PER_SECOND) p=(1<<30)/TICKS_PER_SECOND; // avoid overflows
+	return tape_playback>0?(p*TICKS_PER_SECOND-tape_t+tape_playback-1)/tape_playback:1;
+}
+// devices must catch up before anybody looks at them; `xxxx_until=0` after anything that can move their deadlines
+void disc_catchup(void) { if (disc_owed) disc_main(disc_owed),disc_owed=0; }
+void tape_catchup(void) { if (tape_owed) tape_main(tape_owed),tape_owed=0; }
+#ifdef HEADLESS
+int sync_calls=0,sync_avoid_disc=0,sync_avoid_tape=0,sync_avoid_audio=0; // accounting: calls to z80_sync() and device calls that weren't needed
+#define SYNC_AVOID(x) (++sync_avoid_##x)
+#else
+#define SYNC_AVOID(x) ((void)0)
+#endif
 void z80_sync(int t) // the Z80 asks the hardware/video/audio to catch up
 {
-	static int r=0; main_t+=t;
-	//if (!disc_disabled) // redundant, in most cases disc_main() does nothing
-		disc_main(t);
+	main_t+=t;
+	#ifdef HEADLESS
+	++sync_calls;
+	#endif
+	if (disc_phase&2) // the FDC has no timeouts while it's idle or waiting for commands
+	{
+		disc_owed+=t;
+		if ((disc_until-=t)<=0)
+			disc_main(disc_owed),disc_owed=0,disc_until=disc_deadline();
+		else SYNC_AVOID(disc);
+	}
+	else SYNC_AVOID(disc);
 	if (tape_enabled&&tape)
-		audio_dirty|=tape_loud,tape_main(t); // echo the tape signal thru sound!
-	t=(r+=t)>>multi_t; r&=multi_u; // calculate base value of `t` and keep remainder
+	{
+		audio_dirty|=tape_loud,tape_owed+=t; // echo the tape signal thru sound!
+		if ((tape_until-=t)<=0)
+			tape_main(tape_owed),tape_owed=0,tape_until=tape_deadline();
+		else SYNC_AVOID(tape);
+	}
+	else SYNC_AVOID(tape);
+	t=(multi_r+=t)>>multi_t; multi_r&=multi_u; // calculate base value of `t` and keep remainder
 	if (t>0)
 	{
 		if (audio_queue+=t,audio_dirty&&audio_required)
+		{
+			if (tape_loud) tape_catchup();
 			audio_main(audio_queue),audio_dirty=audio_queue=0;
+		}
+		else SYNC_AVOID(audio);
 		video_main(t);
 	}
 }
@@ -1393,6 +1446,7 @@ void z80_send(WORD p,BYTE b) // the Z80 sends a byte to a hardware port
 	if (!(p&0x0800)) // 0xF400-0xF700, PIO 8255
 	{
 		if (plus_dma_index>=3&&plus_dma_delay>1) { int z=plus_dma_delay-1; z80_loss+=z; z80_sync(z); } // bus clash! the PLUS DMA hogs the PIO 8255!
+		tape_catchup(); // the tape motor and the record signal may change
 		if (!(p&0x0200))
 		{
 			if (!(p&0x0100)) // 0xF400, PIO PORT A
@@ -1473,7 +1527,7 @@ void z80_send(WORD p,BYTE b) // the Z80 sends a byte to a hardware port
 			if (!disc_disabled)
 			{
 				if (p&0x100)
-					disc_data_send(b); // 0xFB7F: DATA I/O
+					disc_catchup(),disc_until=0,disc_data_send(b); // 0xFB7F: DATA I/O
 				else
 					disc_motor_set(b&1); // 0xFA7E: MOTOR
 			}
@@ -2017,9 +2071,10 @@ BYTE z80_recv(WORD p) // the Z80 receives a byte from a hardware port
 				if ((pio_control&2)||plus_enabled) // PLUS ASIC CRTC3 has a PIO bug!
 				{
 					//static int zzz=0; if (z80_pc.w<0XBB00) if (mmu_rom[0]==mem_ram) { if (zzz!=z80_pc.w) zzz=z80_pc.w,cprintf("$F5:%04X  ",z80_pc.w); else cputchar('.'); }
+					tape_catchup();
 					#if 1 // TAPE_FASTLOAD
 					if (tape)//&&!z80_iff.b.l) // at least one tape loader enables interrupts: "INVASION OF THE ZOMBIE MONSTERS"
-						if (tape_fastload&&tape_loud) z80_tape_trap(); // handle tape analysis upon status
+						if (tape_fastload&&tape_loud) z80_tape_trap(),tape_until=0; // handle tape analysis upon status
 					#endif
 					b&=(crtc_status&CRTC_STATUS_VSYNC? // gate_status&CRTC_STATUS_VSYNC ???
 						(crtc_type!=2||crtc_table[2]+crtc_limit_r3x!=crtc_table[0]+1): // CRTC2 VSYNC fails if HSYNC sets and H_OFF resets at once!
@@ -2043,7 +2098,7 @@ BYTE z80_recv(WORD p) // the Z80 receives a byte from a hardware port
 	{
 		if ((p&0x0380)==0x0300) // 0xFB7F: DATA I/O // 0xFB7E: STATUS
 			if (!disc_disabled)
-				b&=p&1?disc_data_recv():disc_data_info(); // 0xF87E+n
+				disc_catchup(),b&=p&1?(disc_until=0,disc_data_recv()):disc_data_info(); // 0xF87E+n
 		#ifdef PSG_PLAYCITY
 		else if (!playcity_disabled) // is this real? can the Playcity be read?
 		{
@@ -3064,7 +3119,7 @@ int any_load_catalog(int t,int r) // load track `t` and sectors from `r` to `r+3
 	disc_parmtr[5]=2;
 	for (t=0;r<s;++r)
 		if (disc_parmtr[4]=r,!disc_sector_find(l)) // load sectors if available
-			disc_sector_seek(l,disc_sector_last),t+=fread1(&disc_buffer[t],0x200,disc[0]);
+			disc_sector_seek(l,disc_sector_last),t+=disc_image_read(0,&disc_buffer[t],disc_cursor,0x200);
 	return t;
 }
 
@@ -3133,7 +3188,7 @@ int any_load(char *s,int q) // load a file regardless of format. `s` path, `q` a
 					}
 				}
 				else if (q)
-					disc_close(0),disc_close(1); // open tape? close discs!
+					{ if (disc_closeall()) session_message("Cannot save disc!",txt_error); } // open tape? close discs!
 				if (q) // autorun for tape and disc
 				{
 					dandanator_remove(),old_type_id=old_type_id>2?-1:old_type_id,all_reset(),bios_reload(); // force firmware reload if required
@@ -3728,7 +3783,8 @@ void session_user(int k) // handle the user's commands
 						session_message("Cannot open disc!",txt_error); // *!* shall we show a warning when disc_open() ignores "canwrite"?
 			break;
 		case 0x0700: // ^F7: EJECT DISC
-			disc_close(session_shift);
+			if (disc_close(session_shift))
+				session_message("Cannot save disc!",txt_error);
 			break;
 		case 0x0701:
 			disc_flip[session_shift]^=1;
@@ -3963,6 +4019,137 @@ void session_configwritemore(FILE *f) // update the configuration file `f` with
 		byte2hexa0(session_parmtr,kbd_k2j,KBD_JOY_UNIQUE),video_type,tape_rewind+tape_skipload*2+tape_fastload*4,debug_configwrite());
 }
 
+// multiple machines ------------------------------------------------ //
+
+const MACHINE_ITEM machine_items[]= // everything that tells a CPC from another one; firmware and ROMs are shared
+{
+	// Z80 and timings
+	MACHINE_STATE(z80_af),MACHINE_STATE(z80_bc),MACHINE_STATE(z80_de),MACHINE_STATE(z80_hl),
+	MACHINE_STATE(z80_af2),MACHINE_STATE(z80_bc2),MACHINE_STATE(z80_de2),MACHINE_STATE(z80_hl2),
+	MACHINE_STATE(z80_ix),MACHINE_STATE(z80_iy),MACHINE_STATE(z80_pc),MACHINE_STATE(z80_sp),
+	MACHINE_STATE(z80_iff),MACHINE_STATE(z80_ir),MACHINE_STATE(z80_wz),MACHINE_STATE(z80_imd),MACHINE_STATE(z80_r7),
+	MACHINE_STATE(z80_irq),MACHINE_STATE(z80_int),MACHINE_STATE(z80_loss),MACHINE_STATE(z80_xcf),MACHINE_STATE(z80_ack),
+	MACHINE_STATE(z80_tape_index),MACHINE_STATE(main_t),MACHINE_STATE(multi_t),MACHINE_STATE(multi_u),MACHINE_STATE(multi_r),
+	// memory and configuration
+	MACHINE_STATE(type_id),MACHINE_STATE(ram_depth),MACHINE_STATE(ram_extra),MACHINE_STATE(ram_dirty),
+	MACHINE_STATE(mmu_ram),MACHINE_STATE(mmu_rom),MACHINE_STATE(mmu_bit),MACHINE_STATE(mmu_xtr),
+	MACHINE_STATE(dandanator_trap),MACHINE_STATE(dandanator_temp),MACHINE_STATE(dandanator_cfg),
+	MACHINE_STATE(dandanator_canwrite),MACHINE_STATE(dandanator_dirty),
+	// Gate Array, CRTC and PLUS ASIC
+	MACHINE_STATE(gate_status),MACHINE_STATE(gate_index),MACHINE_STATE(gate_table),MACHINE_STATE(gate_mcr),
+	MACHINE_STATE(gate_ram),MACHINE_STATE(gate_rom),MACHINE_STATE(gate_screen),MACHINE_STATE(gate_mode0),MACHINE_STATE(gate_mode1),
+	MACHINE_STATE(gate_count_r3x),MACHINE_STATE(gate_count_r3y),MACHINE_STATE(irq_steps),MACHINE_STATE(irq_delay),MACHINE_STATE(irq_timer),
+	MACHINE_STATE(crtc_index),MACHINE_STATE(crtc_table),MACHINE_STATE(crtc_type),MACHINE_STATE(crtc_status),MACHINE_STATE(crtc_before),
+	MACHINE_STATE(crtc_count_r0),MACHINE_STATE(crtc_count_r4),MACHINE_STATE(crtc_count_r9),MACHINE_STATE(crtc_count_r5),
+	MACHINE_STATE(crtc_count_r3x),MACHINE_STATE(crtc_count_r3y),MACHINE_STATE(crtc_limit_r3x),MACHINE_STATE(crtc_limit_r3y),
+	MACHINE_STATE(crtc_hold),MACHINE_STATE(crtc_v_off_count),MACHINE_STATE(crtc_line),MACHINE_STATE(crtc_screen),
+	MACHINE_STATE(crtc_raster),MACHINE_STATE(crtc_backup),MACHINE_STATE(crtc_double),
+	MACHINE_STATE(video_threshold),MACHINE_STATE(video_vsync_min),MACHINE_STATE(video_vsync_max),
+	MACHINE_STATE(hsync_limit),MACHINE_STATE(hsync_count),MACHINE_STATE(hsync_match),
+	MACHINE_STATE(vsync_limit),MACHINE_STATE(vsync_count),MACHINE_STATE(vsync_match),
+	MACHINE_STATE(video_clut),MACHINE_STATE(video_clut_index),MACHINE_STATE(video_clut_value),MACHINE_STATE(video_hi_x_res),
+	MACHINE_STATE(plus_gate_counter),MACHINE_STATE(plus_gate_enabled),MACHINE_STATE(plus_gate_mcr),MACHINE_STATE(plus_8k_bug),
+	MACHINE_STATE(plus_dma_regs),MACHINE_STATE(plus_dma_index),MACHINE_STATE(plus_dma_delay),MACHINE_STATE(plus_dma_cache),
+	MACHINE_STATE(plus_bank),MACHINE_STATE(plus_sprite_border),MACHINE_STATE(plus_sprite_target),
+	MACHINE_STATE(plus_sprite_offset),MACHINE_STATE(plus_sprite_latest),MACHINE_STATE(plus_sprite_adjust),
+	// the beam and the current frame; the frame itself is shared, as each machine redraws it from scratch
+	MACHINE_STATE(video_target),MACHINE_STATE(video_pos_x),MACHINE_STATE(video_pos_y),MACHINE_STATE(video_pos_z),
+	MACHINE_STATE(frame_pos_y),MACHINE_STATE(video_interlaced),MACHINE_STATE(video_interlaces),MACHINE_STATE(video_litegun),
+	MACHINE_STATE(audio_target),MACHINE_STATE(audio_pos_z),MACHINE_STATE(audio_dirty),MACHINE_STATE(audio_queue),
+	// PIO, PSG, PLAYCITY and DAC
+	MACHINE_STATE(pio_port_a),MACHINE_STATE(pio_port_b),MACHINE_STATE(pio_port_c),MACHINE_STATE(pio_control),
+	MACHINE_STATE(psg_index),MACHINE_STATE(psg_table),MACHINE_STATE(psg_ultra_beep),MACHINE_STATE(psg_ultra_hits),
+	MACHINE_STATE(psg_tone_count),MACHINE_STATE(psg_tone_state),MACHINE_STATE(psg_tone_limit),MACHINE_STATE(psg_tone_power),
+	MACHINE_STATE(psg_tone_mixer),MACHINE_STATE(psg_noise_limit),MACHINE_STATE(psg_noise_count),
+	MACHINE_STATE(psg_hard_limit),MACHINE_STATE(psg_hard_count),MACHINE_STATE(psg_hard_style),MACHINE_STATE(psg_hard_level),
+	MACHINE_STATE(psg_main_r),MACHINE_STATE(psg_main_n),MACHINE_STATE(psg_main_b),MACHINE_STATE(psg_main_q),
+	MACHINE_STATE(psg_main_smash),MACHINE_STATE(psg_main_crash),
+	#if !AUDIO_ALWAYS_MONO
+	MACHINE_STATE(psg_main_o0),MACHINE_STATE(psg_main_o1),MACHINE_STATE(playcity_main_o0),MACHINE_STATE(playcity_main_o1),
+	#else
+	MACHINE_STATE(psg_main_o),MACHINE_STATE(playcity_main_o),
+	#endif
+	MACHINE_STATE(playcity_clock),MACHINE_STATE(playcity_hiclock),MACHINE_STATE(playcity_loclock),
+	MACHINE_STATE(playcity_disabled),MACHINE_STATE(playcity_dirty),MACHINE_STATE(playcity_ctc_state),MACHINE_STATE(playcity_ctc_flags),
+	MACHINE_STATE(playcity_ctc_count),MACHINE_STATE(playcity_ctc_limit),MACHINE_STATE(playcity_table),MACHINE_STATE(playcity_index),
+	MACHINE_STATE(playcity_hard_new),MACHINE_STATE(playcity_hard_style),MACHINE_STATE(playcity_hard_count),MACHINE_STATE(playcity_hard_level),
+	MACHINE_STATE(playcity_tone_count),MACHINE_STATE(playcity_tone_state),MACHINE_STATE(playcity_noise_count),MACHINE_STATE(playcity_hard_power),
+	MACHINE_STATE(playcity_smash),MACHINE_STATE(playcity_crash),MACHINE_STATE(playcity_main_n),MACHINE_STATE(playcity_main_p),MACHINE_STATE(playcity_main_q),
+	MACHINE_STATE(dac_disabled),MACHINE_STATE(dac_delay),MACHINE_STATE(dac_voice),
+	MACHINE_STATE(printer),MACHINE_STATE(printer_p),MACHINE_STATE(printer_z),MACHINE_STATE(printer_t),
+	// tape
+	MACHINE_STATE(tape),MACHINE_STATE(tape_filetell),MACHINE_STATE(tape_filesize),MACHINE_STATE(tape_filebase),
+	MACHINE_STATE(tape_playback),MACHINE_STATE(tape_step),MACHINE_STATE(tape_status),MACHINE_STATE(tape_output),
+	MACHINE_STATE(tape_record),MACHINE_STATE(tape_feedable),MACHINE_STATE(tape_seekcccc),
+	MACHINE_STATE(tape_t),MACHINE_STATE(tape_n),MACHINE_STATE(tape_heads),MACHINE_STATE(tape_tones),MACHINE_STATE(tape_datas),
+	MACHINE_STATE(tape_waves),MACHINE_STATE(tape_tails),MACHINE_STATE(tape_loops),MACHINE_STATE(tape_loop0),
+	MACHINE_STATE(tape_calls),MACHINE_STATE(tape_call0),MACHINE_STATE(tape_kansas),MACHINE_STATE(tape_kansas0n),
+	MACHINE_STATE(tape_kansas1n),MACHINE_STATE(tape_kansasin),MACHINE_STATE(tape_kansasi),MACHINE_STATE(tape_kansason),
+	MACHINE_STATE(tape_kansaso),MACHINE_STATE(tape_kansasrl),MACHINE_STATE(tape_buffer),MACHINE_STATE(tape_offset),
+	MACHINE_STATE(tape_length),MACHINE_STATE(tape_headcode),MACHINE_STATE(tape_head),MACHINE_STATE(tape_tail),
+	MACHINE_STATE(tape_time),MACHINE_STATE(tape_tonecodes),MACHINE_STATE(tape_toneitems),MACHINE_STATE(tape_datacodes),
+	MACHINE_STATE(tape_dataitems),MACHINE_STATE(tape_tzxpilot),MACHINE_STATE(tape_tzxpilots),MACHINE_STATE(tape_tzxsync1),
+	MACHINE_STATE(tape_tzxsync2),MACHINE_STATE(tape_tzxbit0),MACHINE_STATE(tape_tzxbit1),MACHINE_STATE(tape_tzxhold),
+	MACHINE_STATE(tape_type),MACHINE_STATE(tape_byte),MACHINE_STATE(tape_bits),MACHINE_STATE(tape_mask),
+	MACHINE_STATE(tape_code),MACHINE_STATE(tape_item),MACHINE_STATE(tape_codeitem),MACHINE_STATE(tape_signal),
+	MACHINE_STATE(tape_delay),MACHINE_STATE(tape_loud),MACHINE_STATE(tape_song),MACHINE_STATE(tape_skipping),
+	// disc
+	MACHINE_STATE(disc),MACHINE_STATE(disc_change),MACHINE_STATE(disc_motor),MACHINE_STATE(disc_track),
+	MACHINE_STATE(disc_flip),MACHINE_STATE(disc_canwrite),MACHINE_STATE(disc_index_table),MACHINE_STATE(disc_track_table),
+	MACHINE_STATE(disc_track_offset),MACHINE_STATE(disc_image),MACHINE_STATE(disc_image_dirty),MACHINE_STATE(disc_image_size),
+	MACHINE_STATE(disc_track_index),MACHINE_STATE(disc_sector_index),MACHINE_STATE(disc_parmtr),MACHINE_STATE(disc_result),MACHINE_STATE(disc_buffer),
+	MACHINE_STATE(disc_offset),MACHINE_STATE(disc_length),MACHINE_STATE(disc_lengthfull),MACHINE_STATE(disc_status),
+	MACHINE_STATE(disc_phase),MACHINE_STATE(disc_trueunit),MACHINE_STATE(disc_trueunithead),MACHINE_STATE(disc_delay),
+	MACHINE_STATE(disc_timer),MACHINE_STATE(disc_timer_r),MACHINE_STATE(disc_overrun),MACHINE_STATE(disc_sector_last),
+	MACHINE_STATE(disc_sector_weak),MACHINE_STATE(disc_sector_slow),MACHINE_STATE(disc_sector_timer),
+	MACHINE_STATE(disc_skew_length),MACHINE_STATE(disc_skew_filler),MACHINE_STATE(disc_disabled),
+	// keyboard and automatic typing
+	MACHINE_STATE(kbd_bit),MACHINE_STATE(kbd_bits),MACHINE_STATE(autorun_kbd),MACHINE_STATE(autorun_s),
+	MACHINE_STATE(autorun_m),MACHINE_STATE(autorun_t),MACHINE_STATE(snap_done),MACHINE_STATE(litegun_count),
+};
+int machine_bytes=0; // size of a context, RAM excluded
+BYTE *machine_live=NULL; // context of the live machine; NULL if there's only one machine
+void machine_select(BYTE *m) // store the live machine in its context and load context `m` in its place
+{
+	if (m==machine_live) return;
+	if (machine_live) // the RAM goes after the variables, limited to the current configuration
+		machine_store(machine_live,machine_items,length(machine_items)),
+		memcpy(machine_live+machine_bytes,mem_ram,ram_kbytes(ram_depth)<<10);
+	machine_fetch(m,machine_items,length(machine_items));
+	memcpy(mem_ram,m+machine_bytes,ram_kbytes(ram_depth)<<10);
+	machine_live=m;
+}
+BYTE *machine_create(void) // create a context that copies the live machine, but not its media; NULL ERROR
+{
+	if (!machine_bytes) machine_bytes=machine_size(machine_items,length(machine_items));
+	if (!machine_live&&!(machine_live=malloc(machine_bytes+sizeof(mem_ram)))) return NULL; // the live machine needs a context too!
+	BYTE *m=malloc(machine_bytes+sizeof(mem_ram)),*n=malloc(machine_bytes);
+	if (m&&n)
+	{
+		machine_store(m,machine_items,length(machine_items)); // keep the live machine safe...
+		tape=printer=NULL,MEMZERO(disc),MEMZERO(disc_image); tape_close(),disc_closeall(); // ...forget the media without closing them...
+		machine_store(n,machine_items,length(machine_items)); // ...and exchange both
+		machine_fetch(m,machine_items,length(machine_items)); memcpy(m,n,machine_bytes);
+		memcpy(m+machine_bytes,mem_ram,ram_kbytes(ram_depth)<<10);
+	}
+	else if (m) free(m),m=NULL;
+	if (n) free(n);
+	return m;
+}
+void machine_remove(BYTE *m) // close the media of the machine in context `m` and destroy it; `m` can't be live!
+{
+	BYTE *o=machine_live; machine_select(m);
+	tape_close(),disc_closeall(); if (printer) printer_close();
+	machine_live=NULL,machine_select(o); free(m);
+}
+#ifdef HEADLESS
+#define MACHINE_MAX 64 // batch runs can juggle several machines at once
+BYTE *machine_list[MACHINE_MAX]; int machine_count=1,machine_index=0;
+#define MACHINE_USAGE "  -uN\trun N machines in turns\n"
+#else
+#define MACHINE_USAGE ""
+#endif
+
 // START OF USER INTERFACE ========================================== //
 
 int main(int argc,char *argv[])
@@ -4017,6 +4204,18 @@ int main(int argc,char *argv[])
 						if (type_id<0||type_id>length(bios_system))
 							i=argc; // help!
 						break;
+					#ifdef HEADLESS
+					SESSION_CASES_HEADLESS
+						if (session_argheadless(argv[i],&j))
+							i=argc; // help!
+						break;
+					case 'u':
+						for (machine_count=0;argv[i][j]>='0'&&argv[i][j]<='9';)
+							machine_count=machine_count*10+argv[i][j++]-'0';
+						if (machine_count<1||machine_count>MACHINE_MAX)
+							i=argc; // help!
+						break;
+					#endif
 					case 'o':
 						onscreen_flag=1;
 						break;
@@ -4124,7 +4323,7 @@ int main(int argc,char *argv[])
 			"  -!\tforce software render\n"
 			"  -+\tdefault window size\n"
 			//"\t-$\talternative user interface\n"//
-			),1;
+			MACHINE_USAGE SESSION_USAGE_HEADLESS),1;
 	if (bios_reload())
 		return printferror(txt_error_bios),1;
 	amsdos_load("cpcados.rom"); //if (!*bdos_rom&&!disc_disabled) disc_disabled=1,mmu_update(); // can't enable the disc drive without its ROM!
@@ -4135,6 +4334,28 @@ int main(int argc,char *argv[])
 	session_kbdsetup(kbd_map_xlt,length(kbd_map_xlt)/2);
 	video_target=&video_frame[video_pos_y*VIDEO_LENGTH_X+video_pos_x]; audio_target=audio_frame;
 	video_main_xlat(),video_xlat_clut(); session_resize();
+	#ifdef HEADLESS
+	if ((j=session_spawn())<0) // all the instances are over
+		return session_byebye(),session_post();
+	if (j) // every instance reopens its files: the handles would be shared otherwise
+		for (i=1;i<argc;++i)
+			if (argv[i][0]!='-')
+				any_load(puff_makebasepath(argv[i]),1);
+	if (machine_count>1) // the new machines receive the same files as the first one
+	{
+		for (j=1;j<machine_count;++j)
+		{
+			if (!(machine_list[j]=machine_create()))
+				return printferror("Cannot create machines!"),1;
+			machine_list[0]=machine_live; // the first machine is the original one
+			machine_select(machine_list[j]);
+			for (i=1;i<argc;++i)
+				if (argv[i][0]!='-')
+					any_load(puff_makebasepath(argv[i]),1);
+			machine_select(machine_list[0]);
+		}
+	}
+	#endif
 	// it begins, "alea jacta est!"
 	for (audio_disabled=!session_audio;!session_listen();)
 	{
@@ -4142,6 +4363,7 @@ int main(int argc,char *argv[])
 			z80_main( // clump Z80 instructions together to gain speed...
 				UNLIKELY(video_pos_x<video_threshold)?0: // VRAM threshold ("Chapelle Sixteen") and IRQ events
 				((VIDEO_LENGTH_X+15-video_pos_x)>>4)<<multi_t); // ...without missing any IRQ and CRTC deadlines!
+		disc_catchup(),tape_catchup(),disc_until=tape_until=0; // the debugger and the user interface may look at the media
 		if (session_signal&SESSION_SIGNAL_FRAME) // end of frame?
 		{
 			if (audio_required)
@@ -4222,11 +4444,27 @@ int main(int argc,char *argv[])
 				session_fast&=~2,audio_disabled&=~2; // ditto, to restore normal activity
 			session_update();
 			//if (!audio_disabled) audio_main(1+(video_pos_x>>4)); // preload audio buffer
+			#ifdef HEADLESS
+			if (machine_count>1) // frame boundaries are the only safe places to switch machines
+				machine_select(machine_list[machine_index=(machine_index+1)%machine_count]);
+			#endif
 		}
 	}
 	// it's over, "acta est fabula"
+	#ifdef HEADLESS
+	if (session_benchmark&&video_pos_z) // see z80_sync()
+		fprintf(stderr,"#%d: %d syncs per frame; calls avoided per frame: %d FDC, %d tape, %d audio\n",session_instance,sync_calls/video_pos_z/machine_count,
+			sync_avoid_disc/video_pos_z/machine_count,sync_avoid_tape/video_pos_z/machine_count,sync_avoid_audio/video_pos_z/machine_count);
+	if (machine_count>1)
+	{
+		machine_select(machine_list[0]);
+		for (j=1;j<machine_count;++j)
+			machine_remove(machine_list[j]);
+		free(machine_live),machine_live=NULL;
+	}
+	#endif
 	z80_close(); if (ext_rom) free(ext_rom);
-	disc_closeall();
+	if (disc_closeall()) printferror("Cannot save disc!");
 	tape_close(); ym3_close(); if (printer) printer_close();
 	return session_byebye(),session_post();
 }
@@ -34,6 +34,9 @@ Contact information: <mailto:cngsoft@gmail.com> */
 // This file provides C64-specific features for configuration, VIC-II,
 // PAL and CIA logic, 6510 timings and support, snapshots, options...
 
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // POSIX functions (clock_gettime, fmemopen, realpath...) must be visible even with `-std=c99`
+#endif
 #include <stdio.h> // printf()...
 #include <stdlib.h> // strtol()...
 #include <string.h> // strcpy()...
@@ -96,6 +99,7 @@ unsigned char kbd_joy[]= // ATARI norm: up, down, left, right, fire1-fire4
 #define POWER_BOOST1 7 // power_boost default value (enabled)
 #define POWER_BOOST0 8
 #define AUDIO_ALWAYS_MONO (AUDIO_CHANNELS==1) // false, a multi-SID setup is stereo
+#define AUDIO_BENCHMAIN // `-bb` compares the SID setups, see below
 unsigned char audio_surround=0; // a single-SID setup is mono
 #include "cpcec-rt.h" // emulation framework!
 
@@ -943,10 +947,12 @@ BYTE c1541_mem[1<<16]; // 48K RAM + 16K ROM
 
 HLII m6502_pc; BYTE m6502_a,m6502_x,m6502_y,m6502_s,m6502_p; int m6502_irq,m6502_int; // the MOS 6502 registers
 int m6502_t=0; // used to keep both clocks in time!
+BYTE c1541_idle_ram[0X0800+8]; // the C1541 RAM, registers and ports at the start of the idle loop
+int c1541_idle_l=0,c1541_idle_n=-1,c1541_idle_z=0,c1541_idle_k=0; // length of the idle loop, microseconds since it began, microseconds that the VIAs are ahead of the 6502, napping flag
 
-void m6502_sync(int t) // runs the C1541 hardware for `t` microseconds
+void c1541_sync(int t) // runs the C1541 VIAs for `t` microseconds
 {
-	int i; m6502_t+=t;
+	int i;
 	if (VIA_TABLE_0[14]&64)
 	{
 		if ((i=mgetii(&VIA_TABLE_0[4])-t)<0)
@@ -970,6 +976,13 @@ void m6502_sync(int t) // runs the C1541 hardware for `t` microseconds
 	if (VIA_TABLE_1[15]==0XAA) // *!* DUMMY, TODO
 		disc_load_sector(0);
 }
+void m6502_sync(int t) // runs the C1541 hardware for `t` microseconds
+{
+	m6502_t+=t;
+	if (c1541_idle_z) // skip the time that the VIAs already ran while the 6502 was napping
+		{ if ((c1541_idle_z-=t)>=0) return; t=-c1541_idle_z; c1541_idle_z=0; }
+	c1541_sync(t);
+}
 
 BYTE c64_peeks_c1541(void) // the C64 requests a byte from the C1541
 {
@@ -1217,6 +1230,8 @@ void c1541_reset(void)
 	memset(VIA_TABLE_0,0,16); // VIA #1
 	memset(VIA_TABLE_1,0,16); // VIA #2
 	m6502_irq=disc_gcr_header=disc_gcr_offset=disc_gcr_length=0;
+	if (c1541_idle_k) m6502_t=0; // forget the missed laps
+	c1541_idle_l=c1541_idle_z=c1541_idle_k=0,c1541_idle_n=-1;
 }
 
 // CPU-HARDWARE-VIDEO-AUDIO INTERFACE =============================== //
@@ -1255,8 +1270,24 @@ void ym3_write(void)
 
 #define dac_frame() sid_frame() // dac_busy, dac_voice, etc. are handled by the SID
 int /*tape_loud=1,*/tape_song=0;
-//void audio_main(int t) { sid_main(t/*,((tape_status^tape_output)&tape_loud)<<12*/); }
-#define audio_main sid_main // (the SID chips are the only audio generators on the C64)
+void audio_main(int t) { sid_main(t/*,((tape_status^tape_output)&tape_loud)<<12*/); } // (the SID chips are the only audio generators on the C64)
+#ifdef HEADLESS
+void audio_benchmain(void) // measure the speed of one, two and three SID chips, with the voice-by-voice and the lockstep cores if available
+{
+	int c=sid_chips; char s[32];
+	for (sid_chips=1;sid_chips<=3;++sid_chips)
+	{
+		#ifdef SID_I4
+		for (sid_lockstep=0;sid_lockstep<2;++sid_lockstep)
+			sprintf(s," %dx SID %s",sid_chips,sid_lockstep?"lockstep":"scalar"),audio_benchmark(s);
+		sid_lockstep=1;
+		#else
+		sprintf(s," %dx SID",sid_chips),audio_benchmark(s);
+		#endif
+	}
+	sid_chips=c;
+}
+#endif
 
 void audio_sync(void) // force audio output on demand, to avoid generating old samples with new data!
 { if (/*audio_dirty&&*/audio_required&&audio_queue) audio_main(audio_queue),/*audio_dirty=*/audio_queue=0; }
@@ -1928,8 +1959,66 @@ void m6510_62500hz_playtape(void) // update TAPE-to-CIA logic
 }
 void m6510_62500hz_savetape(void) // update CIA-to-TAPE logic
 	{ tape_t+=M6510_62500HZ_T; char o=tape_output; if ((tape_output=mmu_cfg[1]&8)>o) tape_dump(); }
+// the C1541 DOS spends most of its time in the loop at $EBFF-$EC9D, waiting for
+// either the VIA timer IRQ or the ATN IRQ from the C64. We walk the loop one
+// opcode at a time; once a lap ends at $EBFF with the same RAM, registers and
+// ports it began with, every further lap is bound to be identical and equally
+// long, so the 6502 naps at $EBFF while the VIAs keep running. On waking up it
+// drops the whole laps it missed and runs the remainder, reaching the very same
+// opcode, state and cycle it would have reached without napping.
+#define C1541_IDLE_LO 0XEBFF // first byte of the idle loop
+#define C1541_IDLE_HI 0XEC9E // first byte after the idle loop
+#define C1541_IDLE_MAX 8192 // laps longer than this aren't worth waiting for
+#define c1541_idle() (!m6502_irq&&!m6502_int&&!(VIA_TABLE_1[0]&12))
+#define c1541_calm(t) (!(VIA_TABLE_0[14]&64&&mgetii(&VIA_TABLE_0[4])<(t))&&!(VIA_TABLE_1[14]&64&&mgetii(&VIA_TABLE_1[4])<(t))) // no VIA timer can fire within `t` microseconds
+void c1541_idle_save(BYTE *s) // store the state of the idle loop
+{
+	memcpy(s,c1541_mem,0X0800); s+=0X0800;
+	*s++=m6502_a; *s++=m6502_x; *s++=m6502_y; *s++=m6502_s; *s++=m6502_p;
+	*s++=VIA_TABLE_0[0]; *s++=VIA_TABLE_1[0]; *s=VIA_TABLE_1[2];
+}
+int c1541_idle_same(void) // did the last lap leave everything as it was?
+{
+	BYTE s[0X0800+8]; if (!c1541_idle_l&&c1541_idle_n<=0) return 0;
+	return c1541_idle_save(s),!memcmp(s,c1541_idle_ram,sizeof(s));
+}
 void m6510_62500hz_disc(void) // update the C1541 disc drive
-	{ int t=M6510_62500HZ_T-m6502_t; m6502_t-=M6510_62500HZ_T; if (t>0) m6502_main(t); }
+{
+	int t; m6502_t-=M6510_62500HZ_T;
+	if (c1541_idle_k) // is the 6502 napping?
+	{
+		if ((t=-m6502_t-c1541_idle_z)<0) t=0; // the VIAs must reach the present
+		if (c1541_idle()&&c1541_calm(t+8)) // 8 = longest opcode + 1, the 6502 may overshoot
+			{ c1541_sync(t); c1541_idle_z+=t; return; }
+		c1541_idle_k=0,c1541_idle_n=-1; // wake up! run the last lap till the end of the previous tick, when the IRQ was still unseen
+		if ((t=-M6510_62500HZ_T-m6502_t)>0)
+		{
+			int i=t/c1541_idle_l*c1541_idle_l; m6502_t+=i,c1541_idle_z-=i;
+			if (t-=i) { i=m6502_irq; m6502_irq=0; m6502_main(t); m6502_irq|=i; }
+		}
+	}
+	if ((t=-m6502_t)>0)
+	{
+		if (c1541_idle()&&c1541_calm(t+8)&&(c1541_idle_n>=0||(m6502_pc.w>=C1541_IDLE_LO&&m6502_pc.w<C1541_IDLE_HI)))
+			do
+			{
+				if (m6502_pc.w==C1541_IDLE_LO)
+				{
+					if (c1541_idle_same()) // nap till the next IRQ
+					{
+						if (!c1541_idle_l) c1541_idle_l=c1541_idle_n;
+						c1541_idle_k=1; if ((t=-m6502_t-c1541_idle_z)>0) c1541_sync(t),c1541_idle_z+=t; return;
+					}
+					c1541_idle_save(c1541_idle_ram); c1541_idle_l=c1541_idle_n=0;
+				}
+				t=m6502_t; m6502_main(0); // exactly one opcode
+				if (c1541_idle_n>=0&&(c1541_idle_n+=m6502_t-t)>C1541_IDLE_MAX) c1541_idle_n=-1;
+			}
+			while (m6502_t<0);
+		else
+			c1541_idle_n=-1,m6502_main(t);
+	}
+}
 #if 0
 void m6510_62500hz_cia0(void) // update the CIA #1 serial shift register (not sure if ever used for timing in any real-world title)
 {
@@ -3844,14 +3933,14 @@ void session_user(int k) // handle the user's commands
 		case 0x8519: // GET HIGH RAM...
 			if (ram_depth&&(s=puff_session_getfile(cart_path,"*.bin;*.reu","Load high RAM")))
 			{
-				FILE *f=puff_fopen(s,"rb"); if (k=0,f) k=fread1(mem_ram+65536,32768<<ram_depth,f),fclose(f);
+				FILE *f=puff_fopen(s,"rb"); if (k=0,f) k=fread1(mem_ram+65536,32768<<ram_depth,f),puff_fclose(f);
 				if (k<1) session_message("Cannot load high RAM!",txt_error); else ram_dirty=k-1;
 			}
 			break;
 		case 0x851A: // PUT HIGH RAM...
 			if (ram_depth&&(s=puff_session_newfile(cart_path,"*.bin;*.reu","Save high RAM")))
 			{
-				FILE *f=puff_fopen(s,"wb"); if (k=0,f) k=fwrite1(mem_ram+65536,32768<<ram_depth,f),fclose(f);
+				FILE *f=puff_fopen(s,"wb"); if (k=0,f) k=fwrite1(mem_ram+65536,32768<<ram_depth,f),puff_fclose(f);
 				if (k<1) session_message("Cannot save high RAM!",txt_error);
 			}
 			break;
@@ -4213,6 +4302,12 @@ int main(int argc,char *argv[])
 							i=argc; // help!
 						break;
 					*/
+					#ifdef HEADLESS
+					SESSION_CASES_HEADLESS
+						if (session_argheadless(argv[i],&j))
+							i=argc; // help!
+						break;
+					#endif
 					case 'o':
 						onscreen_flag=1;
 						break;
@@ -4320,7 +4415,7 @@ int main(int argc,char *argv[])
 			"  -!\tforce software render\n"
 			"  -+\tdefault window size\n"
 			//"\t-$\talternative user interface\n"//
-			),1;
+			SESSION_USAGE_HEADLESS),1;
 	if (bios_reload())
 		return printferror(txt_error_bios),1;
 	bdos_load("c1541.rom"); //if (!*c1541_rom&&!disc_disabled) disc_disabled=1; // can't enable the disc drive without its ROM!
@@ -4331,6 +4426,14 @@ int main(int argc,char *argv[])
 	session_kbdsetup(kbd_map_xlt,length(kbd_map_xlt)/2);
 	video_target=&video_frame[video_pos_y*VIDEO_LENGTH_X+video_pos_x]; audio_target=audio_frame;
 	video_main_xlat(),video_xlat_clut(); session_resize();
+	#ifdef HEADLESS
+	if ((j=session_spawn())<0) // all the instances are over
+		return session_byebye(),session_post();
+	if (j) // every instance reopens its files: the handles would be shared otherwise
+		for (i=1;i<argc;++i)
+			if (argv[i][0]!='-')
+				any_load(puff_makebasepath(argv[i]),1);
+	#endif
 	// it begins, "alea jacta est!"
 	for (audio_disabled=!session_audio;!session_listen();)
 	{
@@ -158,14 +158,29 @@ void huffpuff_gzip_next(void)
 
 unsigned int huffpuff_chars,huffpuff_crc32;
 
-// Karl Malbrain's incremental compact CCITT CRC-32
-const unsigned int huffpuff_crc32_k[16]={0,0X1DB71064,0X3B6E20C8,0X26D930AC,0X76DC4190,0X6B6B51F4,0X4DB26158,0X5005713C,
-	0XEDB88320,0XF00F9344,0XD6D6A3E8,0XCB61B38C,0X9B64C2B0,0X86D3D2D4,0XA00AE278,0XBDBDF21C}; // precalculated table
+// slicing-by-8 incremental CCITT CRC-32
+unsigned int huffpuff_crc32_k[8][256]; // tables, built by huffpuff_crc32_make() on first use
+void huffpuff_crc32_make(void)
+{
+	for (int i=0;i<256;++i)
+		{ unsigned int u=i; for (int j=0;j<8;++j) u=(u>>1)^(0XEDB88320&-(u&1)); huffpuff_crc32_k[0][i]=u; }
+	for (int i=0;i<256;++i)
+		for (int j=1;j<8;++j)
+			huffpuff_crc32_k[j][i]=(huffpuff_crc32_k[j-1][i]>>8)^huffpuff_crc32_k[0][huffpuff_crc32_k[j-1][i]&255];
+}
 void huffpuff_crc32_char(unsigned char k)
-	{ unsigned int u=huffpuff_crc32^k; u=(u>>4)^huffpuff_crc32_k[u&15],huffpuff_crc32=(u>>4)^huffpuff_crc32_k[u&15]; }
+	{ huffpuff_crc32=(huffpuff_crc32>>8)^huffpuff_crc32_k[0][(huffpuff_crc32^k)&255]; }
 void huffpuff_crc32_data(unsigned char *m,int n)
-	{ unsigned int u=huffpuff_crc32; for (huffpuff_chars+=n;n>0;--n) u^=*m++,u=(u>>4)^huffpuff_crc32_k[u&15],u=(u>>4)^huffpuff_crc32_k[u&15]; huffpuff_crc32=u; }
-#define huffpuff_gzip_crc32_init() (huffpuff_chars=0,huffpuff_crc32=0XFFFFFFFF) // the first step
+{
+	unsigned int u=huffpuff_crc32,h; for (huffpuff_chars+=n;n>=8;m+=8,n-=8) // eight bytes at a time
+	{
+		u^=m[0]+(m[1]<<8)+(m[2]<<16)+((unsigned int)m[3]<<24); h=m[4]+(m[5]<<8)+(m[6]<<16)+((unsigned int)m[7]<<24);
+		u=huffpuff_crc32_k[7][u&255]^huffpuff_crc32_k[6][(u>>8)&255]^huffpuff_crc32_k[5][(u>>16)&255]^huffpuff_crc32_k[4][u>>24]
+			^huffpuff_crc32_k[3][h&255]^huffpuff_crc32_k[2][(h>>8)&255]^huffpuff_crc32_k[1][(h>>16)&255]^huffpuff_crc32_k[0][h>>24];
+	}
+	for (;n>0;--n) u=(u>>8)^huffpuff_crc32_k[0][(u^*m++)&255]; huffpuff_crc32=u;
+}
+#define huffpuff_gzip_crc32_init() (huffpuff_crc32_k[0][1]||(huffpuff_crc32_make(),0),huffpuff_chars=0,huffpuff_crc32=0XFFFFFFFF) // the first step
 #define huffpuff_gzip_crc32_exit() (huffpuff_crc32^=0XFFFFFFFF) // the last step
 
 // ================================================================ //
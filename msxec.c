@@ -34,6 +34,9 @@ Contact information: <mailto:cngsoft@gmail.com> */
 // This file focuses on the MSX-specific features: configuration, MMU
 // logic, VDP video, Z80 timings and quirks, snapshots, options...
 
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // POSIX functions (clock_gettime, fmemopen, realpath...) must be visible even with `-std=c99`
+#endif
 #include <stdio.h> // printf()...
 #include <stdlib.h> // strtol()...
 #include <string.h> // strcpy()...
@@ -486,7 +489,16 @@ int sram_makepath(char *s) // build `sram_path` using string `s` as a base; NONZ
 }
 
 char cart_path[STRMAX]="";
-unsigned int cart_sha1_size=0,cart_sha1_list[2<<10][6],cart_bank[8]; // cart_bank[] used to be 4 BYTES but ASCII16X, NEO8 and NEO16 mappers need more words and bits!
+unsigned int cart_bank[8]; // cart_bank[] used to be 4 BYTES but ASCII16X, NEO8 and NEO16 mappers need more words and bits!
+unsigned int (*cart_sha1_list)[6]=NULL; int cart_sha1_size=0; // the SHA-1 list is sorted and as long as the file
+int cart_sha1_compare(const void *a,const void *b) // compare two SHA-1 values; <0 lower, 0 equal, >0 higher
+	{ const unsigned int *x=a,*y=b; int i=0; while (i<4&&x[i]==y[i]) ++i; return x[i]<y[i]?-1:x[i]>y[i]; }
+int cart_sha1_find(const unsigned int *h) // binary search of a SHA-1 value in the list; >=0 OK, <0 not found
+{
+	int a=0,z=cart_sha1_size; while (a<z) // find the first entry that isn't lower than `h`
+		{ int m=(a+z)>>1; if (cart_sha1_compare(cart_sha1_list[m],h)<0) a=m+1; else z=m; }
+	return a<cart_sha1_size&&!cart_sha1_compare(cart_sha1_list[a],h)?a:-1;
+}
 BYTE cart_id=0,cart_log=0; // cart_id is the mapper type, cart_log is the ceiling of the binary logarithm of the cartridge size
 BYTE cart_big=0; // overrides cart_id if nonzero: 1: 32K/48K/64K cartridges that "invade" $0000-$3FFF; 2: 16K/32K/48K cartridges that start at $4000
 BYTE cart_miscel=0; // the "Miscellaneous" type handles multiple "self-signing" subtypes, including ASCII16K and NEO 8K/16K that use more than 8 bits per page!
@@ -519,7 +531,7 @@ int cart_insert(char *s) // insert a cartridge; zero OK, nonzero error!
 	if (sram_makepath(s)) // load SRAM if possible, but don't tag it as dirty yet
 		if (f=puff_fopen(sram_path,"rb")) fread1(sram,sizeof(sram),f),puff_fclose(f);
 	// very modern cartridges include an ASCII string after the standard header;
-	/**/ if (!memcmp(&cart[16],"ROM_",4))
+	o=-1; /**/ if (!memcmp(&cart[16],"ROM_",4))
 	{
 		/**/ if (!memcmp(&cart[20],"ASC8",4)) cart_id=4,cprintf("ROM_: ASCII 8K\n");
 		else if (!memcmp(&cart[20],"AS16",4)) cart_id=5,cprintf("ROM_: ASCII 16K\n");
@@ -536,11 +548,9 @@ int cart_insert(char *s) // insert a cartridge; zero OK, nonzero error!
 		// cartridge type detection based on a pre-made SHA-1 list with types: "012356789abcdef012356789abcdef0123567 4" (roughly compatible with FMSX)
 		o=0; sha1_init(); while (o+64<=i) sha1_hash(&cart[o]),o+=64; sha1_exit(&cart[o],i&63);
 		cprintf("SHA-1: %08X%08X%08X%08X%08X",sha1_o[0],sha1_o[1],sha1_o[2],sha1_o[3],sha1_o[4]);
-		for (o=0;o<cart_sha1_size;++o)
-			if (!memcmp(sha1_o,cart_sha1_list[o],sizeof(sha1_o)))
-				{ cart_id=cart_sha1_list[o][5]; break; }
+		if ((o=cart_sha1_find(sha1_o))>=0) cart_id=cart_sha1_list[o][5];
 	}
-	cprintf(":%X (%d)\n",cart_id,o<cart_sha1_size?o:-1); // not sure what to do when the type is unknown...
+	cprintf(":%X (%d)\n",cart_id,o); // not sure what to do when the type is unknown...
 	/**/ if (cart_id==6) // KONAMI SRAM configuration seems to be always the same
 		sram_cart=16; // 8K: "GAME MASTER 2"
 	else if (cart_id==7) // KOEI SRAM configuration is tied to the cartridge size
@@ -583,7 +593,9 @@ void cart_setup(void) // load the cartridge list, if available
 	strcat(strcpy(session_substr,session_path),my_caption ".sha"); // sorta compatible with "carts.sha" from FMSX
 	cart_sha1_size=0; FILE *f=fopen(session_substr,"r"); if (f)
 	{
-		while (cart_sha1_size<length(cart_sha1_list)&&fgets(session_substr,STRMAX,f))
+		int n=0,q=0; while (fgets(session_substr,STRMAX,f)) ++n; // count the lines first: there can't be more entries
+		if (!(cart_sha1_list=malloc(n*sizeof(*cart_sha1_list)+1))) n=0; // memory full!
+		fseek(f,0,SEEK_SET); while (cart_sha1_size<n&&fgets(session_substr,STRMAX,f))
 		{
 			char *s=UTF8_BOM(session_substr); int k; unsigned int h[5]={0,0,0,0,0};
 			while ((k=eval_hex(*s))>=0) // build a 40-nibble value, even if the string isn't 40 chars!
@@ -600,9 +612,11 @@ void cart_setup(void) // load the cartridge list, if available
 				cart_sha1_list[cart_sha1_size][4]=h[4]&0XFFFFFFFF,
 				cart_sha1_list[cart_sha1_size][5]=k,
 				//cprintf("%08X%08X%08X%08X%08X:%X\n",h[0],h[1],h[2],h[3],h[4],k), // perhaps too much
+				q|=cart_sha1_size&&cart_sha1_compare(cart_sha1_list[cart_sha1_size-1],cart_sha1_list[cart_sha1_size])>0,
 				++cart_sha1_size;
 		}
-		cprintf("SHA-1 list: %d entries.\n",cart_sha1_size); // sufficient
+		if (q) qsort(cart_sha1_list,cart_sha1_size,sizeof(*cart_sha1_list),cart_sha1_compare); // the file should be sorted, but just in case
+		cprintf("SHA-1 list: %d entries%s.\n",cart_sha1_size,q?", sorted":""); // sufficient
 		fclose(f);
 	}
 	else cprintf("Cannot load SHA-1 list!"); // should we show an actual warning?
@@ -4216,6 +4230,12 @@ int main(int argc,char *argv[])
 						if (type_id<0||type_id>=length(bios_system))
 							i=argc; // help!
 						break;
+					#ifdef HEADLESS
+					SESSION_CASES_HEADLESS
+						if (session_argheadless(argv[i],&j))
+							i=argc; // help!
+						break;
+					#endif
 					case 'o':
 						onscreen_flag=1;
 						break;
@@ -4324,7 +4344,7 @@ int main(int argc,char *argv[])
 			"  -!\tforce software render\n"
 			"  -+\tdefault window size\n"
 			//"\t-$\talternative user interface\n"//
-			),1;
+			SESSION_USAGE_HEADLESS),1;
 	if (bios_reload())
 		return printferror(txt_error_bios),1;
 	// ... if (!*disc_rom&&!disc_disabled) disc_disabled=1,mmu_update(); // can't enable the disc drive without its ROM!
@@ -4335,6 +4355,14 @@ int main(int argc,char *argv[])
 	session_kbdsetup(kbd_map_xlt,length(kbd_map_xlt)/2);
 	video_target=&video_frame[video_pos_y*VIDEO_LENGTH_X+video_pos_x]; audio_target=audio_frame;
 	video_main_xlat(),video_wide_xlat(),video_xlat_clut(); session_resize();
+	#ifdef HEADLESS
+	if ((j=session_spawn())<0) // all the instances are over
+		return session_byebye(),session_post();
+	if (j) // every instance reopens its files: the handles would be shared otherwise
+		for (i=1;i<argc;++i)
+			if (argv[i][0]!='-')
+				any_load(puff_makebasepath(argv[i]),1);
+	#endif
 	// it begins, "alea jacta est!"
 	for (audio_disabled=!session_audio;!session_listen();)
 	{
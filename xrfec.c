@@ -39,18 +39,32 @@ Contact information: <mailto:cngsoft@gmail.com> */
 // The Windows version relies on the Video For Windows (VFW) interface;
 // other systems will get RGB24+PCM AVI files to feed FFMPEG with.
 
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // POSIX functions (clock_gettime, pthreads...) must be visible even with `-std=c99`
+#endif
 #include <stdio.h> // printf...
 #include <string.h> // strcmp...
 #include <stdlib.h> // malloc...
 
 #ifdef _WIN32 // "BYTE", "WORD", "DWORD" and (unused) "QWORD" are always exactly 8, 16, 32 and 64 bits long
 
-#ifndef RAWWW // disable VFW!
 #define WIN32_LEAN_AND_MEAN 1
-#include <windows.h>
+#include <windows.h> // CreateThread...
+#ifndef RAWWW // disable VFW!
 #include <vfw.h>
 #endif
 
+// background threads: a thread launcher, counting semaphores and a clock
+#define XRF_THREAD(f) DWORD WINAPI f(LPVOID xrf_thread_data) // 0 OK
+typedef HANDLE XRF_THREADID,XRF_SEMAPHORE;
+#define xrf_threadmake(t,f,p) (!(t=CreateThread(NULL,0,f,(p),0,NULL))) // 0 OK, !0 ERROR
+#define xrf_threadwait(t) (WaitForSingleObject(t,INFINITE),CloseHandle(t))
+#define xrf_semaphoremake(s,n) (!(s=CreateSemaphore(NULL,n,1<<16,NULL))) // 0 OK, !0 ERROR
+#define xrf_semaphorefree(s) CloseHandle(s)
+#define xrf_semaphorewait(s) WaitForSingleObject(s,INFINITE)
+#define xrf_semaphorepost(s) ReleaseSemaphore(s,1,NULL)
+#define xrf_ticks() GetTickCount()
+
 #else // "char", "short int" and "long long int" are 8, 16 and 64 bits, but "long int" can be 32 or 64 bits
 
 #include <stdint.h>
@@ -58,6 +72,19 @@ Contact information: <mailto:cngsoft@gmail.com> */
 #define WORD uint16_t // can this be safely reduced to "unsigned short"?
 #define DWORD uint32_t // this CANNOT be safely reduced to "unsigned int"!
 
+#include <pthread.h> // pthread_create()...
+#include <semaphore.h> // sem_init()...
+#include <time.h> // clock_gettime()...
+#define XRF_THREAD(f) void *f(void *xrf_thread_data) // NULL OK
+typedef pthread_t XRF_THREADID; typedef sem_t *XRF_SEMAPHORE;
+#define xrf_threadmake(t,f,p) pthread_create(&(t),NULL,f,(p)) // 0 OK, !0 ERROR
+#define xrf_threadwait(t) pthread_join(t,NULL)
+#define xrf_semaphoremake(s,n) ((s=malloc(sizeof(sem_t)))?sem_init(s,0,n)&&(free(s),1):1) // 0 OK, !0 ERROR
+#define xrf_semaphorefree(s) (sem_destroy(s),free(s))
+#define xrf_semaphorewait(s) sem_wait(s)
+#define xrf_semaphorepost(s) sem_post(s)
+int xrf_ticks(void) { struct timespec t; clock_gettime(CLOCK_MONOTONIC,&t); return t.tv_sec*1000+t.tv_nsec/1000000; }
+
 #endif
 
 #if __GNUC__ >= 4 // optional branch prediction hints
@@ -79,12 +106,13 @@ int video_x,video_y,audio_z,clock_z,flags_z,count_z; // dimensions and features
 
 // open and read a XRF file ----------------------------------------- //
 
-FILE *xrf_file=NULL; int xrf_length,xrf_cursor,xrf_count,xrf_dummy;
+FILE *xrf_file=NULL; int xrf_length,xrf_cursor,xrf_count,xrf_dummy,xrf_fetched;
 BYTE *xrf_argb32=NULL,*xrf_diff32=NULL,*xrf_chunk=NULL; // buffers
 int xrf_version; // experimental support for additional encodings!!
 int xrf_chunksize(void) // get the maximum chunk length in bytes
 {
-	return xrf_version?MAXVIDEOBYTES+MAXAUDIOBYTES+8*8: // all 100% literal streams (video R,G,B + audio l,L,r,R) plus headers and footers
+	return xrf_version>1?MAXVIDEOBYTES+MAXAUDIOBYTES+8*8+1+3*4*255: // XRF2 plus the amount of stripes and the length of every stream
+	xrf_version?MAXVIDEOBYTES+MAXAUDIOBYTES+8*8: // all 100% literal streams (video R,G,B + audio l,L,r,R) plus headers and footers
 	((MAXVIDEOBYTES+MAXAUDIOBYTES)*19/16+8*4); // pathological case xxxxxxxx.xxxxxxxx -> 1xxxxxxxx.1xxxxxxxx.0 plus 8 end markers
 }
 int xrf_decodebool(BYTE **s,BYTE *a,BYTE *b) // fetch zero or nonzero
@@ -128,6 +156,29 @@ int xrf_decode2(BYTE *t,int o,BYTE *s,int *l,int x) // slightly improved version
 int xrf_decode(BYTE *t,int o,BYTE *s,int *l,int x)
 	{ return xrf_version?xrf_decode2(t,o,s,l,x):xrf_decode1(t,o,s,l,x); }
 
+// XRF3 splits the B, G and R planes of every frame into `xrf_stripes` horizontal stripes that are encoded apart:
+// a chunk begins with the amount of stripes (0 = no changes), the lengths of the 3*N streams and the streams themselves.
+int xrf_stripes,xrf_stripen,xrf_striper; BYTE *xrf_stripe[3*255]; int xrf_stripez[3*255]; // the streams of the current chunk
+int xrf_splitstripes(BYTE *s,int l,int n) // locate the streams of the chunk `s` of `l` bytes in a frame of `n` pixels; <0 ERROR, >=0 bytes
+{
+	if (l<1) return -1; // truncated chunk!
+	if (!(xrf_stripes=*s)) return 1; // no stripes, no changes
+	int i=1+3*4*xrf_stripes; if (i>l) return -1; // truncated chunk!
+	xrf_stripen=n,xrf_striper=(n/video_x+xrf_stripes-1)/xrf_stripes*video_x; // pixels per stripe
+	for (int j=0;j<3*xrf_stripes;++j)
+	{
+		BYTE *t=&s[1+j*4]; xrf_stripez[j]=(t[0]<<24)+(t[1]<<16)+(t[2]<<8)+t[3];
+		if (xrf_stripez[j]<1||xrf_stripez[j]>l-i) return -1; // damaged chunk!
+		xrf_stripe[j]=&s[i],i+=xrf_stripez[j];
+	}
+	return i;
+}
+int xrf_decodestripe(int j) // decode the stream `j` of the current chunk into its plane and stripe; !0 ERROR
+{
+	int k=j%xrf_stripes*xrf_striper,n=xrf_stripen-k,m; if (n>xrf_striper) n=xrf_striper; else if (n<0) n=k=0;
+	return xrf_decode2(&xrf_diff32[k*4+j/xrf_stripes],n,xrf_stripe[j],&m,4)>xrf_stripez[j]||m!=n;
+}
+
 #define xrf_fgetc() fgetc(xrf_file)
 int xrf_fgetcc(void) { int m=xrf_fgetc()<<8; return m+xrf_fgetc(); } // Motorola order, (*(WORD*))(x) is no use
 int xrf_fgetcccc(void) { int m=xrf_fgetc()<<24; m+=xrf_fgetc()<<16; m+=xrf_fgetc()<<8; return m+xrf_fgetc(); }
@@ -153,40 +204,86 @@ int xrf_open(char *s) // opens a XRF file and sets the common parameters up; !0
 	flags_z=xrf_fgetc();
 	count_z=xrf_fgetcccc();
 	xrf_cursor=8+8+4; // the bytes we've read so far
-	xrf_count=xrf_dummy=0;
+	xrf_count=xrf_dummy=xrf_fetched=0;
 	// reject obsolete files: XRF-1 was limited to 8-bit RLE lengths, and XRF+1 didn't store the amount of frames!
 	xrf_version=id[3]-'1'; id[3]='1'; // experimental support for additional encodings!!
-	return video_x<=0||video_y<=0||clock_z<=0||audio_z<0||xrf_version<0||xrf_version>1||
+	return video_x<=0||video_y<=0||clock_z<=0||audio_z<0||xrf_version<0||xrf_version>2||
 		strcmp(id,"XRF1!\015\012\032")?fclose(xrf_file),1:0;
 }
-int xrf_read(void) // reads a XRF chunk and decodes the current video and audio frames; !0 ERROR/EOF
+// the decoding can be spread among `xrf_threads` threads: `xrf_parallel(f,n)` runs the jobs f(0)...f(n-1),
+// and thread `h` (the main thread is 0) performs the jobs `h`, `h+xrf_threads`, `h+2*xrf_threads`...
+#define XRF_THREADS 64
+int xrf_threads=1,xrf_jobs; int (*xrf_job)(int); volatile BYTE xrf_failed,xrf_quit;
+XRF_THREADID xrf_helper[XRF_THREADS]; XRF_SEMAPHORE xrf_helpgo[XRF_THREADS],xrf_helpend;
+void xrf_jobrun(int h) { for (int j=h;j<xrf_jobs;j+=xrf_threads) if (xrf_job(j)) xrf_failed=1; }
+int xrf_parallel(int (*f)(int),int n) // run the jobs f(0)...f(n-1) and wait for them; !0 ERROR
+{
+	xrf_job=f,xrf_jobs=n,xrf_failed=0;
+	for (int h=1;h<xrf_threads;++h) xrf_semaphorepost(xrf_helpgo[h]);
+	xrf_jobrun(0);
+	for (int h=1;h<xrf_threads;++h) xrf_semaphorewait(xrf_helpend);
+	return xrf_failed;
+}
+XRF_THREAD(xrf_helping) // run a share of the jobs whenever xrf_parallel() says so
 {
-	if (!xrf_file) return 1; // file not open!
-	if (xrf_count>=count_z) return 1; // EOF!
-	//if (!xrf_chunk||!xrf_chunk2) return 1; // buffer error!
-	int i,j,l=xrf_fgetcccc();
+	for (int h=(int)(size_t)xrf_thread_data;;)
 	{
-		if (l<1||l>xrf_chunksize()) return 1; // improper chunk size!
-		if (xrf_fread(xrf_chunk,l)!=l) return 1; // file is truncated!
+		xrf_semaphorewait(xrf_helpgo[h]);
+		if (xrf_quit) break;
+		xrf_jobrun(h);
+		xrf_semaphorepost(xrf_helpend);
 	}
-	xrf_cursor+=4+l;
-	BYTE *s=xrf_chunk; i=0; l=video_x*video_y>>((flags_z&12)==4);
-	s+=xrf_decode(&xrf_diff32[0],l,s,&j,4); i+=j; // B
-	s+=xrf_decode(&xrf_diff32[1],l,s,&j,4); i+=j; // G
-	s+=xrf_decode(&xrf_diff32[2],l,s,&j,4); i+=j; // R
-	// s+=xrf_decode(&xrf_diff32[3],l,s,&j,4); i+=j; // A
-	if (!i) ++xrf_dummy; // empty frame
-	else if (i!=l*3) return 1; // damaged video frame!
-	else // apply changes!
+	return 0;
+}
+void xrf_helpstop(void) // stop the helpers, if any
+{
+	xrf_quit=1; for (int h=1;h<xrf_threads;++h) xrf_semaphorepost(xrf_helpgo[h]);
+	for (int h=1;h<xrf_threads;++h) xrf_threadwait(xrf_helper[h]),xrf_semaphorefree(xrf_helpgo[h]);
+	if (xrf_threads>1) xrf_semaphorefree(xrf_helpend);
+	xrf_threads=1,xrf_quit=0;
+}
+void xrf_helpstart(int n) // launch up to `n-1` helpers; `xrf_threads` tells how many threads we really get
+{
+	int h=1; xrf_quit=0;
+	if (n>XRF_THREADS) n=XRF_THREADS;
+	if (n>1&&!xrf_semaphoremake(xrf_helpend,0))
 	{
-		int zi=0,zo=video_y*video_x; // doing the vertical flipping here saves some overhead later
-		if ((flags_z&12)==4) // vertical scaling? 00xx = normal, 01xx = vertical scaling, 1Zxx = interleaved
-			for (zo-=video_x*2;zo>=0;zo-=video_x*3) for (int z=video_x;z;++zi,++zo,--z)
-					((DWORD*)xrf_argb32)[zo+video_x]=((DWORD*)xrf_argb32)[zo]^=((DWORD*)xrf_diff32)[zi];
-		else // no vertical scaling, copy
-			for (zo-=video_x*1;zo>=0;zo-=video_x*2) for (int z=video_x;z;++zi,++zo,--z)
-					((DWORD*)xrf_argb32)[zo]^=((DWORD*)xrf_diff32)[zi];
+		for (;h<n;++h)
+			if (xrf_semaphoremake(xrf_helpgo[h],0)) break;
+			else if (xrf_threadmake(xrf_helper[h],xrf_helping,(void*)(size_t)h))
+				{ xrf_semaphorefree(xrf_helpgo[h]); break; }
+		if (h<2) xrf_semaphorefree(xrf_helpend);
 	}
+	xrf_threads=h;
+}
+
+int xrf_fetch(BYTE *t) // read the next chunk into `t`; <0 ERROR/EOF, >0 chunk length
+{
+	if (!xrf_file) return -1; // file not open!
+	if (xrf_fetched>=count_z) return -1; // EOF!
+	int l=xrf_fgetcccc();
+	if (l<1||l>xrf_chunksize()) return -1; // improper chunk size!
+	if (xrf_fread(t,l)!=l) return -1; // file is truncated!
+	return xrf_cursor+=4+l,++xrf_fetched,l;
+}
+int xrf_unpack(BYTE *s,int l) // decode the chunk `s` of `l` bytes: video into `xrf_diff32` and audio into `wave32`; <0 ERROR, 0 UNCHANGED, >0 CHANGED
+{
+	int i=0,j=l,k; l=video_x*video_y>>((flags_z&12)==4);
+	if (xrf_version>1) // XRF3?
+	{
+		if ((j=xrf_splitstripes(s,j,l))<0) return -1; // damaged chunk!
+		if (s+=j,xrf_parallel(xrf_decodestripe,3*xrf_stripes)) return -1; // damaged video frame!
+		if (xrf_stripes) i=l*3;
+	}
+	else
+	{
+		s+=xrf_decode(&xrf_diff32[0],l,s,&j,4); i+=j; // B
+		s+=xrf_decode(&xrf_diff32[1],l,s,&j,4); i+=j; // G
+		s+=xrf_decode(&xrf_diff32[2],l,s,&j,4); i+=j; // R
+		// s+=xrf_decode(&xrf_diff32[3],l,s,&j,4); i+=j; // A
+	}
+	if (!(k=i)) ++xrf_dummy; // empty frame
+	else if (i!=l*3) return -1; // damaged video frame!
 	if (audio_z)
 	{
 		switch(flags_z&3)
@@ -209,9 +306,35 @@ int xrf_read(void) // reads a XRF chunk and decodes the current video and audio
 				s+=xrf_decode(&wave32[3],audio_z,s,&j,4); i-=j; // R
 				break;
 		}
-		if (i) return 1; // damaged audio frame!
+		if (i) return -1; // damaged audio frame!
 	}
-	return ++xrf_count,0;
+	return k;
+}
+#define XRF_BANDS 32 // horizontal bands that xrf_applyband() handles apart
+int xrf_changed; BYTE *xrf_target=NULL; // apply `xrf_diff32`? convert into RGB24?
+void avi_convert(BYTE *t,int y); // see below
+int xrf_applyband(int k) // apply the changes of the band `k` to the bitmap and convert it into `xrf_target` if required; 0 OK
+{
+	int h=(flags_z&12)==4,r=video_y>>h; // 00xx = normal, 01xx = vertical scaling, 1Zxx = interleaved
+	for (int i=r*k/XRF_BANDS,z=r*(k+1)/XRF_BANDS;i<z;++i)
+	{
+		int y=video_y-((i+1)<<h); // doing the vertical flipping here saves some overhead later
+		DWORD *t=&((DWORD*)xrf_argb32)[y*video_x],*s=&((DWORD*)xrf_diff32)[i*video_x];
+		if (xrf_changed)
+		{
+			for (int x=0;x<video_x;++x) t[x]^=s[x];
+			if (h) memcpy(&t[video_x],t,video_x*4); // vertical scaling
+		}
+		if (xrf_target)
+			{ for (int j=0;j<=h;++j) avi_convert(&xrf_target[(y+j)*((video_x*3+3)&-4)],y+j); }
+	}
+	return 0;
+}
+int xrf_read(void) // reads a XRF chunk and decodes the current video and audio frames; !0 ERROR/EOF
+{
+	int l; if ((l=xrf_fetch(xrf_chunk))<0||(xrf_changed=xrf_unpack(xrf_chunk,l))<0)
+		return 1;
+	return xrf_target=NULL,xrf_parallel(xrf_applyband,XRF_BANDS),++xrf_count,0;
 }
 int xrf_close(void) // close and clean up; always 0 OK
 {
@@ -357,6 +480,33 @@ void avi_mputcccc(BYTE *x,int i) { *x=i; x[1]=i>>8; x[2]=i>>16; x[3]=i>>24; } //
 //int avi_fwrite(BYTE *t,int l) { int i=0,j; while (i<l&&(j=fwrite(&t[i],1,l-i,avi_file))) i+=j; return i; }
 #define avi_fwrite(t,l) fwrite(t,1,l,avi_file)
 
+void avi_convert(BYTE *t,int y) // turn the scanline `y` of the bitmap into the RGB24 scanline `t`
+{
+	// the bitmap is already upside down, but we still have to compress it,
+	// and the only available compression is the ARGB32->RGB24 clipping :-(
+	int l=(video_x*3+3)&-4; BYTE *s=&xrf_argb32[y*video_x*4];
+	for (int x=0;x<video_x;++x)
+		*t++=*s++, // copy B
+		*t++=*s++, // copy G
+		*t++=*s++, // copy R
+		++s; // skip A!
+	for (l-=video_x*3;l>0;--l) *t++=0; // padding
+}
+int avi_sound(BYTE *a) // write the audio frame `a`, if any; !0 ERROR
+{
+	if (audio_z)
+	{
+		int l;
+		avi_fputcccc(0x62773130); // "01wb"
+		avi_fputcccc(l=audio_z*flags_audio[flags_z&3]);
+		if (l&1) a[l++]=0; // RIFF even-padding
+		if (l!=avi_fwrite(a,l)) return 1;
+		avi_length+=l+8;
+	}
+	++avi_videos; avi_audios+=audio_z;
+	return 0;
+}
+
 int avi_create(char *s)
 {
 	#ifdef _WIN32
@@ -429,32 +579,26 @@ int avi_write(void)
 	#endif
 	#endif
 	if (!avi_file) return 1;
-	// the bitmap is already upside down, but we still have to compress it,
-	// and the only available compression is the ARGB32->RGB24 clipping :-(
 	int l=(video_x*3+3)&-4;
 	avi_fputcccc(0x62643030); // "00db"
 	avi_fputcccc(l*video_y);
 	for (int y=0;y<video_y;++y)
 	{
-		BYTE *t=avi_canvas,*s=&xrf_argb32[y*video_x*4];
-		for (int x=0;x<video_x;++x)
-			*t++=*s++, // copy B
-			*t++=*s++, // copy G
-			*t++=*s++, // copy R
-			++s; // skip A!
+		avi_convert(avi_canvas,y); // one scanline at a time
 		if (l!=avi_fwrite(avi_canvas,l)) return 1;
 	}
+	avi_length+=l*video_y+8;
+	return avi_sound(wave32);
+}
+int avi_store(BYTE *v,BYTE *a) // write the RGB24 bitmap `v` and the audio frame `a`; !0 ERROR
+{
+	if (!avi_file) return 1;
+	int l=((video_x*3+3)&-4)*video_y;
+	avi_fputcccc(0x62643030); // "00db"
+	avi_fputcccc(l);
+	if (l!=avi_fwrite(v,l)) return 1;
 	avi_length+=l+8;
-	if (audio_z)
-	{
-		avi_fputcccc(0x62773130); // "01wb"
-		avi_fputcccc(l=audio_z*flags_audio[flags_z&3]);
-		if (l&1) wave32[l++]=0; // RIFF even-padding
-		if (l!=avi_fwrite(wave32,l)) return 1;
-		avi_length+=l+8;
-	}
-	++avi_videos; avi_audios+=audio_z;
-	return 0;
+	return avi_sound(a);
 }
 int avi_finish(void)
 {
@@ -490,6 +634,75 @@ int avi_finish(void)
 	return avi_file=NULL,0;
 }
 
+// the conversion pipeline: a thread reads the chunks, the main thread (and its helpers)
+// decodes them and converts them into RGB24, and another thread writes the AVI file.
+
+#define XRF_QUEUE 4 // chunks and frames on the fly
+struct { BYTE *s; int l; } xrf_queue[XRF_QUEUE]; // chunks: `l` bytes, <0 = EOF/ERROR
+struct { BYTE *v,*a; int n; } avi_queue[XRF_QUEUE]; // frames: RGB24 bitmap and audio, 0 = EOF
+XRF_SEMAPHORE xrf_queuefree,xrf_queuefull,avi_queuefree,avi_queuefull; volatile BYTE avi_failed;
+XRF_THREAD(xrf_reading) // read chunks until EOF or ERROR
+{
+	for (int i=0;;i=(i+1)%XRF_QUEUE)
+	{
+		xrf_semaphorewait(xrf_queuefree);
+		if (xrf_quit) break; // the decoder gave up!
+		xrf_queue[i].l=xrf_fetch(xrf_queue[i].s);
+		xrf_semaphorepost(xrf_queuefull);
+		if (xrf_queue[i].l<0) break; // EOF or ERROR
+	}
+	return 0;
+}
+XRF_THREAD(avi_writing) // write frames until EOF
+{
+	for (int i=0;;i=(i+1)%XRF_QUEUE)
+	{
+		xrf_semaphorewait(avi_queuefull);
+		if (!avi_queue[i].n) break; // EOF!
+		if (!avi_failed&&avi_store(avi_queue[i].v,avi_queue[i].a)) avi_failed=1;
+		xrf_semaphorepost(avi_queuefree);
+	}
+	return 0;
+}
+int xrf_pipeline(void) // convert the whole file; <0 cannot start, 0 OK, >0 ERROR
+{
+	int i,j=xrf_chunksize(),k=((video_x*3+3)&-4)*video_y,e=0; XRF_THREADID r,w;
+	BYTE *m=malloc(XRF_QUEUE*(j+k+MAXAUDIOBYTES)); if (!m) return -1;
+	for (i=0;i<XRF_QUEUE;++i)
+		xrf_queue[i].s=&m[i*(j+k+MAXAUDIOBYTES)],avi_queue[i].v=&xrf_queue[i].s[j],avi_queue[i].a=&avi_queue[i].v[k];
+	if (xrf_semaphoremake(xrf_queuefree,XRF_QUEUE)) return free(m),-1;
+	if (xrf_semaphoremake(xrf_queuefull,0)) return xrf_semaphorefree(xrf_queuefree),free(m),-1;
+	if (xrf_semaphoremake(avi_queuefree,XRF_QUEUE)) return xrf_semaphorefree(xrf_queuefull),xrf_semaphorefree(xrf_queuefree),free(m),-1;
+	if (xrf_semaphoremake(avi_queuefull,0)) return xrf_semaphorefree(avi_queuefree),xrf_semaphorefree(xrf_queuefull),xrf_semaphorefree(xrf_queuefree),free(m),-1;
+	xrf_quit=avi_failed=0;
+	if (xrf_threadmake(r,xrf_reading,NULL)) e=-1;
+	else if (xrf_threadmake(w,avi_writing,NULL)) xrf_quit=1,xrf_semaphorepost(xrf_queuefree),xrf_threadwait(r),e=-1;
+	else
+	{
+		for (int o=i=0;;i=(i+1)%XRF_QUEUE,o=(o+1)%XRF_QUEUE)
+		{
+			xrf_semaphorewait(xrf_queuefull);
+			if (xrf_queue[i].l<0) break; // EOF or ERROR, see below
+			e=(xrf_changed=xrf_unpack(xrf_queue[i].s,xrf_queue[i].l))<0||avi_failed;
+			xrf_semaphorepost(xrf_queuefree);
+			if (e) break; // damaged frame or write error
+			xrf_semaphorewait(avi_queuefree);
+			xrf_target=avi_queue[o].v; xrf_parallel(xrf_applyband,XRF_BANDS);
+			if (audio_z) memcpy(avi_queue[o].a,wave32,audio_z*flags_audio[flags_z&3]);
+			avi_queue[o].n=1; xrf_semaphorepost(avi_queuefull);
+			if (!(++xrf_count&15)) fprintf(stderr,"%d/%d\015",xrf_count,count_z);
+		}
+		xrf_quit=1; xrf_semaphorepost(xrf_queuefree); xrf_threadwait(r); // stop the reader if it's still busy
+		for (i=0;i<XRF_QUEUE;++i) xrf_semaphorewait(avi_queuefree); // let the writer catch up...
+		for (i=0;i<XRF_QUEUE;++i) avi_queue[i].n=0; // ...and send the EOF
+		xrf_semaphorepost(avi_queuefull); xrf_threadwait(w);
+		e|=avi_failed; xrf_quit=0;
+	}
+	xrf_semaphorefree(avi_queuefull),xrf_semaphorefree(avi_queuefree);
+	xrf_semaphorefree(xrf_queuefull),xrf_semaphorefree(xrf_queuefree);
+	return free(m),e;
+}
+
 // ------------------------------------------------------------------ //
 
 int main(int argc,char *argv[])
@@ -499,6 +712,8 @@ int main(int argc,char *argv[])
 	{
 		if (!strcmp("-h",argv[i])||!strcmp("--help",argv[i]))
 			i=argc; // help!
+		else if (!strncmp("-j",argv[i],2)&&(argv[i][2]||i+1<argc))
+			{ if ((xrf_threads=atoi(argv[i][2]?&argv[i][2]:argv[++i]))<1||xrf_threads>XRF_THREADS) i=argc; } // help!
 		else if (!s)
 			s=argv[i];
 		else if (!t)
@@ -515,14 +730,16 @@ int main(int argc,char *argv[])
 	{
 		printf(MY_CAPTION " " MY_VERSION " " MY_LICENSE "\n"
 			"\n"
-			"usage: " my_caption " source.xrf [target.avi"
+			"usage: " my_caption " [-j N] source.xrf [target.avi"
 			#ifdef _WIN32
 			#ifndef RAWWW // disable VFW!
 			" [fourcc]"
 			#endif
 			#endif
 			"]\n"
-			"       " my_caption " source.xrf - | ffmpeg [filters] -i - [options] target\n"
+			"       " my_caption " [-j N] source.xrf - | ffmpeg [filters] -i - [options] target\n"
+			"\n"
+			"  -j N\tdecode with N threads (1..64; default: 1)\n"
 			"\n"
 			GPL_3_INFO
 			"\n");
@@ -551,9 +768,18 @@ int main(int argc,char *argv[])
 			return xrf_close(),avi_finish(),fprintf(stderr,"error: cannot setup decoder!\n"),1;
 		if (avi_create(t))
 			return xrf_close(),avi_finish(),fprintf(stderr,"error: cannot create target!\n"),1;
-		while (!xrf_read()&&!avi_write())
-			if (!(xrf_count&15)) fprintf(stderr,"%d/%d\015",xrf_count,count_z);//(stderr,"%05.02f\015",xrf_cursor*100.0/xrf_length)
-		if (avi_finish(),xrf_cursor!=xrf_length)
+		int ticks=xrf_ticks(); xrf_helpstart(xrf_threads);
+		#ifdef _WIN32
+		#ifndef RAWWW // disable VFW!
+		if (*vfw_fourcc) i=-1; else // VFW32.DLL isn't meant to be fed from another thread
+		#endif
+		#endif
+		i=xrf_pipeline(); // read, decode and write in parallel...
+		if (i<0) // ...or one step at a time if we must
+			while (!xrf_read()&&!avi_write())
+				if (!(xrf_count&15)) fprintf(stderr,"%d/%d\015",xrf_count,count_z);//(stderr,"%05.02f\015",xrf_cursor*100.0/xrf_length)
+		xrf_helpstop(); if ((ticks=xrf_ticks()-ticks)<1) ticks=1;
+		if (avi_finish(),i>0||xrf_cursor!=xrf_length)
 			return xrf_close(),fprintf(stderr,"error: something went wrong!\n"),1;
 		else
 		{
@@ -564,7 +790,8 @@ int main(int argc,char *argv[])
 					fseek(avi_file,0,SEEK_END),avi_length=ftell(avi_file),fclose(avi_file);
 			#endif
 			#endif
-			fprintf(stderr,"%d frames (%d unused), " filesize_style ".\n",xrf_count,xrf_dummy,filesize_upper(avi_length),filesize_lower(avi_length));
+			fprintf(stderr,"%d frames (%d unused), " filesize_style ", %d fps.\n",xrf_count,xrf_dummy,filesize_upper(avi_length),filesize_lower(avi_length),
+				(int)(xrf_count*1000LL/ticks));
 		}
 	}
 	else // examine
@@ -34,6 +34,9 @@ Contact information: <mailto:cngsoft@gmail.com> */
 // This file focuses on the Spectrum-specific features: configuration,
 // ULA logic+video, Z80 timings and support, snapshots, options...
 
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE // POSIX functions (clock_gettime, fmemopen, realpath...) must be visible even with `-std=c99`
+#endif
 #include <stdio.h> // printf()...
 #include <stdlib.h> // strtol()...
 #include <string.h> // strcpy()...
@@ -2375,14 +2378,17 @@ int any_load(char *s,int q) // load a file regardless of format. `s` path, `q` a
 						if (q)
 						{
 							type_id=!type_id?1:type_id!=3?type_id:2; // avoid 48K and reject PLUS3
-							disc_disabled=0,disc_closeall(),tape_close();
+							disc_disabled=0,tape_close(); if (disc_closeall()) session_message("Cannot save disc!",txt_error);
 						}
 					}
 					else if (q)
 						type_id=3,disc_disabled=0,tape_close(),trdos_closeall(); // open disc? force PLUS3, enable disc, close tapes and TR-DOS!
 				}
 				else if (q)
-					type_id=(type_id==3?2:type_id),disc_disabled|=2,disc_closeall(),trdos_closeall(); // open tape? force PLUS2 if PLUS3, close disc!
+				{
+					type_id=(type_id==3?2:type_id),disc_disabled|=2,trdos_closeall(); // open tape? force PLUS2 if PLUS3, close disc!
+					if (disc_closeall()) session_message("Cannot save disc!",txt_error);
+				}
 				if (q) // autorun for tape and disc
 				{
 					dandanator_remove(),all_reset(),bios_reload(); // force a firmware RELOAD (redundant?)
@@ -2978,7 +2984,9 @@ void session_user(int k) // handle the user's commands
 						session_message("Cannot open disc!",txt_error); // *!* shall we show a warning when disc_open() ignores "canwrite"?
 			break;
 		case 0x0700: // ^F7: EJECT DISC
-			type_id!=3?trdos_close(session_shift):disc_close(session_shift);
+			if (type_id!=3) trdos_close(session_shift);
+			else if (disc_close(session_shift))
+				session_message("Cannot save disc!",txt_error);
 			break;
 		case 0x0701:
 			disc_flip[session_shift]^=1;
@@ -3267,6 +3275,12 @@ int main(int argc,char *argv[])
 						if (type_id<0||type_id>3)
 							i=argc; // help!
 						break;
+					#ifdef HEADLESS
+					SESSION_CASES_HEADLESS
+						if (session_argheadless(argv[i],&j))
+							i=argc; // help!
+						break;
+					#endif
 					case 'o':
 						onscreen_flag=1;
 						break;
@@ -3373,7 +3387,7 @@ int main(int argc,char *argv[])
 			"  -!\tforce software render\n"
 			"  -+\tdefault window size\n"
 			//"\t-$\talternative user interface\n"//
-			),1;
+			SESSION_USAGE_HEADLESS),1;
 	if (bios_reload())
 		return printferror(txt_error_bios),1;
 	trdos_load("trdos.rom"); // not sure if we should check whether TR-DOS was loaded properly here: PLUS3 has its own disc system.
@@ -3384,6 +3398,14 @@ int main(int argc,char *argv[])
 	session_kbdsetup(kbd_map_xlt,length(kbd_map_xlt)/2);
 	video_target=&video_frame[video_pos_y*VIDEO_LENGTH_X+video_pos_x]; audio_target=audio_frame;
 	video_main_xlat(),video_xlat_clut(); session_resize();
+	#ifdef HEADLESS
+	if ((j=session_spawn())<0) // all the instances are over
+		return session_byebye(),session_post();
+	if (j) // every instance reopens its files: the handles would be shared otherwise
+		for (i=1;i<argc;++i)
+			if (argv[i][0]!='-')
+				any_load(puff_makebasepath(argv[i]),1);
+	#endif
 	// it begins, "alea jacta est!"
 	for (audio_disabled=!session_audio;!session_listen();)
 	{
@@ -3480,7 +3502,7 @@ int main(int argc,char *argv[])
 	}
 	// it's over, "acta est fabula"
 	z80_close();
-	trdos_closeall(); disc_closeall(); if (!*trdos_path) strcpy(trdos_path,disc_path); else if (!*disc_path) strcpy(disc_path,trdos_path); // avoid accidental losses
+	trdos_closeall(); if (disc_closeall()) printferror("Cannot save disc!"); if (!*trdos_path) strcpy(trdos_path,disc_path); else if (!*disc_path) strcpy(disc_path,trdos_path); // avoid accidental losses
 	tape_close(); ym3_close(); if (printer) printer_close();
 	return session_byebye(),session_post();
 }